@@ -5,6 +5,7 @@
 #include "Crypto/sha1.h"
 
 #include <unordered_map>
+#include <atomic>
 #include <algorithm>
 #include <cstring>
 #include <cerrno>
@@ -191,6 +192,21 @@ namespace fs
 		// Do notning
 	}
 
+	u64 file_base::read_at(u64 offset, void* buffer, u64 size)
+	{
+		// Generic fallback, not thread-safe
+		const u64 old_pos = seek(0, seek_cur);
+
+		if (seek(offset, seek_set) != offset)
+		{
+			return 0;
+		}
+
+		const u64 result = read(buffer, size);
+		seek(old_pos, seek_set);
+		return result;
+	}
+
 	dir_base::~dir_base()
 	{
 	}
@@ -842,6 +858,34 @@ fs::file::file(const std::string& path, bs_t<open_mode> mode)
 	{
 		const HANDLE m_handle;
 
+		// Overlapped duplicate of m_handle for read_at (opened on first use), positional reads on it leave the file pointer alone
+		std::atomic<HANDLE> m_read_handle{nullptr};
+
+		HANDLE get_read_handle()
+		{
+			HANDLE handle = m_read_handle.load();
+
+			if (handle)
+			{
+				return handle;
+			}
+
+			HANDLE expected = nullptr;
+			handle = ReOpenFile(m_handle, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, FILE_FLAG_OVERLAPPED);
+
+			if (!m_read_handle.compare_exchange_strong(expected, handle))
+			{
+				if (handle != INVALID_HANDLE_VALUE)
+				{
+					CloseHandle(handle);
+				}
+
+				return expected;
+			}
+
+			return handle;
+		}
+
 	public:
 		windows_file(HANDLE handle)
 			: m_handle(handle)
@@ -850,6 +894,13 @@ fs::file::file(const std::string& path, bs_t<open_mode> mode)
 
 		~windows_file() override
 		{
+			const HANDLE read_handle = m_read_handle.load();
+
+			if (read_handle && read_handle != INVALID_HANDLE_VALUE)
+			{
+				CloseHandle(read_handle);
+			}
+
 			CloseHandle(m_handle);
 		}
 
@@ -899,6 +950,40 @@ fs::file::file(const std::string& path, bs_t<open_mode> mode)
 			return nread;
 		}
 
+		u64 read_at(u64 offset, void* buffer, u64 count) override
+		{
+			const HANDLE handle = get_read_handle();
+
+			if (handle == INVALID_HANDLE_VALUE)
+			{
+				// Not readable through a second handle (e.g. opened for writing only)
+				return file_base::read_at(offset, buffer, count);
+			}
+
+			const int size = narrow<int>(count, "file::read_at" HERE);
+
+			// Every call has its own event, so concurrent reads do not wake each other
+			OVERLAPPED ovl{};
+			ovl.Offset = static_cast<DWORD>(offset);
+			ovl.OffsetHigh = static_cast<DWORD>(offset >> 32);
+			ovl.hEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+			verify("file::read_at" HERE), ovl.hEvent;
+
+			DWORD nread = 0;
+			const bool ok = (ReadFile(handle, buffer, size, nullptr, &ovl) || GetLastError() == ERROR_IO_PENDING) && GetOverlappedResult(handle, &ovl, &nread, TRUE);
+			const DWORD error = ok ? 0 : GetLastError();
+
+			CloseHandle(ovl.hEvent);
+
+			if (!ok)
+			{
+				verify("file::read_at" HERE), error == ERROR_HANDLE_EOF;
+				return 0;
+			}
+
+			return nread;
+		}
+
 		u64 write(const void* buffer, u64 count) override
 		{
 			// TODO (call WriteFile multiple times if count is too big)
@@ -1040,6 +1125,14 @@ fs::file::file(const std::string& path, bs_t<open_mode> mode)
 			return result;
 		}
 
+		u64 read_at(u64 offset, void* buffer, u64 count) override
+		{
+			const auto result = ::pread(m_fd, buffer, count, offset);
+			verify("file::read_at" HERE), result != -1;
+
+			return result;
+		}
+
 		u64 write(const void* buffer, u64 count) override
 		{
 			const auto result = ::write(m_fd, buffer, count);
@@ -1122,6 +1215,20 @@ fs::file::file(const void* ptr, std::size_t size)
 			return 0;
 		}
 
+		u64 read_at(u64 offset, void* buffer, u64 count) override
+		{
+			if (offset < m_size)
+			{
+				if (const u64 result = std::min<u64>(count, m_size - offset))
+				{
+					std::memcpy(buffer, m_ptr + offset, result);
+					return result;
+				}
+			}
+
+			return 0;
+		}
+
 		u64 write(const void* buffer, u64 count) override
 		{
 			return 0;
@@ -1168,6 +1275,87 @@ fs::native_handle fs::file::get_handle() const
 #endif
 }
 
+fs::file fs::make_view(const file& base, u64 offset, u64 size)
+{
+	class file_view final : public file_base
+	{
+		const file& m_base;
+		const u64 m_off;
+		const u64 m_size;
+		u64 m_pos{};
+
+	public:
+		file_view(const file& base, u64 offset, u64 size)
+			: m_base(base)
+			, m_off(offset)
+			, m_size(size)
+		{
+		}
+
+		bool trunc(u64 length) override
+		{
+			return false;
+		}
+
+		u64 read(void* buffer, u64 count) override
+		{
+			const u64 result = read_at(m_pos, buffer, count);
+			m_pos += result;
+			return result;
+		}
+
+		u64 read_at(u64 offset, void* buffer, u64 count) override
+		{
+			if (offset < m_size)
+			{
+				if (const u64 max = std::min<u64>(count, m_size - offset))
+				{
+					return m_base.read_at(m_off + offset, buffer, max);
+				}
+			}
+
+			return 0;
+		}
+
+		u64 write(const void* buffer, u64 count) override
+		{
+			return 0;
+		}
+
+		u64 seek(s64 offset, fs::seek_mode whence) override
+		{
+			const s64 new_pos =
+				whence == fs::seek_set ? offset :
+				whence == fs::seek_cur ? offset + m_pos :
+				whence == fs::seek_end ? offset + size() :
+				(fmt::raw_error("fs::make_view(): invalid whence"), 0);
+
+			if (new_pos < 0)
+			{
+				fs::g_tls_error = fs::error::inval;
+				return -1;
+			}
+
+			m_pos = new_pos;
+			return m_pos;
+		}
+
+		u64 size() override
+		{
+			return m_size;
+		}
+	};
+
+	file result;
+
+	if (base)
+	{
+		result.reset(std::make_unique<file_view>(base, offset, size));
+	}
+
+	return result;
+}
+
 void fs::dir::xnull() const
 {
 	fmt::throw_exception<std::logic_error>("fs::dir is null");
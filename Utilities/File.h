@@ -83,6 +83,9 @@ namespace fs
 		virtual u64 write(const void* buffer, u64 size) = 0;
 		virtual u64 seek(s64 offset, seek_mode whence) = 0;
 		virtual u64 size() = 0;
+
+		// Read at the specified offset, the current position is neither used nor changed (may be called concurrently if overridden)
+		virtual u64 read_at(u64 offset, void* buffer, u64 size);
 	};
 
 	// Directory entry (TODO)
@@ -250,6 +253,13 @@ namespace fs
 			return m_file->read(buffer, count);
 		}
 
+		// Read the data at the specified offset, current position is neither used nor changed
+		u64 read_at(u64 offset, void* buffer, u64 count) const
+		{
+			if (!m_file) xnull();
+			return m_file->read_at(offset, buffer, count);
+		}
+
 		// Write the data to the file and return the amount of data actually written
 		u64 write(const void* buffer, u64 count) const
 		{
@@ -553,6 +563,22 @@ namespace fs
 			return 0;
 		}
 
+		u64 read_at(u64 offset, void* buffer, u64 size) override
+		{
+			const u64 end = obj.size();
+
+			if (offset < end)
+			{
+				if (const u64 max = std::min<u64>(size, end - offset))
+				{
+					std::copy(obj.cbegin() + offset, obj.cbegin() + offset + max, static_cast<value_type*>(buffer));
+					return max;
+				}
+			}
+
+			return 0;
+		}
+
 		u64 write(const void* buffer, u64 size) override
 		{
 			const u64 old_size = obj.size();
@@ -613,6 +639,10 @@ namespace fs
 		return result;
 	}
 
+	// Read-only view of the range [offset, offset + size) of the base file, which must outlive the view.
+	// The view has its own position and only uses read_at() on the base file.
+	file make_view(const file& base, u64 offset, u64 size);
+
 	template <typename... Args>
 	bool write_file(const std::string& path, bs_t<fs::open_mode> mode, const Args&... args)
 	{
@@ -1,5 +1,11 @@
 #pragma once
 
+#include "types.h"
+
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
 template<typename T1, typename T2> struct range_t
 {
 	T1 _min; // first value
@@ -30,3 +36,145 @@ template<typename T1, typename T2, typename T> constexpr bool operator ==(const
 {
 	return !(value < range._min) && !(range._max < value);
 }
+
+// Index of values covering address ranges [_min, _max] (inclusive, like range_t above), bucketed by granules of (1 << Shift) bytes.
+// Lookups only visit the buckets spanned by the queried range. Each value has at most one range.
+template <typename T, u32 Shift = 16>
+class range_index
+{
+	struct entry
+	{
+		range_t<u32, u32> range;
+		T value;
+	};
+
+	std::unordered_map<u32, std::vector<entry>> m_buckets;
+	std::unordered_map<T, range_t<u32, u32>> m_ranges;
+
+	static constexpr u32 first_bucket(const range_t<u32, u32>& range)
+	{
+		return range._min >> Shift;
+	}
+
+	static constexpr u32 last_bucket(const range_t<u32, u32>& range)
+	{
+		return range._max >> Shift;
+	}
+
+public:
+	// Set or replace the range of the value (a range with _min > _max removes it)
+	void insert(const T& value, const range_t<u32, u32>& range)
+	{
+		erase(value);
+
+		if (range._min > range._max)
+		{
+			return;
+		}
+
+		m_ranges.emplace(value, range);
+
+		for (u32 i = first_bucket(range), end = last_bucket(range); i <= end; i++)
+		{
+			m_buckets[i].push_back({range, value});
+
+			if (i == end) break;
+		}
+	}
+
+	void erase(const T& value)
+	{
+		const auto found = m_ranges.find(value);
+
+		if (found == m_ranges.end())
+		{
+			return;
+		}
+
+		for (u32 i = first_bucket(found->second), end = last_bucket(found->second); i <= end; i++)
+		{
+			auto& bucket = m_buckets[i];
+
+			for (auto& e : bucket)
+			{
+				if (e.value == value)
+				{
+					e = bucket.back();
+					bucket.pop_back();
+					break;
+				}
+			}
+
+			if (bucket.empty())
+			{
+				m_buckets.erase(i);
+			}
+
+			if (i == end) break;
+		}
+
+		m_ranges.erase(found);
+	}
+
+	void clear()
+	{
+		m_buckets.clear();
+		m_ranges.clear();
+	}
+
+	std::size_t size() const
+	{
+		return m_ranges.size();
+	}
+
+	// Call func(value, range) once for each value whose range overlaps [_min, _max]
+	template <typename F>
+	void for_each_overlapping(const range_t<u32, u32>& range, F&& func) const
+	{
+		if (range._min > range._max)
+		{
+			return;
+		}
+
+		const u32 first = first_bucket(range);
+		const u32 last = last_bucket(range);
+
+		const auto test = [&](u32 bucket, const std::vector<entry>& entries)
+		{
+			for (const auto& e : entries)
+			{
+				// Values spanning several buckets are reported from the first bucket shared with the query
+				if (e.range._min <= range._max && range._min <= e.range._max && std::max(first_bucket(e.range), first) == bucket)
+				{
+					func(e.value, e.range);
+				}
+			}
+		};
+
+		if (u64{last} - first >= m_buckets.size())
+		{
+			// Sparse index: scan all buckets instead
+			for (const auto& bucket : m_buckets)
+			{
+				if (bucket.first >= first && bucket.first <= last)
+				{
+					test(bucket.first, bucket.second);
+				}
+			}
+
+			return;
+		}
+
+		for (u32 i = first; i <= last; i++)
+		{
+			const auto found = m_buckets.find(i);
+
+			if (found != m_buckets.end())
+			{
+				test(i, found->second);
+			}
+
+			if (i == last) break;
+		}
+	}
+};
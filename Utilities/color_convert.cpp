@@ -0,0 +1,441 @@
+#include "color_convert.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace color_convert
+{
+	// Chroma -> RGB coefficients for limited range input, scaled by 64
+	struct yuv_coefs
+	{
+		s16 v_r, u_g, v_g, u_b;
+	};
+
+	static constexpr yuv_coefs s_bt601_coefs{ 102, 25, 52, 129 };
+	static constexpr yuv_coefs s_bt709_coefs{ 115, 14, 34, 135 };
+
+	// Luma is expanded from 16..235 as (Y << 8) * (255 / 219 * 64 * 256) >> 16, minus the scaled black level
+	static constexpr u16 s_luma_scale = 19071;
+	static constexpr s16 s_luma_bias = 1192 - 32; // Includes rounding for the final >> 6
+
+	static inline u8 clamp_u8(s32 value)
+	{
+		return static_cast<u8>(std::min(std::max(value, 0), 255));
+	}
+
+	template <bool Argb, bool Nv12>
+	static void yuv420_to_rgb32_impl(const yuv420_image& src, u8* out, u32 out_pitch, u8 alpha, const yuv_coefs& c)
+	{
+		const __m128i luma_scale = _mm_set1_epi16(s_luma_scale);
+		const __m128i luma_bias = _mm_set1_epi16(s_luma_bias);
+		const __m128i v_r_coef = _mm_set1_epi16(c.v_r);
+		const __m128i u_g_coef = _mm_set1_epi16(c.u_g);
+		const __m128i v_g_coef = _mm_set1_epi16(c.v_g);
+		const __m128i u_b_coef = _mm_set1_epi16(c.u_b);
+		const __m128i uv_bias = _mm_set1_epi16(128);
+		const __m128i low_word = _mm_set1_epi32(0xffff);
+		const __m128i zero = _mm_setzero_si128();
+
+		const u32 width = src.width;
+
+		for (u32 row = 0; row < src.height; row++)
+		{
+			const u8* in_y = src.y + row * src.y_pitch;
+			const u8* in_u = src.u + (row / 2) * src.uv_pitch;
+			const u8* in_v = Nv12 ? nullptr : src.v + (row / 2) * src.uv_pitch;
+			const u8* in_a = src.a ? src.a + row * src.a_pitch : nullptr;
+			u8* dst = out + row * out_pitch;
+
+			__m128i alpha_vec = _mm_set1_epi8(alpha);
+
+			u32 x = 0;
+
+			for (; x + 8 <= width; x += 8)
+			{
+				const __m128i y = _mm_unpacklo_epi8(zero, _mm_loadl_epi64(reinterpret_cast<const __m128i*>(in_y + x)));
+
+				// Widen to 16 bit and duplicate each chroma sample for its two luma samples
+				__m128i u, v;
+
+				if (Nv12)
+				{
+					const __m128i uv = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(in_u + x)), zero);
+					u = _mm_and_si128(uv, low_word);
+					v = _mm_srli_epi32(uv, 16);
+					u = _mm_or_si128(u, _mm_slli_epi32(u, 16));
+					v = _mm_or_si128(v, _mm_slli_epi32(v, 16));
+				}
+				else
+				{
+					u32 u4, v4;
+					std::memcpy(&u4, in_u + x / 2, 4);
+					std::memcpy(&v4, in_v + x / 2, 4);
+
+					u = _mm_unpacklo_epi8(_mm_cvtsi32_si128(u4), zero);
+					v = _mm_unpacklo_epi8(_mm_cvtsi32_si128(v4), zero);
+					u = _mm_unpacklo_epi16(u, u);
+					v = _mm_unpacklo_epi16(v, v);
+				}
+
+				u = _mm_sub_epi16(u, uv_bias);
+				v = _mm_sub_epi16(v, uv_bias);
+
+				const __m128i luma = _mm_sub_epi16(_mm_mulhi_epu16(y, luma_scale), luma_bias);
+				const __m128i r = _mm_srai_epi16(_mm_adds_epi16(luma, _mm_mullo_epi16(v, v_r_coef)), 6);
+				const __m128i g = _mm_srai_epi16(_mm_subs_epi16(_mm_subs_epi16(luma, _mm_mullo_epi16(u, u_g_coef)), _mm_mullo_epi16(v, v_g_coef)), 6);
+				const __m128i b = _mm_srai_epi16(_mm_adds_epi16(luma, _mm_mullo_epi16(u, u_b_coef)), 6);
+
+				const __m128i r8 = _mm_packus_epi16(r, r);
+				const __m128i g8 = _mm_packus_epi16(g, g);
+				const __m128i b8 = _mm_packus_epi16(b, b);
+
+				if (in_a)
+				{
+					alpha_vec = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(in_a + x));
+				}
+
+				const __m128i lo = Argb ? _mm_unpacklo_epi8(alpha_vec, r8) : _mm_unpacklo_epi8(r8, g8);
+				const __m128i hi = Argb ? _mm_unpacklo_epi8(g8, b8) : _mm_unpacklo_epi8(b8, alpha_vec);
+
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x * 4), _mm_unpacklo_epi16(lo, hi));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x * 4 + 16), _mm_unpackhi_epi16(lo, hi));
+			}
+
+			for (; x < width; x++)
+			{
+				const s32 y = static_cast<s32>((in_y[x] << 8) * s_luma_scale >> 16) - s_luma_bias;
+				const s32 u = (Nv12 ? in_u[x & ~1u] : in_u[x / 2]) - 128;
+				const s32 v = (Nv12 ? in_u[x | 1u] : in_v[x / 2]) - 128;
+
+				const u8 r = clamp_u8((y + v * c.v_r) >> 6);
+				const u8 g = clamp_u8((y - u * c.u_g - v * c.v_g) >> 6);
+				const u8 b = clamp_u8((y + u * c.u_b) >> 6);
+				const u8 a = in_a ? in_a[x] : alpha;
+
+				u8* px = dst + x * 4;
+
+				if (Argb)
+				{
+					px[0] = a, px[1] = r, px[2] = g, px[3] = b;
+				}
+				else
+				{
+					px[0] = r, px[1] = g, px[2] = b, px[3] = a;
+				}
+			}
+		}
+	}
+
+	void yuv420_to_rgb32(const yuv420_image& src, u8* dst, u32 dst_pitch, rgb32_layout layout, u8 alpha, yuv_matrix matrix)
+	{
+		const yuv_coefs& c = matrix == yuv_matrix::bt709 ? s_bt709_coefs : s_bt601_coefs;
+		const bool nv12 = src.v == nullptr;
+
+		if (layout == rgb32_layout::argb)
+		{
+			nv12 ? yuv420_to_rgb32_impl<true, true>(src, dst, dst_pitch, alpha, c) : yuv420_to_rgb32_impl<true, false>(src, dst, dst_pitch, alpha, c);
+		}
+		else
+		{
+			nv12 ? yuv420_to_rgb32_impl<false, true>(src, dst, dst_pitch, alpha, c) : yuv420_to_rgb32_impl<false, false>(src, dst, dst_pitch, alpha, c);
+		}
+	}
+
+	void yuv420_to_uyvy422(const yuv420_image& src, u8* out, u32 out_pitch)
+	{
+		const u32 width = src.width;
+
+		for (u32 row = 0; row < src.height; row++)
+		{
+			const u8* in_y = src.y + row * src.y_pitch;
+			const u8* in_u = src.u + (row / 2) * src.uv_pitch;
+			const u8* in_v = src.v + (row / 2) * src.uv_pitch;
+			u8* dst = out + row * out_pitch;
+
+			u32 x = 0;
+
+			for (; x + 16 <= width; x += 16)
+			{
+				const __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in_y + x));
+				const __m128i u = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(in_u + x / 2));
+				const __m128i v = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(in_v + x / 2));
+				const __m128i uv = _mm_unpacklo_epi8(u, v);
+
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x * 2), _mm_unpacklo_epi8(uv, y));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x * 2 + 16), _mm_unpackhi_epi8(uv, y));
+			}
+
+			for (; x + 2 <= width; x += 2)
+			{
+				dst[x * 2 + 0] = in_u[x / 2];
+				dst[x * 2 + 1] = in_y[x];
+				dst[x * 2 + 2] = in_v[x / 2];
+				dst[x * 2 + 3] = in_y[x + 1];
+			}
+
+			if (x < width)
+			{
+				dst[x * 2 + 0] = in_u[x / 2];
+				dst[x * 2 + 1] = in_y[x];
+			}
+		}
+	}
+
+	// Each output pixel is 3/4 of the nearest and 1/4 of the next source pixel in both directions (9:3:3:1 weights)
+	static void scale_rgb32_double(const u8* src, u32 src_width, u32 src_height, u32 src_pitch, u8* dst, u32 dst_pitch)
+	{
+		// Vertically blended row (3 * near + far) with one replicated pixel of padding on each side
+		std::vector<u16> blend((src_width + 2) * 4);
+		u16* const line = blend.data() + 4;
+
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i round = _mm_set1_epi16(8);
+
+		for (u32 row = 0; row < src_height * 2; row++)
+		{
+			const u32 near_row = row / 2;
+			const u32 far_row = row & 1 ? std::min(near_row + 1, src_height - 1) : (near_row ? near_row - 1 : 0);
+			const u8* near_line = src + near_row * src_pitch;
+			const u8* far_line = src + far_row * src_pitch;
+
+			u32 i = 0;
+
+			for (; i + 8 <= src_width * 4; i += 8)
+			{
+				const __m128i n = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(near_line + i)), zero);
+				const __m128i f = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(far_line + i)), zero);
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(line + i), _mm_add_epi16(_mm_add_epi16(n, n), _mm_add_epi16(n, f)));
+			}
+
+			for (; i < src_width * 4; i++)
+			{
+				line[i] = near_line[i] * 3 + far_line[i];
+			}
+
+			std::memcpy(line - 4, line, 4 * sizeof(u16));
+			std::memcpy(line + src_width * 4, line + (src_width - 1) * 4, 4 * sizeof(u16));
+
+			u8* out = dst + row * dst_pitch;
+
+			u32 x = 0;
+
+			for (; x + 2 <= src_width; x += 2)
+			{
+				const __m128i cur = _mm_loadu_si128(reinterpret_cast<const __m128i*>(line + x * 4));
+				const __m128i prev = _mm_loadu_si128(reinterpret_cast<const __m128i*>(line + x * 4 - 4));
+				const __m128i next = _mm_loadu_si128(reinterpret_cast<const __m128i*>(line + x * 4 + 4));
+				const __m128i cur3 = _mm_add_epi16(_mm_add_epi16(cur, cur), _mm_add_epi16(cur, round));
+
+				const __m128i even = _mm_srli_epi16(_mm_add_epi16(cur3, prev), 4);
+				const __m128i odd = _mm_srli_epi16(_mm_add_epi16(cur3, next), 4);
+
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(out + x * 8), _mm_unpacklo_epi32(_mm_packus_epi16(even, even), _mm_packus_epi16(odd, odd)));
+			}
+
+			for (; x < src_width; x++)
+			{
+				for (u32 ch = 0; ch < 4; ch++)
+				{
+					const u16* px = line + x * 4 + ch;
+					const u32 cur3 = px[0] * 3 + 8;
+					out[x * 8 + ch] = static_cast<u8>((cur3 + px[-4]) >> 4);
+					out[x * 8 + ch + 4] = static_cast<u8>((cur3 + px[4]) >> 4);
+				}
+			}
+		}
+	}
+
+	// Each output pixel is the rounded average of a 2x2 source block
+	static void scale_rgb32_half(const u8* src, u32 src_pitch, u8* dst, u32 dst_width, u32 dst_height, u32 dst_pitch)
+	{
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i round = _mm_set1_epi16(2);
+
+		for (u32 row = 0; row < dst_height; row++)
+		{
+			const u8* line0 = src + row * 2 * src_pitch;
+			const u8* line1 = line0 + src_pitch;
+			u8* out = dst + row * dst_pitch;
+
+			u32 x = 0;
+
+			for (; x + 2 <= dst_width; x += 2)
+			{
+				const __m128i r0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(line0 + x * 8));
+				const __m128i r1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(line1 + x * 8));
+
+				// Vertical sums of source pixels 0, 1 (lo) and 2, 3 (hi), then add horizontal neighbours
+				const __m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(r0, zero), _mm_unpacklo_epi8(r1, zero));
+				const __m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(r0, zero), _mm_unpackhi_epi8(r1, zero));
+				const __m128i sum = _mm_add_epi16(_mm_add_epi16(_mm_unpacklo_epi64(lo, hi), _mm_unpackhi_epi64(lo, hi)), round);
+				const __m128i avg = _mm_srli_epi16(sum, 2);
+
+				_mm_storel_epi64(reinterpret_cast<__m128i*>(out + x * 4), _mm_packus_epi16(avg, avg));
+			}
+
+			for (; x < dst_width; x++)
+			{
+				for (u32 ch = 0; ch < 4; ch++)
+				{
+					out[x * 4 + ch] = static_cast<u8>((line0[x * 8 + ch] + line0[x * 8 + ch + 4] + line1[x * 8 + ch] + line1[x * 8 + ch + 4] + 2) >> 2);
+				}
+			}
+		}
+	}
+
+	bool scale_rgb32_bilinear(const u8* src, u32 src_width, u32 src_height, u32 src_pitch, u8* dst, u32 dst_width, u32 dst_height, u32 dst_pitch)
+	{
+		if (!src_width || !src_height)
+		{
+			return false;
+		}
+
+		if (dst_width == src_width && dst_height == src_height)
+		{
+			for (u32 row = 0; row < dst_height; row++)
+			{
+				std::memcpy(dst + row * dst_pitch, src + row * src_pitch, dst_width * 4);
+			}
+
+			return true;
+		}
+
+		if (dst_width == src_width * 2 && dst_height == src_height * 2)
+		{
+			scale_rgb32_double(src, src_width, src_height, src_pitch, dst, dst_pitch);
+			return true;
+		}
+
+		if (src_width == dst_width * 2 && src_height == dst_height * 2)
+		{
+			scale_rgb32_half(src, src_pitch, dst, dst_width, dst_height, dst_pitch);
+			return true;
+		}
+
+		return false;
+	}
+
+	template <u32 Size>
+	static void copy_pixels_nearest(const u8* src, u8* dst, const u32* offsets, u32 count, u32 size)
+	{
+		for (u32 x = 0; x < count; x++)
+		{
+			std::memcpy(dst + x * (Size ? Size : size), src + offsets[x], Size ? Size : size);
+		}
+	}
+
+	void scale_nearest(const u8* src, u32 src_width, u32 src_height, u32 src_pitch, u8* dst, u32 dst_width, u32 dst_height, u32 dst_pitch, u32 bytes_per_pixel)
+	{
+		if (!dst_width || !dst_height)
+		{
+			return;
+		}
+
+		std::vector<u32> offsets(dst_width);
+
+		for (u32 x = 0; x < dst_width; x++)
+		{
+			offsets[x] = static_cast<u32>((u64{x} * 2 + 1) * src_width / (u64{dst_width} * 2)) * bytes_per_pixel;
+		}
+
+		for (u32 row = 0; row < dst_height; row++)
+		{
+			const u32 src_row = static_cast<u32>((u64{row} * 2 + 1) * src_height / (u64{dst_height} * 2));
+			const u8* line = src + src_row * src_pitch;
+			u8* out = dst + row * dst_pitch;
+
+			switch (bytes_per_pixel)
+			{
+			case 2: copy_pixels_nearest<2>(line, out, offsets.data(), dst_width, 2); break;
+			case 4: copy_pixels_nearest<4>(line, out, offsets.data(), dst_width, 4); break;
+			default: copy_pixels_nearest<0>(line, out, offsets.data(), dst_width, bytes_per_pixel); break;
+			}
+		}
+	}
+
+	void rgb565be_to_argb(const u8* src, u32 src_pitch, u8* dst, u32 dst_pitch, u32 width, u32 height)
+	{
+		const __m128i alpha = _mm_set1_epi8(-1);
+		const __m128i mask5 = _mm_set1_epi16(0x1f);
+		const __m128i mask6 = _mm_set1_epi16(0x3f);
+
+		for (u32 row = 0; row < height; row++)
+		{
+			const u8* in = src + row * src_pitch;
+			u8* out = dst + row * dst_pitch;
+
+			u32 x = 0;
+
+			for (; x + 8 <= width; x += 8)
+			{
+				__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + x * 2));
+				v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+
+				// Expand to 8 bits by replicating the top bits into the low bits
+				const __m128i r = _mm_srli_epi16(v, 11);
+				const __m128i g = _mm_and_si128(_mm_srli_epi16(v, 5), mask6);
+				const __m128i b = _mm_and_si128(v, mask5);
+				const __m128i r8 = _mm_or_si128(_mm_slli_epi16(r, 3), _mm_srli_epi16(r, 2));
+				const __m128i g8 = _mm_or_si128(_mm_slli_epi16(g, 2), _mm_srli_epi16(g, 4));
+				const __m128i b8 = _mm_or_si128(_mm_slli_epi16(b, 3), _mm_srli_epi16(b, 2));
+
+				const __m128i lo = _mm_unpacklo_epi8(alpha, _mm_packus_epi16(r8, r8));
+				const __m128i hi = _mm_unpacklo_epi8(_mm_packus_epi16(g8, g8), _mm_packus_epi16(b8, b8));
+
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(out + x * 4), _mm_unpacklo_epi16(lo, hi));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(out + x * 4 + 16), _mm_unpackhi_epi16(lo, hi));
+			}
+
+			for (; x < width; x++)
+			{
+				const u32 v = in[x * 2] << 8 | in[x * 2 + 1];
+				const u32 r = v >> 11, g = (v >> 5) & 0x3f, b = v & 0x1f;
+
+				out[x * 4 + 0] = 0xff;
+				out[x * 4 + 1] = static_cast<u8>(r << 3 | r >> 2);
+				out[x * 4 + 2] = static_cast<u8>(g << 2 | g >> 4);
+				out[x * 4 + 3] = static_cast<u8>(b << 3 | b >> 2);
+			}
+		}
+	}
+
+	void argb_to_rgb565be(const u8* src, u32 src_pitch, u8* dst, u32 dst_pitch, u32 width, u32 height)
+	{
+		const __m128i mask_r = _mm_set1_epi32(0x1f << 11);
+		const __m128i mask_g = _mm_set1_epi32(0x3f << 5);
+
+		// Pack four ARGB pixels (little endian words 0xBBGGRRAA) into sign extended big endian RGB565
+		const auto pack4 = [&](__m128i v)
+		{
+			const __m128i r = _mm_and_si128(v, mask_r);
+			const __m128i g = _mm_and_si128(_mm_srli_epi32(v, 18 - 5), mask_g);
+			const __m128i b = _mm_srli_epi32(v, 27);
+			const __m128i p = _mm_or_si128(_mm_or_si128(r, g), b);
+			const __m128i swapped = _mm_or_si128(_mm_slli_epi32(p, 24), _mm_slli_epi32(_mm_srli_epi32(p, 8), 16));
+			return _mm_srai_epi32(swapped, 16);
+		};
+
+		for (u32 row = 0; row < height; row++)
+		{
+			const u8* in = src + row * src_pitch;
+			u8* out = dst + row * dst_pitch;
+
+			u32 x = 0;
+
+			for (; x + 8 <= width; x += 8)
+			{
+				const __m128i v0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + x * 4));
+				const __m128i v1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + x * 4 + 16));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(out + x * 2), _mm_packs_epi32(pack4(v0), pack4(v1)));
+			}
+
+			for (; x < width; x++)
+			{
+				const u32 v = (in[x * 4 + 1] >> 3) << 11 | (in[x * 4 + 2] >> 2) << 5 | in[x * 4 + 3] >> 3;
+				out[x * 2 + 0] = static_cast<u8>(v >> 8);
+				out[x * 2 + 1] = static_cast<u8>(v);
+			}
+		}
+	}
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "types.h"
+
+// SSE2 pixel format conversion and scaling for the video and RSX paths that used to go through swscale.
+// Callers keep swscale as the fallback for anything not covered here.
+namespace color_convert
+{
+	enum class yuv_matrix : u8
+	{
+		bt601,
+		bt709,
+	};
+
+	enum class rgb32_layout : u8
+	{
+		argb,
+		rgba,
+	};
+
+	// 4:2:0 picture with limited range samples. For NV12 input v must be null and u points to the interleaved U/V plane.
+	// The alpha plane is optional and has the luma resolution.
+	struct yuv420_image
+	{
+		const u8* y = nullptr;
+		const u8* u = nullptr;
+		const u8* v = nullptr;
+		const u8* a = nullptr;
+		u32 y_pitch = 0;
+		u32 uv_pitch = 0;
+		u32 a_pitch = 0;
+		u32 width = 0;
+		u32 height = 0;
+	};
+
+	// YUV420P, YUVA420P or NV12 to interleaved 32-bit RGB. Without an alpha plane every pixel gets the constant alpha.
+	void yuv420_to_rgb32(const yuv420_image& src, u8* dst, u32 dst_pitch, rgb32_layout layout, u8 alpha, yuv_matrix matrix);
+
+	// YUV420P to UYVY422, chroma lines are repeated (point sampling)
+	void yuv420_to_uyvy422(const yuv420_image& src, u8* dst, u32 dst_pitch);
+
+	// Bilinear scaling of 32-bit pixels (any channel order) by exactly 2x or 0.5x in both directions, or a plain copy.
+	// Returns false for any other ratio.
+	bool scale_rgb32_bilinear(const u8* src, u32 src_width, u32 src_height, u32 src_pitch, u8* dst, u32 dst_width, u32 dst_height, u32 dst_pitch);
+
+	// Nearest neighbour scaling with any ratio, pixel centres are aligned
+	void scale_nearest(const u8* src, u32 src_width, u32 src_height, u32 src_pitch, u8* dst, u32 dst_width, u32 dst_height, u32 dst_pitch, u32 bytes_per_pixel);
+
+	// Same size conversions between big endian RGB565 and ARGB (A, R, G, B byte order); alpha is set to 255
+	void rgb565be_to_argb(const u8* src, u32 src_pitch, u8* dst, u32 dst_pitch, u32 width, u32 height);
+	void argb_to_rgb565be(const u8* src, u32 src_pitch, u8* dst, u32 dst_pitch, u32 width, u32 height);
+}
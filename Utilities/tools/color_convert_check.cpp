@@ -0,0 +1,297 @@
+// Compares the color_convert kernels with the swscale conversions they can replace and prints the largest error of each.
+// Standalone program, not part of the emulator build. For example, from the repository root:
+//   c++ -std=c++14 -O2 -msse2 -IUtilities Utilities/tools/color_convert_check.cpp Utilities/color_convert.cpp -lswscale -lavutil
+
+#include "color_convert.h"
+
+extern "C"
+{
+#include "libswscale/swscale.h"
+}
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace
+{
+	struct image
+	{
+		u32 width;
+		u32 height;
+		u32 pitch;
+		std::vector<u8> data;
+
+		image(u32 width, u32 height, u32 bytes_per_pixel)
+			: width(width)
+			, height(height)
+			, pitch(width * bytes_per_pixel)
+			, data(pitch * height)
+		{
+		}
+	};
+
+	struct error_stats
+	{
+		u32 max_error = 0;
+		u64 mismatches = 0;
+		u64 samples = 0;
+
+		void add(u32 a, u32 b)
+		{
+			const u32 error = a > b ? a - b : b - a;
+			max_error = std::max(max_error, error);
+			mismatches += error != 0;
+			samples++;
+		}
+
+		void merge(const error_stats& other)
+		{
+			max_error = std::max(max_error, other.max_error);
+			mismatches += other.mismatches;
+			samples += other.samples;
+		}
+	};
+
+	std::mt19937 s_rng(0x3089);
+
+	// Random noise in the top half, smooth gradients in the bottom half (filter weights are visible on both)
+	void fill(image& img)
+	{
+		for (u32 y = 0; y < img.height; y++)
+		{
+			u8* line = img.data.data() + y * img.pitch;
+
+			for (u32 i = 0; i < img.pitch; i++)
+			{
+				line[i] = y < img.height / 2 ? static_cast<u8>(s_rng()) : static_cast<u8>((i * 7 + y * 3) & 0xff);
+			}
+		}
+	}
+
+	void run_swscale(const image& src, AVPixelFormat src_format, image& dst, AVPixelFormat dst_format, int flags)
+	{
+		std::unique_ptr<SwsContext, void(*)(SwsContext*)> sws(sws_getContext(src.width, src.height, src_format,
+			dst.width, dst.height, dst_format, flags, NULL, NULL, NULL), sws_freeContext);
+
+		if (!sws)
+		{
+			std::fprintf(stderr, "sws_getContext() failed\n");
+			std::exit(1);
+		}
+
+		const u8* src_planes[] = { src.data.data() };
+		const int src_pitch[] = { static_cast<int>(src.pitch) };
+		u8* dst_planes[] = { dst.data.data() };
+		const int dst_pitch[] = { static_cast<int>(dst.pitch) };
+
+		sws_scale(sws.get(), src_planes, src_pitch, 0, src.height, dst_planes, dst_pitch);
+	}
+
+	// Per byte comparison of 8-bit channels
+	error_stats compare_bytes(const image& a, const image& b)
+	{
+		error_stats stats;
+
+		for (u32 y = 0; y < a.height; y++)
+		{
+			for (u32 i = 0; i < a.width * (a.pitch / a.width); i++)
+			{
+				stats.add(a.data[y * a.pitch + i], b.data[y * b.pitch + i]);
+			}
+		}
+
+		return stats;
+	}
+
+	// Per component comparison of big endian RGB565 pixels, in units of the 5 or 6 bit components
+	error_stats compare_rgb565be(const image& a, const image& b)
+	{
+		error_stats stats;
+
+		for (u32 y = 0; y < a.height; y++)
+		{
+			for (u32 x = 0; x < a.width; x++)
+			{
+				const u8* pa = a.data.data() + y * a.pitch + x * 2;
+				const u8* pb = b.data.data() + y * b.pitch + x * 2;
+				const u32 va = pa[0] << 8 | pa[1];
+				const u32 vb = pb[0] << 8 | pb[1];
+
+				stats.add(va >> 11, vb >> 11);
+				stats.add((va >> 5) & 0x3f, (vb >> 5) & 0x3f);
+				stats.add(va & 0x1f, vb & 0x1f);
+			}
+		}
+
+		return stats;
+	}
+
+	struct size_pair
+	{
+		u32 src_width, src_height, dst_width, dst_height;
+	};
+
+	const size_pair s_scale_sizes[] =
+	{
+		{ 640, 360, 1280, 720 },
+		{ 1280, 720, 640, 360 },
+		{ 37, 23, 74, 46 },
+		{ 74, 46, 37, 23 },
+		{ 320, 240, 500, 300 },
+		{ 720, 480, 1920, 1080 },
+	};
+
+	const size_pair s_copy_sizes[] =
+	{
+		{ 640, 360, 640, 360 },
+		{ 37, 23, 37, 23 },
+	};
+
+	void report(const char* name, const error_stats& stats)
+	{
+		std::printf("%-40s max error %3u, %llu of %llu samples differ\n", name, stats.max_error,
+			static_cast<unsigned long long>(stats.mismatches), static_cast<unsigned long long>(stats.samples));
+	}
+
+	void check_scale_nearest(u32 bpp, AVPixelFormat format, const char* name)
+	{
+		error_stats total;
+
+		for (const auto& size : s_scale_sizes)
+		{
+			image src(size.src_width, size.src_height, bpp), ref(size.dst_width, size.dst_height, bpp), out(size.dst_width, size.dst_height, bpp);
+			fill(src);
+
+			run_swscale(src, format, ref, format, SWS_POINT);
+			color_convert::scale_nearest(src.data.data(), src.width, src.height, src.pitch, out.data.data(), out.width, out.height, out.pitch, bpp);
+
+			total.merge(bpp == 4 ? compare_bytes(ref, out) : compare_rgb565be(ref, out));
+		}
+
+		report(name, total);
+	}
+
+	void check_scale_bilinear()
+	{
+		error_stats total;
+
+		for (const auto& size : s_scale_sizes)
+		{
+			image src(size.src_width, size.src_height, 4), ref(size.dst_width, size.dst_height, 4), out(size.dst_width, size.dst_height, 4);
+			fill(src);
+
+			if (!color_convert::scale_rgb32_bilinear(src.data.data(), src.width, src.height, src.pitch, out.data.data(), out.width, out.height, out.pitch))
+			{
+				continue;
+			}
+
+			run_swscale(src, AV_PIX_FMT_ARGB, ref, AV_PIX_FMT_ARGB, SWS_FAST_BILINEAR);
+			total.merge(compare_bytes(ref, out));
+		}
+
+		report("scale_rgb32_bilinear (SWS_FAST_BILINEAR)", total);
+	}
+
+	void check_rgb565be_to_argb()
+	{
+		error_stats total;
+
+		for (const auto& size : s_copy_sizes)
+		{
+			image src(size.src_width, size.src_height, 2), ref(size.dst_width, size.dst_height, 4), out(size.dst_width, size.dst_height, 4);
+			fill(src);
+
+			run_swscale(src, AV_PIX_FMT_RGB565BE, ref, AV_PIX_FMT_ARGB, SWS_POINT);
+			color_convert::rgb565be_to_argb(src.data.data(), src.pitch, out.data.data(), out.pitch, src.width, src.height);
+
+			total.merge(compare_bytes(ref, out));
+		}
+
+		report("rgb565be_to_argb", total);
+	}
+
+	void check_argb_to_rgb565be()
+	{
+		error_stats total;
+
+		for (const auto& size : s_copy_sizes)
+		{
+			image src(size.src_width, size.src_height, 4), ref(size.dst_width, size.dst_height, 2), out(size.dst_width, size.dst_height, 2);
+			fill(src);
+
+			run_swscale(src, AV_PIX_FMT_ARGB, ref, AV_PIX_FMT_RGB565BE, SWS_POINT);
+			color_convert::argb_to_rgb565be(src.data.data(), src.pitch, out.data.data(), out.pitch, src.width, src.height);
+
+			total.merge(compare_rgb565be(ref, out));
+		}
+
+		report("argb_to_rgb565be", total);
+	}
+
+	void check_yuv420(bool uyvy)
+	{
+		error_stats total;
+
+		for (const auto& size : s_copy_sizes)
+		{
+			const u32 width = size.src_width;
+			const u32 height = size.src_height;
+			const u32 chroma_width = (width + 1) / 2;
+			const u32 chroma_height = (height + 1) / 2;
+
+			image y(width, height, 1), u(chroma_width, chroma_height, 1), v(chroma_width, chroma_height, 1);
+			fill(y), fill(u), fill(v);
+
+			const u32 out_bpp = uyvy ? 2 : 4;
+			image ref(width, height, out_bpp), out(width, height, out_bpp);
+
+			std::unique_ptr<SwsContext, void(*)(SwsContext*)> sws(sws_getContext(width, height, AV_PIX_FMT_YUV420P,
+				width, height, uyvy ? AV_PIX_FMT_UYVY422 : AV_PIX_FMT_ARGB, SWS_POINT, NULL, NULL, NULL), sws_freeContext);
+
+			const u8* src_planes[] = { y.data.data(), u.data.data(), v.data.data() };
+			const int src_pitch[] = { static_cast<int>(y.pitch), static_cast<int>(u.pitch), static_cast<int>(v.pitch) };
+			u8* dst_planes[] = { ref.data.data() };
+			const int dst_pitch[] = { static_cast<int>(ref.pitch) };
+
+			sws_scale(sws.get(), src_planes, src_pitch, 0, height, dst_planes, dst_pitch);
+
+			color_convert::yuv420_image src;
+			src.y = y.data.data();
+			src.u = u.data.data();
+			src.v = v.data.data();
+			src.y_pitch = y.pitch;
+			src.uv_pitch = u.pitch;
+			src.width = width;
+			src.height = height;
+
+			if (uyvy)
+			{
+				color_convert::yuv420_to_uyvy422(src, out.data.data(), out.pitch);
+			}
+			else
+			{
+				color_convert::yuv420_to_rgb32(src, out.data.data(), out.pitch, color_convert::rgb32_layout::argb, 0xff, color_convert::yuv_matrix::bt601);
+			}
+
+			total.merge(compare_bytes(ref, out));
+		}
+
+		report(uyvy ? "yuv420_to_uyvy422" : "yuv420_to_rgb32 (BT.601)", total);
+	}
+}
+
+int main()
+{
+	check_scale_nearest(4, AV_PIX_FMT_ARGB, "scale_nearest ARGB (SWS_POINT)");
+	check_scale_nearest(2, AV_PIX_FMT_RGB565BE, "scale_nearest RGB565BE (SWS_POINT)");
+	check_scale_bilinear();
+	check_rgb565be_to_argb();
+	check_argb_to_rgb565be();
+	check_yuv420(false);
+	check_yuv420(true);
+	return 0;
+}
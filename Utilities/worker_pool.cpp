@@ -0,0 +1,163 @@
+#include "worker_pool.h"
+#include "Thread.h"
+#include "Log.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <thread>
+
+worker_pool::worker_pool(u32 thread_count)
+{
+	m_workers.reserve(thread_count);
+
+	for (u32 i = 0; i < thread_count; i++)
+	{
+		m_workers.emplace_back();
+
+		thread_ctrl::spawn(m_workers.back(), "Worker Pool " + std::to_string(i), [this] { run(); });
+	}
+}
+
+worker_pool::~worker_pool()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_exit = true;
+	}
+
+	m_cv.notify_all();
+
+	for (auto& thread : m_workers)
+	{
+		thread->join();
+	}
+}
+
+void worker_pool::run()
+{
+	while (true)
+	{
+		std::function<void()> job;
+
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_cv.wait(lock, [this] { return m_exit || !m_queue.empty(); });
+
+			if (m_queue.empty())
+			{
+				return;
+			}
+
+			job = std::move(m_queue.front());
+			m_queue.pop_front();
+		}
+
+		try
+		{
+			job();
+		}
+		catch (const std::exception& e)
+		{
+			LOG_ERROR(GENERAL, "Worker pool job failed: %s", e.what());
+		}
+		catch (...)
+		{
+			LOG_ERROR(GENERAL, "Worker pool job failed: unknown exception");
+		}
+	}
+}
+
+void worker_pool::push(std::function<void()> job)
+{
+	if (m_workers.empty())
+	{
+		return job();
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_queue.emplace_back(std::move(job));
+	}
+
+	m_cv.notify_one();
+}
+
+void worker_pool::parallel_for(u32 count, const std::function<void(u32)>& func)
+{
+	if (count <= 1 || m_workers.empty())
+	{
+		for (u32 i = 0; i < count; i++)
+		{
+			func(i);
+		}
+
+		return;
+	}
+
+	// Shared with the helper jobs, which may start after this function has returned
+	struct state_t
+	{
+		const std::function<void(u32)>* func;
+		u32 count;
+		std::atomic<u32> next{0};
+		std::atomic<u32> done{0};
+		std::exception_ptr error;
+		std::mutex mutex;
+		std::condition_variable cv;
+
+		void work()
+		{
+			for (u32 i = next++; i < count; i = next++)
+			{
+				try
+				{
+					(*func)(i);
+				}
+				catch (...)
+				{
+					std::lock_guard<std::mutex> lock(mutex);
+
+					if (!error)
+					{
+						error = std::current_exception();
+					}
+				}
+
+				if (++done == count)
+				{
+					std::lock_guard<std::mutex> lock(mutex);
+					cv.notify_all();
+				}
+			}
+		}
+	};
+
+	const auto state = std::make_shared<state_t>();
+	state->func = &func;
+	state->count = count;
+
+	const u32 helpers = std::min<u32>(count - 1, size());
+
+	for (u32 i = 0; i < helpers; i++)
+	{
+		push([state] { state->work(); });
+	}
+
+	state->work();
+
+	std::unique_lock<std::mutex> lock(state->mutex);
+	state->cv.wait(lock, [&] { return state->done == count; });
+
+	if (state->error)
+	{
+		std::rethrow_exception(state->error);
+	}
+}
+
+worker_pool& worker_pool::get()
+{
+	static worker_pool s_pool(std::max<u32>(std::thread::hardware_concurrency(), 2) - 1);
+	return s_pool;
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "types.h"
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+class thread_ctrl;
+
+// Fixed-size pool of named threads for short CPU-bound jobs (texture conversion, decoding, etc.)
+class worker_pool final
+{
+	std::vector<std::shared_ptr<thread_ctrl>> m_workers;
+
+	std::deque<std::function<void()>> m_queue;
+
+	std::mutex m_mutex;
+
+	std::condition_variable m_cv;
+
+	bool m_exit = false;
+
+	void run();
+
+public:
+	explicit worker_pool(u32 thread_count);
+
+	worker_pool(const worker_pool&) = delete;
+
+	~worker_pool();
+
+	// Number of worker threads (the calling thread is not counted)
+	u32 size() const
+	{
+		return ::size32(m_workers);
+	}
+
+	// Queue a detached job. Exceptions escaping the job are logged and discarded.
+	void push(std::function<void()> job);
+
+	// Run func(i) for i in [0, count) and wait for completion. The calling thread takes part in the work,
+	// so nested calls from within a job cannot deadlock. The first exception thrown by a job is rethrown.
+	void parallel_for(u32 count, const std::function<void(u32)>& func);
+
+	// Process-wide pool sized to the host CPU
+	static worker_pool& get();
+};
@@ -15,14 +15,185 @@ extern "C"
 
 #include "cellPamf.h"
 #include "cellAdec.h"
+#include "Utilities/worker_pool.h"
 
+#include <algorithm>
+#include <future>
 #include <mutex>
 #include <thread>
+#include <unordered_map>
+#include <vector>
 
 extern std::mutex g_mutex_avcodec_open2;
 
 logs::channel cellAdec("cellAdec");
 
+// Decoding shared by all audio decoders: opened codec contexts are pooled by stream parameters,
+// and packets are decoded on a small pool of host threads instead of the decoder's own thread
+class adec_decoder_service
+{
+	struct codec_params
+	{
+		AVCodecID codec_id;
+		int sample_rate;
+		int channels;
+		u64 channel_layout;
+		int block_align;
+		s64 bit_rate;
+		std::vector<u8> extradata;
+
+		bool operator ==(const codec_params& rhs) const
+		{
+			return codec_id == rhs.codec_id && sample_rate == rhs.sample_rate && channels == rhs.channels && channel_layout == rhs.channel_layout &&
+				block_align == rhs.block_align && bit_rate == rhs.bit_rate && extradata == rhs.extradata;
+		}
+	};
+
+	static constexpr u32 max_pooled_contexts = 16;
+
+	std::mutex m_mutex;
+
+	// Released contexts ready for reuse, most recent last
+	std::vector<std::pair<codec_params, AVCodecContext*>> m_free_contexts;
+
+	// Parameters of the contexts in use
+	std::unordered_map<AVCodecContext*, codec_params> m_used_contexts;
+
+	worker_pool m_workers;
+
+	static codec_params get_params(const AVCodecContext& src)
+	{
+		codec_params params;
+		params.codec_id = src.codec_id;
+		params.sample_rate = src.sample_rate;
+		params.channels = src.channels;
+		params.channel_layout = src.channel_layout;
+		params.block_align = src.block_align;
+		params.bit_rate = src.bit_rate;
+
+		if (src.extradata && src.extradata_size > 0)
+		{
+			params.extradata.assign(src.extradata, src.extradata + src.extradata_size);
+		}
+
+		return params;
+	}
+
+public:
+	adec_decoder_service()
+		: m_workers(std::max(1u, std::min(4u, std::thread::hardware_concurrency() / 2)))
+	{
+	}
+
+	~adec_decoder_service()
+	{
+		for (auto& ctx : m_free_contexts)
+		{
+			avcodec_free_context(&ctx.second);
+		}
+	}
+
+	// Get an opened context for the stream parameters of src (filled by the demuxer), reusing a released one if possible
+	AVCodecContext* acquire_context(AVCodec* codec, const AVCodecContext& src)
+	{
+		codec_params params = get_params(src);
+		params.codec_id = codec->id;
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+
+			for (auto it = m_free_contexts.rbegin(); it != m_free_contexts.rend(); ++it)
+			{
+				if (it->first == params)
+				{
+					AVCodecContext* const ctx = it->second;
+					m_free_contexts.erase(std::next(it).base());
+					m_used_contexts.emplace(ctx, std::move(params));
+					return ctx;
+				}
+			}
+		}
+
+		AVCodecContext* ctx = avcodec_alloc_context3(codec);
+
+		if (!ctx)
+		{
+			fmt::throw_exception("avcodec_alloc_context3() failed" HERE);
+		}
+
+		ctx->sample_rate = params.sample_rate;
+		ctx->channels = params.channels;
+		ctx->channel_layout = params.channel_layout;
+		ctx->block_align = params.block_align;
+		ctx->bit_rate = params.bit_rate;
+
+		if (!params.extradata.empty())
+		{
+			ctx->extradata = (u8*)av_mallocz(params.extradata.size() + AV_INPUT_BUFFER_PADDING_SIZE);
+			ctx->extradata_size = ::size32(params.extradata);
+			std::memcpy(ctx->extradata, params.extradata.data(), params.extradata.size());
+		}
+
+		AVDictionary* opts = nullptr;
+		av_dict_set(&opts, "refcounted_frames", "1", 0);
+
+		int err;
+		{
+			std::lock_guard<std::mutex> lock(g_mutex_avcodec_open2);
+			// not multithread-safe (???)
+			err = avcodec_open2(ctx, codec, &opts);
+		}
+
+		if (err || opts)
+		{
+			av_dict_free(&opts);
+			avcodec_free_context(&ctx);
+			fmt::throw_exception("avcodec_open2() failed (err=0x%x, opts=%d)" HERE, err, opts ? 1 : 0);
+		}
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_used_contexts.emplace(ctx, std::move(params));
+		return ctx;
+	}
+
+	// Return a context obtained from acquire_context(), its decoder state is reset
+	void release_context(AVCodecContext* ctx)
+	{
+		avcodec_flush_buffers(ctx);
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+
+			const auto found = m_used_contexts.find(ctx);
+			verify(HERE), found != m_used_contexts.end();
+
+			if (m_free_contexts.size() >= max_pooled_contexts)
+			{
+				// Drop the least recently released context
+				avcodec_free_context(&m_free_contexts.front().second);
+				m_free_contexts.erase(m_free_contexts.begin());
+			}
+
+			m_free_contexts.emplace_back(std::move(found->second), ctx);
+			m_used_contexts.erase(found);
+		}
+	}
+
+	// Decode a packet on the worker threads and wait for the result. Packets of a single stream stay in order
+	// since its decoder waits here, while independent streams decode in parallel.
+	int decode(AVCodecContext* ctx, AVFrame* frame, int* got_frame, const AVPacket* packet)
+	{
+		const auto task = std::make_shared<std::packaged_task<int()>>([=]()
+		{
+			return avcodec_decode_audio4(ctx, frame, got_frame, packet);
+		});
+
+		auto result = task->get_future();
+		m_workers.push([task]() { (*task)(); });
+		return result.get();
+	}
+};
+
 class AudioDecoder : public ppu_thread
 {
 public:
@@ -38,6 +209,8 @@ public:
 	AVFormatContext* fmt;
 	u8* io_buf;
 
+	const std::shared_ptr<adec_decoder_service> service = fxm::get_always<adec_decoder_service>();
+
 	struct AudioReader
 	{
 		u32 addr;
@@ -54,6 +227,23 @@ public:
 
 	squeue_t<AdecFrame> frames;
 
+	// Released AVFrame structures kept for reuse
+	std::mutex frame_pool_mutex;
+	std::vector<AVFrame*> frame_pool;
+	static constexpr u32 max_pooled_frames = 8;
+
+	struct frame_recycler
+	{
+		AudioDecoder* adec;
+
+		void operator()(AVFrame* frame) const
+		{
+			adec->recycle_frame(frame);
+		}
+	};
+
+	using frame_ptr = std::unique_ptr<AVFrame, frame_recycler>;
+
 	const s32 type;
 	const u32 memAddr;
 	const u32 memSize;
@@ -143,9 +333,13 @@ public:
 			av_frame_unref(af.data);
 			av_frame_free(&af.data);
 		}
+		for (AVFrame* frame : frame_pool)
+		{
+			av_frame_free(&frame);
+		}
 		if (ctx)
 		{
-			avcodec_close(ctx);
+			service->release_context(ctx);
 			avformat_close_input(&fmt);
 		}
 		if (fmt)
@@ -159,6 +353,41 @@ public:
 		}
 	}
 
+	// Get an empty frame, reusing a released one if possible
+	AVFrame* alloc_frame()
+	{
+		{
+			std::lock_guard<std::mutex> lock(frame_pool_mutex);
+
+			if (!frame_pool.empty())
+			{
+				AVFrame* frame = frame_pool.back();
+				frame_pool.pop_back();
+				return frame;
+			}
+		}
+
+		return av_frame_alloc();
+	}
+
+	// Release sample data and keep the frame structure for reuse
+	void recycle_frame(AVFrame* frame)
+	{
+		av_frame_unref(frame);
+
+		{
+			std::lock_guard<std::mutex> lock(frame_pool_mutex);
+
+			if (frame_pool.size() < max_pooled_frames)
+			{
+				frame_pool.push_back(frame);
+				return;
+			}
+		}
+
+		av_frame_free(&frame);
+	}
+
 	virtual void cpu_task() override
 	{
 		while (true)
@@ -275,19 +504,7 @@ public:
 					{
 						fmt::throw_exception("avformat_new_stream() failed" HERE);
 					}
-					ctx = fmt->streams[0]->codec; // TODO: check data
-
-					opts = nullptr;
-					av_dict_set(&opts, "refcounted_frames", "1", 0);
-					{
-						std::lock_guard<std::mutex> lock(g_mutex_avcodec_open2);
-						// not multithread-safe (???)
-						err = avcodec_open2(ctx, codec, &opts);
-					}
-					if (err || opts)
-					{
-						fmt::throw_exception("avcodec_open2() failed (err=0x%x, opts=%d)" HERE, err, opts ? 1 : 0);
-					}
+					ctx = service->acquire_context(codec, *fmt->streams[0]->codec); // TODO: check data
 					just_started = false;
 				}
 
@@ -312,21 +529,23 @@ public:
 
 					struct AdecFrameHolder : AdecFrame
 					{
-						AdecFrameHolder()
+						AudioDecoder& adec;
+
+						AdecFrameHolder(AudioDecoder& adec)
+							: adec(adec)
 						{
-							data = av_frame_alloc();
+							data = adec.alloc_frame();
 						}
 
 						~AdecFrameHolder()
 						{
 							if (data)
 							{
-								av_frame_unref(data);
-								av_frame_free(&data);
+								adec.recycle_frame(data);
 							}
 						}
 
-					} frame;
+					} frame(*this);
 
 					if (!frame.data)
 					{
@@ -335,7 +554,7 @@ public:
 
 					int got_frame = 0;
 
-					int decode = avcodec_decode_audio4(ctx, frame.data, &got_frame, &au);
+					int decode = service->decode(ctx, frame.data, &got_frame, &au);
 
 					if (decode <= 0)
 					{
@@ -712,6 +931,101 @@ s32 cellAdecDecodeAu(u32 handle, vm::ptr<CellAdecAuInfo> auInfo)
 	return CELL_OK;
 }
 
+// Load 4 samples of a planar channel as floats
+static inline __m128 adec_load_samples(const f32* plane)
+{
+	return _mm_loadu_ps(plane);
+}
+
+static inline __m128 adec_load_samples(const s16* plane)
+{
+	const __m128i v = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(plane));
+	return _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16)), _mm_set1_ps(1.0f / 0x8000));
+}
+
+static inline f32 adec_load_sample(f32 sample)
+{
+	return sample;
+}
+
+static inline f32 adec_load_sample(s16 sample)
+{
+	return static_cast<f32>(sample) / 0x8000;
+}
+
+// Byteswap 4 floats for big endian output
+static inline __m128 adec_bswap_samples(__m128 v)
+{
+	__m128i t = _mm_castps_si128(v);
+	t = _mm_or_si128(_mm_slli_epi32(t, 16), _mm_srli_epi32(t, 16));
+	t = _mm_or_si128(_mm_slli_epi16(t, 8), _mm_srli_epi16(t, 8));
+	return _mm_castsi128_ps(t);
+}
+
+// Interleave planar PCM into big endian float frames, 4 samples at a time (channels must be 1, 2, 6 or 8)
+template <typename T>
+static void adec_interleave_pcm(u8* const* planes, u32 channels, u32 samples, be_t<f32>* out)
+{
+	const auto in = reinterpret_cast<const T* const*>(planes);
+	f32* const dst = reinterpret_cast<f32*>(out);
+
+	u32 i = 0;
+
+	for (; i + 4 <= samples; i += 4)
+	{
+		f32* frame = dst + i * channels;
+
+		// Groups of 4 channels are transposed into 4 sample frames
+		u32 ch = 0;
+		for (; ch + 4 <= channels; ch += 4)
+		{
+			__m128 r0 = adec_load_samples(in[ch + 0] + i);
+			__m128 r1 = adec_load_samples(in[ch + 1] + i);
+			__m128 r2 = adec_load_samples(in[ch + 2] + i);
+			__m128 r3 = adec_load_samples(in[ch + 3] + i);
+			_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+
+			_mm_storeu_ps(frame + 0 * channels + ch, adec_bswap_samples(r0));
+			_mm_storeu_ps(frame + 1 * channels + ch, adec_bswap_samples(r1));
+			_mm_storeu_ps(frame + 2 * channels + ch, adec_bswap_samples(r2));
+			_mm_storeu_ps(frame + 3 * channels + ch, adec_bswap_samples(r3));
+		}
+
+		if (ch + 2 <= channels)
+		{
+			const __m128 left = adec_load_samples(in[ch] + i);
+			const __m128 right = adec_load_samples(in[ch + 1] + i);
+			const __m128 lo = adec_bswap_samples(_mm_unpacklo_ps(left, right));
+			const __m128 hi = adec_bswap_samples(_mm_unpackhi_ps(left, right));
+
+			if (channels == 2)
+			{
+				_mm_storeu_ps(frame, lo);
+				_mm_storeu_ps(frame + 4, hi);
+			}
+			else
+			{
+				_mm_storel_pi(reinterpret_cast<__m64*>(frame + 0 * channels + ch), lo);
+				_mm_storeh_pi(reinterpret_cast<__m64*>(frame + 1 * channels + ch), lo);
+				_mm_storel_pi(reinterpret_cast<__m64*>(frame + 2 * channels + ch), hi);
+				_mm_storeh_pi(reinterpret_cast<__m64*>(frame + 3 * channels + ch), hi);
+			}
+		}
+		else if (channels == 1)
+		{
+			_mm_storeu_ps(frame, adec_bswap_samples(adec_load_samples(in[0] + i)));
+		}
+	}
+
+	for (; i < samples; i++)
+	{
+		for (u32 ch = 0; ch < channels; ch++)
+		{
+			out[i * channels + ch] = adec_load_sample(in[ch][i]);
+		}
+	}
+}
+
 s32 cellAdecGetPcm(u32 handle, vm::ptr<float> outBuffer)
 {
 	cellAdec.trace("cellAdecGetPcm(handle=0x%x, outBuffer=*0x%x)", handle, outBuffer);
@@ -730,99 +1044,34 @@ s32 cellAdecGetPcm(u32 handle, vm::ptr<float> outBuffer)
 		return CELL_ADEC_ERROR_EMPTY;
 	}
 
-	std::unique_ptr<AVFrame, void(*)(AVFrame*)> frame(af.data, [](AVFrame* frame)
-	{
-		av_frame_unref(frame);
-		av_frame_free(&frame);
-	});
+	const AudioDecoder::frame_ptr frame(af.data, AudioDecoder::frame_recycler{adec.get()});
 
 	if (outBuffer)
 	{
-		// reverse byte order:
-		if (frame->format == AV_SAMPLE_FMT_FLTP && frame->channels == 1)
-		{
-			float* in_f = (float*)frame->extended_data[0];
-			for (u32 i = 0; i < af.size / 4; i++)
-			{
-				outBuffer[i] = in_f[i];
-			}
-		}
-		else if (frame->format == AV_SAMPLE_FMT_FLTP && frame->channels == 2)
+		const u32 channels = frame->channels;
+
+		if (channels != 1 && channels != 2 && channels != 6 && channels != 8)
 		{
-			float* in_f[2];
-			in_f[0] = (float*)frame->extended_data[0];
-			in_f[1] = (float*)frame->extended_data[1];
-			for (u32 i = 0; i < af.size / 8; i++)
-			{
-				outBuffer[i * 2 + 0] = in_f[0][i];
-				outBuffer[i * 2 + 1] = in_f[1][i];
-			}
+			fmt::throw_exception("Unsupported frame format (channels=%d, format=%d)" HERE, frame->channels, frame->format);
 		}
-		else if (frame->format == AV_SAMPLE_FMT_FLTP && frame->channels == 6)
+
+		switch (frame->format)
 		{
-			float* in_f[6];
-			in_f[0] = (float*)frame->extended_data[0];
-			in_f[1] = (float*)frame->extended_data[1];
-			in_f[2] = (float*)frame->extended_data[2];
-			in_f[3] = (float*)frame->extended_data[3];
-			in_f[4] = (float*)frame->extended_data[4];
-			in_f[5] = (float*)frame->extended_data[5];
-			for (u32 i = 0; i < af.size / 24; i++)
-			{
-				outBuffer[i * 6 + 0] = in_f[0][i];
-				outBuffer[i * 6 + 1] = in_f[1][i];
-				outBuffer[i * 6 + 2] = in_f[2][i];
-				outBuffer[i * 6 + 3] = in_f[3][i];
-				outBuffer[i * 6 + 4] = in_f[4][i];
-				outBuffer[i * 6 + 5] = in_f[5][i];
-			}
-		}
-		else if (frame->format == AV_SAMPLE_FMT_FLTP && frame->channels == 8)
-		{
-			float* in_f[8];
-			in_f[0] = (float*)frame->extended_data[0];
-			in_f[1] = (float*)frame->extended_data[1];
-			in_f[2] = (float*)frame->extended_data[2];
-			in_f[3] = (float*)frame->extended_data[3];
-			in_f[4] = (float*)frame->extended_data[4];
-			in_f[5] = (float*)frame->extended_data[5];
-			in_f[6] = (float*)frame->extended_data[6];
-			in_f[7] = (float*)frame->extended_data[7];
-			for (u32 i = 0; i < af.size / 24; i++)
-			{
-				outBuffer[i * 8 + 0] = in_f[0][i];
-				outBuffer[i * 8 + 1] = in_f[1][i];
-				outBuffer[i * 8 + 2] = in_f[2][i];
-				outBuffer[i * 8 + 3] = in_f[3][i];
-				outBuffer[i * 8 + 4] = in_f[4][i];
-				outBuffer[i * 8 + 5] = in_f[5][i];
-				outBuffer[i * 8 + 6] = in_f[6][i];
-				outBuffer[i * 8 + 7] = in_f[7][i];
-			}
-		}
-		else if (frame->format == AV_SAMPLE_FMT_S16P && frame->channels == 1)
+		case AV_SAMPLE_FMT_FLTP:
 		{
-			s16* in_i = (s16*)frame->extended_data[0];
-			for (u32 i = 0; i < af.size / 2; i++)
-			{
-				outBuffer[i] = (float)in_i[i] / 0x8000;
-			}
+			adec_interleave_pcm<f32>(frame->extended_data, channels, af.size / 4 / channels, outBuffer.get_ptr());
+			break;
 		}
-		else if (frame->format == AV_SAMPLE_FMT_S16P && frame->channels == 2)
+		case AV_SAMPLE_FMT_S16P:
 		{
-			s16* in_i[2];
-			in_i[0] = (s16*)frame->extended_data[0];
-			in_i[1] = (s16*)frame->extended_data[1];
-			for (u32 i = 0; i < af.size / 4; i++)
-			{
-				outBuffer[i * 2 + 0] = (float)in_i[0][i] / 0x8000;
-				outBuffer[i * 2 + 1] = (float)in_i[1][i] / 0x8000;
-			}
+			adec_interleave_pcm<s16>(frame->extended_data, channels, af.size / 2 / channels, outBuffer.get_ptr());
+			break;
 		}
-		else
+		default:
 		{
 			fmt::throw_exception("Unsupported frame format (channels=%d, format=%d)" HERE, frame->channels, frame->format);
 		}
+		}
 	}
 
 	return CELL_OK;
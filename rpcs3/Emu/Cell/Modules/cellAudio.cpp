@@ -55,32 +55,150 @@ void audio_config::on_init(const std::shared_ptr<void>& _this)
 	named_thread::on_init(_this);
 }
 
+// Compute the volume of each frame of the current block (part of cellAudioSetPortLevel functionality)
+static void audio_step_volume(audio_port& port, f32* gain)
+{
+	const auto param = port.level_set.load();
+
+	u32 i = 0;
+
+	if (param.inc != 0.0f)
+	{
+		const bool dec = param.inc < 0.0f;
+
+		for (; i < AUDIO_SAMPLES; i++)
+		{
+			port.level += param.inc;
+
+			if ((!dec && param.value - port.level <= 0.0f) || (dec && param.value - port.level >= 0.0f))
+			{
+				port.level = param.value;
+				port.level_set.compare_and_swap(param, { param.value, 0.0f });
+				break;
+			}
+
+			gain[i] = port.level;
+		}
+	}
+
+	// Constant volume for the rest of the block
+	std::fill(gain + i, gain + AUDIO_SAMPLES, port.level);
+}
+
+// Load 4 big-endian floats (SSE2 byte swap)
+static inline __m128 audio_load_be(const be_t<f32>* ptr)
+{
+	const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr));
+	const __m128i w = _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, 0xb1), 0xb1);
+	return _mm_castsi128_ps(_mm_or_si128(_mm_slli_epi16(w, 8), _mm_srli_epi16(w, 8)));
+}
+
+// Scale 2ch port block by the per-frame volume and accumulate it (2 frames per iteration)
+static void audio_mix_2ch(f32* acc, const be_t<f32>* in, const f32* gain)
+{
+	for (u32 i = 0; i < AUDIO_SAMPLES; i += 2)
+	{
+		const __m128 g01 = _mm_castpd_ps(_mm_load_sd(reinterpret_cast<const f64*>(gain + i)));
+		const __m128 g = _mm_unpacklo_ps(g01, g01);
+		const __m128 v = audio_load_be(in + i * 2);
+		_mm_store_ps(acc + i * 2, _mm_add_ps(_mm_load_ps(acc + i * 2), _mm_mul_ps(v, g)));
+	}
+}
+
+// Scale 8ch port block by the per-frame volume and accumulate it (1 frame per iteration)
+static void audio_mix_8ch(f32* acc, const be_t<f32>* in, const f32* gain)
+{
+	for (u32 i = 0; i < AUDIO_SAMPLES; i++)
+	{
+		const __m128 g = _mm_load1_ps(gain + i);
+		const __m128 v0 = audio_load_be(in + i * 8);
+		const __m128 v1 = audio_load_be(in + i * 8 + 4);
+		_mm_store_ps(acc + i * 8, _mm_add_ps(_mm_load_ps(acc + i * 8), _mm_mul_ps(v0, g)));
+		_mm_store_ps(acc + i * 8 + 4, _mm_add_ps(_mm_load_ps(acc + i * 8 + 4), _mm_mul_ps(v1, g)));
+	}
+}
+
+// Downmix 8ch mix to 2ch and add 2ch mix: L + RL + SL + (C + LFE) * 0.708, R + RR + SR + (C + LFE) * 0.708
+static void audio_downmix_to_2ch(f32* out, const f32* mix2ch, const f32* mix8ch)
+{
+	const __m128 k = _mm_set1_ps(0.708f);
+
+	const auto downmix = [&](const f32* frame)
+	{
+		const __m128 front = _mm_load_ps(frame); // L, R, C, LFE
+		const __m128 back = _mm_load_ps(frame + 4); // RL, RR, SL, SR
+		const __m128 center = _mm_movehl_ps(front, front); // C, LFE
+		const __m128 mid = _mm_mul_ps(_mm_add_ps(center, _mm_shuffle_ps(center, center, 0xb1)), k);
+		return _mm_add_ps(_mm_add_ps(front, _mm_add_ps(back, _mm_movehl_ps(back, back))), mid); // Low half used
+	};
+
+	for (u32 i = 0; i < AUDIO_SAMPLES; i += 2)
+	{
+		const __m128 lr = _mm_movelh_ps(downmix(mix8ch + i * 8), downmix(mix8ch + i * 8 + 8));
+		_mm_store_ps(out + i * 2, _mm_add_ps(lr, _mm_load_ps(mix2ch + i * 2)));
+	}
+}
+
+// Add 2ch mix to front channels of 8ch mix
+static void audio_expand_to_8ch(f32* out, const f32* mix2ch, const f32* mix8ch)
+{
+	const __m128 zero = _mm_setzero_ps();
+
+	for (u32 i = 0; i < AUDIO_SAMPLES; i += 2)
+	{
+		const __m128 lr = _mm_load_ps(mix2ch + i * 2);
+		_mm_store_ps(out + i * 8 + 0, _mm_add_ps(_mm_load_ps(mix8ch + i * 8 + 0), _mm_movelh_ps(lr, zero)));
+		_mm_store_ps(out + i * 8 + 4, _mm_load_ps(mix8ch + i * 8 + 4));
+		_mm_store_ps(out + i * 8 + 8, _mm_add_ps(_mm_load_ps(mix8ch + i * 8 + 8), _mm_movehl_ps(zero, lr)));
+		_mm_store_ps(out + i * 8 + 12, _mm_load_ps(mix8ch + i * 8 + 12));
+	}
+}
+
+// Convert float samples to s16 with saturation (count must be a multiple of 8)
+static void audio_convert_to_s16(__m128i* out, const f32* in, u32 count)
+{
+	const __m128 scale = _mm_set1_ps(0x8000);
+
+	for (u32 i = 0; i < count; i += 8)
+	{
+		out[i / 8] = _mm_packs_epi32(
+			_mm_cvtps_epi32(_mm_mul_ps(_mm_load_ps(in + i), scale)),
+			_mm_cvtps_epi32(_mm_mul_ps(_mm_load_ps(in + i + 4), scale)));
+	}
+}
+
 void audio_config::on_task()
 {
 	thread_ctrl::set_native_priority(1);
 
 	AudioDumper m_dump(g_cfg.audio.dump_to_file ? 2 : 0); // Init AudioDumper for 2 channels if enabled
 
-	float buf2ch[2 * BUFFER_SIZE]{}; // intermediate buffer for 2 channels
-	float buf8ch[8 * BUFFER_SIZE]{}; // intermediate buffer for 8 channels
+	alignas(16) f32 mix2ch[2 * AUDIO_SAMPLES]; // accumulator for 2ch ports
+	alignas(16) f32 mix8ch[8 * AUDIO_SAMPLES]; // accumulator for 8ch ports
+	alignas(16) f32 buf2ch[2 * AUDIO_SAMPLES]; // downmixed output (also used for dumping)
+	alignas(16) f32 gain[AUDIO_SAMPLES]; // per-frame port volume
+	alignas(16) __m128i buf_u16[BUFFER_SIZE];
 
-	const u32 buf_sz = BUFFER_SIZE * (g_cfg.audio.convert_to_u16 ? 2 : 4) * (g_cfg.audio.downmix_to_2ch ? 2 : 8);
+	const bool downmix = g_cfg.audio.downmix_to_2ch.get();
+	const bool convert = g_cfg.audio.convert_to_u16.get();
+	const u32 out_count = AUDIO_SAMPLES * (downmix ? 2 : 8);
+	const u32 buf_sz = out_count * (convert ? 2 : 4);
 
-	std::unique_ptr<float[]> out_buffer[BUFFER_NUM];
+	std::unique_ptr<f32[]> out_buffer[BUFFER_NUM];
 
 	for (u32 i = 0; i < BUFFER_NUM; i++)
 	{
-		out_buffer[i].reset(new float[8 * BUFFER_SIZE] {});
+		out_buffer[i].reset(new f32[8 * BUFFER_SIZE] {});
 	}
 
 	const auto audio = Emu.GetCallbacks().get_audio();
-	audio->Open(buf8ch, buf_sz);
+	audio->Open(out_buffer[0].get(), buf_sz);
 
 	while (fxm::check<audio_config>() && !Emu.IsStopped())
 	{
 		if (Emu.IsPaused())
 		{
-			std::this_thread::sleep_for(1ms); // hack
+			thread_ctrl::wait_for(1000);
 			continue;
 		}
 
@@ -94,7 +212,8 @@ void audio_config::on_task()
 		const u64 expected_time = m_counter * AUDIO_SAMPLES * 1000000 / 48000;
 		if (expected_time >= time_pos)
 		{
-			std::this_thread::sleep_for(1ms); // hack
+			// Sleep until the deadline of the next block; oversleeping only makes the block a bit late, which the mixer tolerates
+			thread_ctrl::wait_for(expected_time - time_pos + 1);
 			continue;
 		}
 
@@ -102,7 +221,8 @@ void audio_config::on_task()
 
 		const u32 out_pos = m_counter % BUFFER_NUM;
 
-		bool first_mix = true;
+		std::memset(mix2ch, 0, sizeof(mix2ch));
+		std::memset(mix8ch, 0, sizeof(mix8ch));
 
 		// mixing:
 		for (auto& port : ports)
@@ -115,130 +235,15 @@ void audio_config::on_task()
 
 			auto buf = vm::_ptr<f32>(buf_addr);
 
-			static const float k = 1.0f; // may be 1.0f
-			const float& m = port.level;
-
-			auto step_volume = [](audio_port& port) // part of cellAudioSetPortLevel functionality
-			{
-				const auto param = port.level_set.load();
-
-				if (param.inc != 0.0f)
-				{
-					port.level += param.inc;
-					const bool dec = param.inc < 0.0f;
-
-					if ((!dec && param.value - port.level <= 0.0f) || (dec && param.value - port.level >= 0.0f))
-					{
-						port.level = param.value;
-						port.level_set.compare_and_swap(param, { param.value, 0.0f });
-					}
-				}
-			};
+			audio_step_volume(port, gain);
 
 			if (port.channel == 2)
 			{
-				if (first_mix)
-				{
-					for (u32 i = 0; i < (sizeof(buf2ch) / sizeof(float)); i += 2)
-					{
-						step_volume(port);
-
-						// reverse byte order
-						const float left = buf[i + 0] * m;
-						const float right = buf[i + 1] * m;
-
-						buf2ch[i + 0] = left;
-						buf2ch[i + 1] = right;
-
-						buf8ch[i * 4 + 0] = left;
-						buf8ch[i * 4 + 1] = right;
-						buf8ch[i * 4 + 2] = 0.0f;
-						buf8ch[i * 4 + 3] = 0.0f;
-						buf8ch[i * 4 + 4] = 0.0f;
-						buf8ch[i * 4 + 5] = 0.0f;
-						buf8ch[i * 4 + 6] = 0.0f;
-						buf8ch[i * 4 + 7] = 0.0f;
-					}
-					first_mix = false;
-				}
-				else
-				{
-					for (u32 i = 0; i < (sizeof(buf2ch) / sizeof(float)); i += 2)
-					{
-						step_volume(port);
-
-						const float left = buf[i + 0] * m;
-						const float right = buf[i + 1] * m;
-
-						buf2ch[i + 0] += left;
-						buf2ch[i + 1] += right;
-
-						buf8ch[i * 4 + 0] += left;
-						buf8ch[i * 4 + 1] += right;
-					}
-				}
+				audio_mix_2ch(mix2ch, buf, gain);
 			}
 			else if (port.channel == 8)
 			{
-				if (first_mix)
-				{
-					for (u32 i = 0; i < (sizeof(buf2ch) / sizeof(float)); i += 2)
-					{
-						step_volume(port);
-
-						const float left = buf[i * 4 + 0] * m;
-						const float right = buf[i * 4 + 1] * m;
-						const float center = buf[i * 4 + 2] * m;
-						const float low_freq = buf[i * 4 + 3] * m;
-						const float rear_left = buf[i * 4 + 4] * m;
-						const float rear_right = buf[i * 4 + 5] * m;
-						const float side_left = buf[i * 4 + 6] * m;
-						const float side_right = buf[i * 4 + 7] * m;
-
-						const float mid = (center + low_freq) * 0.708f;
-						buf2ch[i + 0] = (left + rear_left + side_left + mid) * k;
-						buf2ch[i + 1] = (right + rear_right + side_right + mid) * k;
-
-						buf8ch[i * 4 + 0] = left;
-						buf8ch[i * 4 + 1] = right;
-						buf8ch[i * 4 + 2] = center;
-						buf8ch[i * 4 + 3] = low_freq;
-						buf8ch[i * 4 + 4] = rear_left;
-						buf8ch[i * 4 + 5] = rear_right;
-						buf8ch[i * 4 + 6] = side_left;
-						buf8ch[i * 4 + 7] = side_right;
-					}
-					first_mix = false;
-				}
-				else
-				{
-					for (u32 i = 0; i < (sizeof(buf2ch) / sizeof(float)); i += 2)
-					{
-						step_volume(port);
-
-						const float left = buf[i * 4 + 0] * m;
-						const float right = buf[i * 4 + 1] * m;
-						const float center = buf[i * 4 + 2] * m;
-						const float low_freq = buf[i * 4 + 3] * m;
-						const float rear_left = buf[i * 4 + 4] * m;
-						const float rear_right = buf[i * 4 + 5] * m;
-						const float side_left = buf[i * 4 + 6] * m;
-						const float side_right = buf[i * 4 + 7] * m;
-
-						const float mid = (center + low_freq) * 0.708f;
-						buf2ch[i + 0] += (left + rear_left + side_left + mid) * k;
-						buf2ch[i + 1] += (right + rear_right + side_right + mid) * k;
-
-						buf8ch[i * 4 + 0] += left;
-						buf8ch[i * 4 + 1] += right;
-						buf8ch[i * 4 + 2] += center;
-						buf8ch[i * 4 + 3] += low_freq;
-						buf8ch[i * 4 + 4] += rear_left;
-						buf8ch[i * 4 + 5] += rear_right;
-						buf8ch[i * 4 + 6] += side_left;
-						buf8ch[i * 4 + 7] += side_right;
-					}
-				}
+				audio_mix_8ch(mix8ch, buf, gain);
 			}
 			else
 			{
@@ -248,52 +253,26 @@ void audio_config::on_task()
 			memset(buf, 0, block_size * sizeof(float));
 		}
 
-
-		if (!first_mix)
+		// Copy output data (2ch or 8ch)
+		if (downmix || m_dump.GetCh() == 2)
 		{
-			// Copy output data (2ch or 8ch)
-			if (g_cfg.audio.downmix_to_2ch)
-			{
-				for (u32 i = 0; i < (sizeof(buf2ch) / sizeof(float)); i++)
-				{
-					out_buffer[out_pos][i] = buf2ch[i];
-				}
-			}
-			else
-			{
-				for (u32 i = 0; i < (sizeof(buf8ch) / sizeof(float)); i++)
-				{
-					out_buffer[out_pos][i] = buf8ch[i];
-				}
-			}
+			audio_downmix_to_2ch(buf2ch, mix2ch, mix8ch);
 		}
 
-		const u64 stamp1 = get_system_time();
-
-		if (first_mix)
+		if (downmix)
 		{
-			std::memset(out_buffer[out_pos].get(), 0, 8 * BUFFER_SIZE * sizeof(float));
+			std::memcpy(out_buffer[out_pos].get(), buf2ch, sizeof(buf2ch));
 		}
-
-		if (g_cfg.audio.convert_to_u16)
+		else
 		{
-			// convert the data from float to u16 with clipping:
-			// 2x MULPS
-			// 2x MAXPS (optional)
-			// 2x MINPS (optional)
-			// 2x CVTPS2DQ (converts float to s32)
-			// PACKSSDW (converts s32 to s16 with signed saturation)
-
-			__m128i buf_u16[BUFFER_SIZE];
+			audio_expand_to_8ch(out_buffer[out_pos].get(), mix2ch, mix8ch);
+		}
 
-			for (size_t i = 0; i < 8 * BUFFER_SIZE; i += 8)
-			{
-				const auto scale = _mm_set1_ps(0x8000);
-				buf_u16[i / 8] = _mm_packs_epi32(
-					_mm_cvtps_epi32(_mm_mul_ps(_mm_load_ps(out_buffer[out_pos].get() + i), scale)),
-					_mm_cvtps_epi32(_mm_mul_ps(_mm_load_ps(out_buffer[out_pos].get() + i + 4), scale)));
-			}
+		const u64 stamp1 = get_system_time();
 
+		if (convert)
+		{
+			audio_convert_to_s16(buf_u16, out_buffer[out_pos].get(), out_count);
 			audio->AddData(buf_u16, buf_sz);
 		}
 		else
@@ -336,7 +315,7 @@ void audio_config::on_task()
 		switch (m_dump.GetCh())
 		{
 		case 2: m_dump.WriteData(&buf2ch, sizeof(buf2ch)); break; // write file data (2 ch)
-		case 8: m_dump.WriteData(&buf8ch, sizeof(buf8ch)); break; // write file data (8 ch)
+		case 8: m_dump.WriteData(out_buffer[out_pos].get(), 8 * AUDIO_SAMPLES * sizeof(f32)); break; // write file data (8 ch)
 		}
 
 		cellAudio.trace("Audio perf: (access=%d, AddData=%d, events=%d, dump=%d)",
@@ -27,6 +27,41 @@ enum
 	PRIVATE_STREAM_2         = 0x000001bf,
 };
 
+// Returns the offset of the first 00 00 01 start code prefix in data, or size if there is none
+static u32 dmux_find_start_code(const u8* data, u32 size)
+{
+	u32 pos = 0;
+
+	if (size >= 18)
+	{
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i one = _mm_set1_epi8(1);
+
+		// Compare 16 candidate positions at once (bytes i, i + 1 and i + 2 of each)
+		for (; pos + 18 <= size; pos += 16)
+		{
+			const __m128i b0 = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos)), zero);
+			const __m128i b1 = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos + 1)), zero);
+			const __m128i b2 = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos + 2)), one);
+
+			if (const u32 mask = _mm_movemask_epi8(_mm_and_si128(_mm_and_si128(b0, b1), b2)))
+			{
+				return pos + cnttz32(mask, true);
+			}
+		}
+	}
+
+	for (; pos + 3 <= size; pos++)
+	{
+		if (data[pos] == 0 && data[pos + 1] == 0 && data[pos + 2] == 1)
+		{
+			return pos;
+		}
+	}
+
+	return size;
+}
+
 struct DemuxerStream
 {
 	u32 addr;
@@ -134,6 +169,15 @@ class ElementaryStream
 {
 	std::mutex m_mutex;
 
+	struct raw_range
+	{
+		u32 addr;
+		u32 size;
+	};
+
+	std::vector<raw_range> raw_refs; // demultiplexed data still located in the input stream, follows raw_data (managed by demuxer thread)
+	u32 raw_refs_size = 0;
+
 	squeue_t<u32> entries; // AU starting addresses
 	u32 put_count; // number of AU written
 	u32 got_count; // number of AU obtained by GetAu(Ex)
@@ -169,6 +213,15 @@ public:
 
 	void push(DemuxerStream& stream, u32 size); // called by demuxer thread (not multithread-safe)
 
+	void push_ref(DemuxerStream& stream, u32 size); // same as push() but only references the stream memory
+
+	void copy_refs(); // copy referenced data to raw_data before the input stream is released
+
+	u32 raw_size() const
+	{
+		return static_cast<u32>(raw_data.size()) + raw_refs_size;
+	}
+
 	bool isfull(u32 space);
 
 	void push_au(u32 size, u64 dts, u64 pts, u64 userdata, bool rap, u32 specific);
@@ -220,6 +273,18 @@ public:
 
 		u32 cb_add = 0;
 
+		// The input stream may be reused by the game once DEMUX_DONE is sent
+		const auto copy_es_refs = [&]()
+		{
+			for (ElementaryStream* es : esALL)
+			{
+				if (es)
+				{
+					es->copy_refs();
+				}
+			}
+		};
+
 		while (true)
 		{
 			if (Emu.IsStopped() || is_closed)
@@ -237,6 +302,7 @@ public:
 				{
 					// demuxing finished
 					is_running = false;
+					copy_es_refs();
 
 					// callback
 					auto dmuxMsg = vm::ptr<CellDmuxMsg>::make(memAddr + (cb_add ^= 16));
@@ -445,7 +511,7 @@ public:
 					{
 						ElementaryStream& es = *esAVC[ch];
 
-						const u32 old_size = (u32)es.raw_data.size();
+						const u32 old_size = es.raw_size();
 						if (es.isfull(old_size))
 						{
 							stream = backup;
@@ -476,7 +542,7 @@ public:
 						// reconstruction of MPEG2-PS stream for vdec module
 						const u32 size = len + pes.size + 9;
 						stream = backup;
-						es.push(stream, size);
+						es.push_ref(stream, size);
 					}
 					else
 					{
@@ -495,6 +561,7 @@ public:
 
 					// search
 					stream.skip(1);
+					stream.skip(dmux_find_start_code(vm::_ptr<const u8>(stream.addr), stream.size));
 				}
 				}
 
@@ -535,6 +602,8 @@ public:
 				// demuxing stopped
 				if (is_running.exchange(false))
 				{
+					copy_es_refs();
+
 					// callback
 					auto dmuxMsg = vm::ptr<CellDmuxMsg>::make(memAddr + (cb_add ^= 16));
 					dmuxMsg->msgType = CELL_DMUX_MSG_TYPE_DEMUX_DONE;
@@ -611,7 +680,7 @@ public:
 			{
 				ElementaryStream& es = *task.es.es_ptr;
 
-				const u32 old_size = (u32)es.raw_data.size();
+				const u32 old_size = es.raw_size();
 				if (old_size && (es.fidMajor & -0x10) == 0xe0)
 				{
 					// TODO (it's only for AVC, some ATX data may be lost)
@@ -632,9 +701,9 @@ public:
 					lv2_obj::sleep(*this);
 				}
 				
-				if (es.raw_data.size())
+				if (es.raw_size())
 				{
-					cellDmux.error("dmuxFlushEs: 0x%x bytes lost (es_id=%d)", (u32)es.raw_data.size(), es.id);
+					cellDmux.error("dmuxFlushEs: 0x%x bytes lost (es_id=%d)", es.raw_size(), es.id);
 				}
 
 				// callback
@@ -810,8 +879,34 @@ void ElementaryStream::push_au(u32 size, u64 dts, u64 pts, u64 userdata, bool ra
 			put = memAddr;
 		}
 
-		std::memcpy(vm::base(put + 128), raw_data.data(), size);
-		raw_data.erase(raw_data.begin(), raw_data.begin() + size);
+		u8* const dst = vm::_ptr<u8>(put + 128);
+
+		// Copied data comes first, the rest is taken directly from the input stream
+		const u32 copied = std::min<u32>(size, static_cast<u32>(raw_data.size()));
+		std::memcpy(dst, raw_data.data(), copied);
+		raw_data.erase(raw_data.begin(), raw_data.begin() + copied);
+
+		u32 offset = copied;
+		auto range = raw_refs.begin();
+
+		for (; offset < size; ++range)
+		{
+			verify(HERE), range != raw_refs.end();
+
+			const u32 count = std::min(size - offset, range->size);
+			std::memcpy(dst + offset, vm::base(range->addr), count);
+			offset += count;
+			raw_refs_size -= count;
+
+			if (count < range->size)
+			{
+				range->addr += count;
+				range->size -= count;
+				break;
+			}
+		}
+
+		raw_refs.erase(raw_refs.begin(), range);
 
 		auto info = vm::ptr<CellDmuxAuInfoEx>::make(put);
 		info->auAddr = put + 128;
@@ -858,6 +953,36 @@ void ElementaryStream::push(DemuxerStream& stream, u32 size)
 	stream.skip(size);
 }
 
+void ElementaryStream::push_ref(DemuxerStream& stream, u32 size)
+{
+	if (!raw_refs.empty() && raw_refs.back().addr + raw_refs.back().size == stream.addr)
+	{
+		raw_refs.back().size += size;
+	}
+	else
+	{
+		raw_refs.push_back({stream.addr, size});
+	}
+
+	raw_refs_size += size;
+	stream.skip(size);
+}
+
+void ElementaryStream::copy_refs()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	for (const raw_range& range : raw_refs)
+	{
+		const auto old_size = raw_data.size();
+		raw_data.resize(old_size + range.size);
+		std::memcpy(raw_data.data() + old_size, vm::base(range.addr), range.size);
+	}
+
+	raw_refs.clear();
+	raw_refs_size = 0;
+}
+
 bool ElementaryStream::release()
 {
 	std::lock_guard<std::mutex> lock(m_mutex);
@@ -928,6 +1053,8 @@ void ElementaryStream::reset()
 	released = 0;
 	raw_data.clear();
 	raw_pos = 0;
+	raw_refs.clear();
+	raw_refs_size = 0;
 }
 
 void dmuxQueryAttr(u32 info_addr /* may be 0 */, vm::ptr<CellDmuxAttr> attr)
@@ -1,5 +1,6 @@
 ﻿#include "stdafx.h"
 #include "Emu/System.h"
+#include "Emu/IdManager.h"
 #include "Emu/Cell/PPUModule.h"
 
 // Defines STB_TRUETYPE_IMPLEMENTATION *once* before including stb_truetype.h (as noted in stb_truetype.h's comments)
@@ -8,8 +9,117 @@
 
 #include "cellFont.h"
 
+#include <list>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+
 logs::channel cellFont("cellFont");
 
+// Rasterized glyphs kept per opened font, so repeated text only costs a blit
+struct font_glyph_cache
+{
+	// Upper bound of bitmap memory held for a single font
+	static constexpr u32 max_bytes_per_font = 1 << 20;
+
+	struct glyph
+	{
+		u64 key;
+		s32 width;
+		s32 height;
+		s32 xoff;
+		s32 yoff;
+		s32 baseline_y;
+		std::vector<u8> bitmap;
+	};
+
+	struct font_entry
+	{
+		std::list<glyph> lru; // Most recently used first
+		std::unordered_map<u64, std::list<glyph>::iterator> lookup;
+		u32 bytes = 0;
+		u64 hits = 0;
+		u64 misses = 0;
+	};
+
+	std::mutex mutex;
+
+	// Keyed by the font info and the font data it was initialized with, the info lives in guest memory and may be reinitialized in place
+	std::map<std::pair<const stbtt_fontinfo*, const u8*>, font_entry> fonts;
+
+	// The renderer only depends on the vertical pixel scale for now
+	static u64 make_key(u32 code, float scale)
+	{
+		u32 scale_bits;
+		std::memcpy(&scale_bits, &scale, sizeof(scale_bits));
+		return u64{scale_bits} << 32 | code;
+	}
+
+	// Returns the cached glyph, rasterizing it on a miss. The pointer stays valid until the lock is released.
+	const glyph& get(stbtt_fontinfo* font, u32 code, float scale_y)
+	{
+		const float scale = stbtt_ScaleForPixelHeight(font, scale_y);
+		const u64 key = make_key(code, scale);
+
+		auto& entry = fonts[std::make_pair(font, font->data)];
+		const auto found = entry.lookup.find(key);
+
+		if (found != entry.lookup.end())
+		{
+			entry.hits++;
+			entry.lru.splice(entry.lru.begin(), entry.lru, found->second);
+			return *found->second;
+		}
+
+		entry.misses++;
+
+		glyph result{key, 0, 0, 0, 0, 0};
+
+		if (u8* box = stbtt_GetCodepointBitmap(font, scale, scale, code, &result.width, &result.height, &result.xoff, &result.yoff))
+		{
+			result.bitmap.assign(box, box + result.width * result.height);
+			stbtt_FreeBitmap(box, nullptr);
+		}
+
+		s32 ascent, descent, line_gap;
+		stbtt_GetFontVMetrics(font, &ascent, &descent, &line_gap);
+		result.baseline_y = (int)((float)ascent * scale); // ???
+
+		entry.bytes += ::size32(result.bitmap);
+		entry.lru.emplace_front(std::move(result));
+		entry.lookup.emplace(key, entry.lru.begin());
+
+		// Evict least recently used glyphs, never the one just inserted
+		while (entry.bytes > max_bytes_per_font && entry.lru.size() > 1)
+		{
+			const auto& last = entry.lru.back();
+			entry.bytes -= ::size32(last.bitmap);
+			entry.lookup.erase(last.key);
+			entry.lru.pop_back();
+		}
+
+		return entry.lru.front();
+	}
+
+	// Drop the glyphs of every font which used this font info
+	void remove(const stbtt_fontinfo* font)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+
+		const auto begin = fonts.lower_bound(std::make_pair(font, static_cast<const u8*>(nullptr)));
+		auto end = begin;
+
+		for (; end != fonts.end() && end->first.first == font; ++end)
+		{
+			const auto& entry = end->second;
+			const u64 total = entry.hits + entry.misses;
+			cellFont.notice("Glyph cache: %llu hits, %llu misses (%.1f%% hit rate), %u glyphs, %u bytes", entry.hits, entry.misses, total ? entry.hits * 100. / total : 0., ::size32(entry.lru), entry.bytes);
+		}
+
+		fonts.erase(begin, end);
+	}
+};
+
 // Functions
 s32 cellFontInitializeWithRevision(u64 revisionFlags, vm::ptr<CellFontConfig> config)
 {
@@ -56,6 +166,12 @@ s32 cellFontOpenFontMemory(vm::ptr<CellFontLibrary> library, u32 fontAddr, u32 f
 	if (!stbtt_InitFont(font->stbfont, vm::_ptr<unsigned char>(fontAddr), 0))
 		return CELL_FONT_ERROR_FONT_OPEN_FAILED;
 
+	// The font struct may be reused without cellFontCloseFont, forget glyphs of the previous font
+	if (const auto cache = fxm::get<font_glyph_cache>())
+	{
+		cache->remove(font->stbfont);
+	}
+
 	font->renderer_addr = 0;
 	font->fontdata_addr = fontAddr;
 	font->origin = CELL_FONT_OPEN_MEMORY;
@@ -307,39 +423,36 @@ s32 cellFontRenderCharGlyphImage(vm::ptr<CellFont> font, u32 code, vm::ptr<CellF
 		return CELL_FONT_ERROR_RENDERER_UNBIND;
 	}
 
-	// Render the character
-	s32 width, height, xoff, yoff;
-	float scale = stbtt_ScaleForPixelHeight(font->stbfont, font->scale_y);
-	unsigned char* box = stbtt_GetCodepointBitmap(font->stbfont, scale, scale, code, &width, &height, &xoff, &yoff);
+	const auto cache = fxm::get_always<font_glyph_cache>();
+	std::lock_guard<std::mutex> lock(cache->mutex);
 
-	if (!box)
+	// Render the character (or reuse a previous rasterization)
+	const auto& glyph = cache->get(font->stbfont, code, font->scale_y);
+
+	if (glyph.bitmap.empty())
 	{
 		return CELL_OK;
 	}
 
-	// Get the baseLineY value
-	s32 baseLineY;
-	s32 ascent, descent, lineGap;
-	stbtt_GetFontVMetrics(font->stbfont, &ascent, &descent, &lineGap);
-	baseLineY = (int)((float)ascent * scale); // ???
-
 	// Move the rendered character to the surface
 	unsigned char* buffer = vm::_ptr<unsigned char>(surface->buffer.addr());
-	for (u32 ypos = 0; ypos < (u32)height; ypos++)
+
+	if ((u32)x >= (u32)surface->width)
 	{
-		if ((u32)y + ypos + yoff + baseLineY >= (u32)surface->height)
-			break;
+		return CELL_OK;
+	}
 
-		for (u32 xpos = 0; xpos < (u32)width; xpos++)
-		{
-			if ((u32)x + xpos >= (u32)surface->width)
-				break;
+	const u32 row_size = std::min<u32>(glyph.width, (u32)surface->width - (u32)x);
 
-			// TODO: There are some oddities in the position of the character in the final buffer
-			buffer[((s32)y + ypos + yoff + baseLineY)*surface->width + (s32)x + xpos] = box[ypos * width + xpos];
-		}
+	for (u32 ypos = 0; ypos < (u32)glyph.height; ypos++)
+	{
+		if ((u32)y + ypos + glyph.yoff + glyph.baseline_y >= (u32)surface->height)
+			break;
+
+		// TODO: There are some oddities in the position of the character in the final buffer
+		std::memcpy(buffer + ((s32)y + ypos + glyph.yoff + glyph.baseline_y) * surface->width + (s32)x, glyph.bitmap.data() + ypos * glyph.width, row_size);
 	}
-	stbtt_FreeBitmap(box, 0);
+
 	return CELL_OK;
 }
 
@@ -389,6 +502,11 @@ s32 cellFontCloseFont(vm::ptr<CellFont> font)
 		font->origin == CELL_FONT_OPEN_MEMORY)
 	{
 		vm::dealloc(font->fontdata_addr, vm::main);
+
+		if (const auto cache = fxm::get<font_glyph_cache>())
+		{
+			cache->remove(font->stbfont);
+		}
 	}
 
 	return CELL_OK;
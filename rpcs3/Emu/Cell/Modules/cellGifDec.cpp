@@ -3,11 +3,9 @@
 #include "Emu/IdManager.h"
 #include "Emu/Cell/PPUModule.h"
 
-// STB_IMAGE_IMPLEMENTATION is already defined in stb_image.cpp
-#include <stb_image.h>
-
 #include "Emu/Cell/lv2/sys_fs.h"
 #include "cellGifDec.h"
+#include "image_decoder.h"
 
 logs::channel cellGifDec("cellGifDec");
 
@@ -170,103 +168,42 @@ s32 cellGifDecDecodeData(PMainHandle mainHandle, PSubHandle subHandle, vm::ptr<u
 	const u64& fileSize = subHandle->fileSize;
 	const CellGifDecOutParam& current_outParam = subHandle->outParam; 
 
-	//Copy the GIF file to a buffer
-	std::unique_ptr<u8[]> gif(new u8[fileSize]);
+	image_decoder::pixel_layout layout;
+
+	switch ((u32)current_outParam.outputColorSpace)
+	{
+	case CELL_GIFDEC_RGBA: layout = image_decoder::pixel_layout::rgba; break;
+	case CELL_GIFDEC_ARGB: layout = image_decoder::pixel_layout::argb; break;
+	default:
+		return CELL_GIFDEC_ERROR_ARG;
+	}
+
+	// The source is read in place (buffer) or streamed (file), and the result is written straight to the output
+	image_decoder::source src;
+	src.size = fileSize;
+
+	std::shared_ptr<lv2_file> file;
 
 	switch (subHandle->src.srcSelect)
 	{
 	case CELL_GIFDEC_BUFFER:
-		std::memcpy(gif.get(), subHandle->src.streamPtr.get_ptr(), fileSize);
+		src.buffer = vm::_ptr<const u8>(subHandle->src.streamPtr.addr());
 		break;
 
 	case CELL_GIFDEC_FILE:
-	{
-		auto file = idm::get<lv2_fs_object, lv2_file>(fd);
-		file->file.seek(0);
-		file->file.read(gif.get(), fileSize);
+		file = idm::get<lv2_fs_object, lv2_file>(fd);
+		src.file = &file->file;
 		break;
 	}
-	}
 
-	//Decode GIF file. (TODO: Is there any faster alternative? Can we do it without external libraries?)
-	int width, height, actual_components;
-	auto image = std::unique_ptr<unsigned char,decltype(&::free)>
-		(
-			stbi_load_from_memory(gif.get(), (s32)fileSize, &width, &height, &actual_components, 4),
-			&::free
-		);
+	image_decoder::image image;
 
-	if (!image)
-		return CELL_GIFDEC_ERROR_STREAM_FORMAT;
-
-	const int bytesPerLine = (u32)dataCtrlParam->outputBytesPerLine;
-	const char nComponents = 4;
-	uint image_size = width * height * nComponents;
-
-	switch((u32)current_outParam.outputColorSpace)
-	{
-	case CELL_GIFDEC_RGBA:
-	{
-		if (bytesPerLine > width * nComponents) // Check if we need padding
-		{
-			const int linesize = std::min(bytesPerLine, width * nComponents);
-			for (int i = 0; i < height; i++)
-			{
-				const int dstOffset = i * bytesPerLine;
-				const int srcOffset = width * nComponents * i;
-				memcpy(&data[dstOffset], &image.get()[srcOffset], linesize);
-			}
-		}
-		else
-		{
-			memcpy(data.get_ptr(), image.get(), image_size);
-		}
-	}
-	break;
-
-	case CELL_GIFDEC_ARGB:
+	if (!image_decoder::decode(src, layout, image))
 	{
-		if (bytesPerLine > width * nComponents) // Check if we need padding
-		{
-			//TODO: find out if we can't do padding without an extra copy
-			const int linesize = std::min(bytesPerLine, width * nComponents);
-			char *output = (char *) malloc(linesize);
-			for (int i = 0; i < height; i++)
-			{
-				const int dstOffset = i * bytesPerLine;
-				const int srcOffset = width * nComponents * i;
-				for (int j = 0; j < linesize; j += nComponents)
-				{
-					output[j + 0] = image.get()[srcOffset + j + 3];
-					output[j + 1] = image.get()[srcOffset + j + 0];
-					output[j + 2] = image.get()[srcOffset + j + 1];
-					output[j + 3] = image.get()[srcOffset + j + 2];
-				}
-				memcpy(&data[dstOffset], output, linesize);
-			}
-			free(output);
-		}
-		else
-		{
-			uint* img = (uint*)new char[image_size];
-			uint* source_current = (uint*)&(image.get()[0]);
-			uint* dest_current = img;
-			for (uint i = 0; i < image_size / nComponents; i++) 
-			{
-				uint val = *source_current;
-				*dest_current = (val >> 24) | (val << 8); // set alpha (A8) as leftmost byte
-				source_current++;
-				dest_current++;
-			}
-			memcpy(data.get_ptr(), img, image_size); 
-			delete[] img;
-		}
+		return CELL_GIFDEC_ERROR_STREAM_FORMAT;
 	}
-	break;
 
-	default:
-		return CELL_GIFDEC_ERROR_ARG;
-	}
+	image_decoder::write(image, layout, data.get_ptr(), dataCtrlParam->outputBytesPerLine, false);
 
 	dataOutInfo->status = CELL_GIFDEC_DEC_STATUS_FINISH;
 	dataOutInfo->recordType = CELL_GIFDEC_RECORD_TYPE_IMAGE_DESC;
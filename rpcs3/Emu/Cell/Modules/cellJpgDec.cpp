@@ -3,14 +3,33 @@
 #include "Emu/IdManager.h"
 #include "Emu/Cell/PPUModule.h"
 
-// STB_IMAGE_IMPLEMENTATION is already defined in stb_image.cpp
-#include <stb_image.h>
-
 #include "Emu/Cell/lv2/sys_fs.h"
 #include "cellJpgDec.h"
+#include "image_decoder.h"
 
 logs::channel cellJpgDec("cellJpgDec");
 
+// Returned lv2_file is kept alive by the caller while the source is in use
+static image_decoder::source get_jpg_source(const CellJpgDecSubHandle& handle, std::shared_ptr<lv2_file>& file)
+{
+	image_decoder::source src;
+	src.size = handle.fileSize;
+
+	switch (handle.src.srcSelect)
+	{
+	case CELL_JPGDEC_BUFFER:
+		src.buffer = vm::_ptr<const u8>(handle.src.streamPtr);
+		break;
+
+	case CELL_JPGDEC_FILE:
+		file = idm::get<lv2_fs_object, lv2_file>(handle.fd);
+		src.file = &file->file;
+		break;
+	}
+
+	return src;
+}
+
 s32 cellJpgDecCreate(u32 mainHandle, u32 threadInParam, u32 threadOutParam)
 {
 	UNIMPLEMENTED_FUNC(cellJpgDec);
@@ -95,59 +114,44 @@ s32 cellJpgDecReadHeader(u32 mainHandle, u32 subHandle, vm::ptr<CellJpgDecInfo>
 		return CELL_JPGDEC_ERROR_FATAL;
 	}
 
-	const u32& fd = subHandle_data->fd;
-	const u64& fileSize = subHandle_data->fileSize;
 	CellJpgDecInfo& current_info = subHandle_data->info;
 
-	// Write the header to buffer
-	std::unique_ptr<u8[]> buffer(new u8[fileSize]);
+	std::shared_ptr<lv2_file> file;
+	const image_decoder::source src = get_jpg_source(*subHandle_data, file);
+
+	// Only the SOI marker and the JFIF identifier are checked here, the dimensions are parsed by the decoder
+	u8 header[10];
 
-	switch (subHandle_data->src.srcSelect)
+	if (src.size < sizeof(header))
 	{
-	case CELL_JPGDEC_BUFFER:
-		std::memcpy(buffer.get(), vm::base(subHandle_data->src.streamPtr), fileSize);
-		break;
+		return CELL_JPGDEC_ERROR_HEADER;
+	}
 
-	case CELL_JPGDEC_FILE:
+	if (src.file)
 	{
-		auto file = idm::get<lv2_fs_object, lv2_file>(fd);
-		file->file.seek(0);
-		file->file.read(buffer.get(), fileSize);
-		break;
+		src.file->seek(0);
+		src.file->read(header, sizeof(header));
 	}
+	else
+	{
+		std::memcpy(header, src.buffer, sizeof(header));
 	}
 
-	if ((le_t<u32>&)(buffer[0]) != 0xE0FFD8FF || // Error: Not a valid SOI header
-		(le_t<u32>&)(buffer[6]) != 0x4649464A)   // Error: Not a valid JFIF string
+	if ((le_t<u32>&)(header[0]) != 0xE0FFD8FF || // Error: Not a valid SOI header
+		(le_t<u32>&)(header[6]) != 0x4649464A)   // Error: Not a valid JFIF string
 	{
 		return CELL_JPGDEC_ERROR_HEADER; 
 	}
 
-	u32 i = 4;
-	
-	if(i >= fileSize)
-		return CELL_JPGDEC_ERROR_HEADER;
-
-	u16 block_length = buffer[i] * 0xFF + buffer[i+1];
+	u32 width, height, components;
 
-	while(true)
+	if (!image_decoder::get_info(src, width, height, components))
 	{
-		i += block_length;                                  // Increase the file index to get to the next block
-		if (i >= fileSize ||                                // Check to protect against segmentation faults
-			buffer[i] != 0xFF)                              // Check that we are truly at the start of another block
-		{
-			return CELL_JPGDEC_ERROR_HEADER;
-		}
-
-		if(buffer[i+1] == 0xC0)
-			break;                                          // 0xFFC0 is the "Start of frame" marker which contains the file size
-
-		i += 2;                                             // Skip the block marker
-		block_length = buffer[i] * 0xFF + buffer[i+1];      // Go to the next block
+		return CELL_JPGDEC_ERROR_HEADER;
 	}
 
-	current_info.imageWidth    = buffer[i+7]*0x100 + buffer[i+8];
-	current_info.imageHeight   = buffer[i+5]*0x100 + buffer[i+6];
+	current_info.imageWidth    = width;
+	current_info.imageHeight   = height;
 	current_info.numComponents = 3; // Unimplemented
 	current_info.colorSpace    = CELL_JPG_RGB;
 
@@ -174,108 +178,15 @@ s32 cellJpgDecDecodeData(u32 mainHandle, u32 subHandle, vm::ptr<u8> data, vm::cp
 		return CELL_JPGDEC_ERROR_FATAL;
 	}
 
-	const u32& fd = subHandle_data->fd;
-	const u64& fileSize = subHandle_data->fileSize;
 	const CellJpgDecOutParam& current_outParam = subHandle_data->outParam; 
 
-	//Copy the JPG file to a buffer
-	std::unique_ptr<u8[]> jpg(new u8[fileSize]);
-
-	switch (subHandle_data->src.srcSelect)
-	{
-	case CELL_JPGDEC_BUFFER:
-		std::memcpy(jpg.get(), vm::base(subHandle_data->src.streamPtr), fileSize);
-		break;
+	image_decoder::pixel_layout layout;
 
-	case CELL_JPGDEC_FILE:
-	{
-		auto file = idm::get<lv2_fs_object, lv2_file>(fd);
-		file->file.seek(0);
-		file->file.read(jpg.get(), fileSize);
-		break;
-	}
-	}
-
-	//Decode JPG file. (TODO: Is there any faster alternative? Can we do it without external libraries?)
-	int width, height, actual_components;
-	auto image = std::unique_ptr<unsigned char,decltype(&::free)>
-		(
-			stbi_load_from_memory(jpg.get(), (s32)fileSize, &width, &height, &actual_components, 4),
-			&::free
-		);
-
-	if (!image)
-		return CELL_JPGDEC_ERROR_STREAM_FORMAT;
-
-	const bool flip = current_outParam.outputMode == CELL_JPGDEC_BOTTOM_TO_TOP;
-	const int bytesPerLine = (u32)dataCtrlParam->outputBytesPerLine;
-	size_t image_size = width * height;
-
-	switch((u32)current_outParam.outputColorSpace)
-	{
-	case CELL_JPG_RGB:
-	case CELL_JPG_RGBA:
-	{
-		const char nComponents = current_outParam.outputColorSpace == CELL_JPG_RGBA ? 4 : 3;
-		image_size *= nComponents;
-		if (bytesPerLine > width * nComponents || flip) //check if we need padding
-		{
-			const int linesize = std::min(bytesPerLine, width * nComponents);
-			for (int i = 0; i < height; i++)
-			{
-				const int dstOffset = i * bytesPerLine;
-				const int srcOffset = width * nComponents * (flip ? height - i - 1 : i);
-				memcpy(&data[dstOffset], &image.get()[srcOffset], linesize);
-			}
-		}
-		else
-		{
-			memcpy(data.get_ptr(), image.get(), image_size);
-		}
-	}
-	break;
-
-	case CELL_JPG_ARGB:
+	switch ((u32)current_outParam.outputColorSpace)
 	{
-		const int nComponents = 4;
-		image_size *= nComponents;
-		if (bytesPerLine > width * nComponents || flip) //check if we need padding
-		{
-			//TODO: Find out if we can't do padding without an extra copy
-			const int linesize = std::min(bytesPerLine, width * nComponents);
-			char *output = (char *) malloc(linesize);
-			for (int i = 0; i < height; i++)
-			{
-				const int dstOffset = i * bytesPerLine;
-				const int srcOffset = width * nComponents * (flip ? height - i - 1 : i);
-				for (int j = 0; j < linesize; j += nComponents)
-				{
-					output[j + 0] = image.get()[srcOffset + j + 3];
-					output[j + 1] = image.get()[srcOffset + j + 0];
-					output[j + 2] = image.get()[srcOffset + j + 1];
-					output[j + 3] = image.get()[srcOffset + j + 2];
-				}
-				memcpy(&data[dstOffset], output, linesize);
-			}
-			free(output);
-		}
-		else
-		{
-			uint* img = (uint*)new char[image_size];
-			uint* source_current = (uint*)&(image.get()[0]);
-			uint* dest_current = img;
-			for (uint i = 0; i < image_size / nComponents; i++) 
-			{
-				uint val = *source_current;
-				*dest_current = (val >> 24) | (val << 8); // set alpha (A8) as leftmost byte
-				source_current++;
-				dest_current++;
-			}
-			memcpy(data.get_ptr(), img, image_size); 
-			delete[] img;
-		}
-	}
-	break;
+	case CELL_JPG_RGB: layout = image_decoder::pixel_layout::rgb; break;
+	case CELL_JPG_RGBA: layout = image_decoder::pixel_layout::rgba; break;
+	case CELL_JPG_ARGB: layout = image_decoder::pixel_layout::argb; break;
 
 	case CELL_JPG_GRAYSCALE:
 	case CELL_JPG_YCbCr:
@@ -283,16 +194,29 @@ s32 cellJpgDecDecodeData(u32 mainHandle, u32 subHandle, vm::ptr<u8> data, vm::cp
 	case CELL_JPG_GRAYSCALE_TO_ALPHA_RGBA:
 	case CELL_JPG_GRAYSCALE_TO_ALPHA_ARGB:
 		cellJpgDec.error("cellJpgDecDecodeData: Unsupported color space (%d)", current_outParam.outputColorSpace);
-	break;
+		dataOutInfo->status = CELL_JPGDEC_DEC_STATUS_FINISH;
+		return CELL_OK;
 
 	default:
 		return CELL_JPGDEC_ERROR_ARG;
 	}
 
+	// The source is read in place (buffer) or streamed (file), and the result is written straight to the output
+	std::shared_ptr<lv2_file> file;
+	image_decoder::image image;
+
+	if (!image_decoder::decode(get_jpg_source(*subHandle_data, file), layout, image))
+	{
+		return CELL_JPGDEC_ERROR_STREAM_FORMAT;
+	}
+
+	const bool flip = current_outParam.outputMode == CELL_JPGDEC_BOTTOM_TO_TOP;
+	const u32 lines = image_decoder::write(image, layout, data.get_ptr(), dataCtrlParam->outputBytesPerLine, flip);
+
 	dataOutInfo->status = CELL_JPGDEC_DEC_STATUS_FINISH;
 
 	if(dataCtrlParam->outputBytesPerLine)
-		dataOutInfo->outputLines = (u32)(image_size / dataCtrlParam->outputBytesPerLine);
+		dataOutInfo->outputLines = lines;
 
 	return CELL_OK;
 }
@@ -10,6 +10,8 @@ typedef int HostCode;
 #else
 #include <iconv.h>
 #include <errno.h>
+#include <mutex>
+#include <unordered_map>
 typedef const char *HostCode;
 #endif
 
@@ -205,8 +207,432 @@ std::string _OemToOem(HostCode src_code, HostCode dst_code, const std::string& s
 
 #endif
 
+// Unicode encodings (big endian, no byte order mark) and ISO-8859-1 are converted natively, without going through the host
+static bool _L10nIsNativeCode(s32 code)
+{
+	switch (code)
+	{
+	case L10N_UTF8:
+	case L10N_UTF16:
+	case L10N_UTF32:
+	case L10N_UCS2:
+	case L10N_UCS4:
+	case L10N_ISO_8859_1:
+		return true;
+	default:
+		return false;
+	}
+}
+
+static u32 _L10nUnitSize(s32 code)
+{
+	switch (code)
+	{
+	case L10N_UTF16:
+	case L10N_UCS2:
+		return 2;
+	case L10N_UTF32:
+	case L10N_UCS4:
+		return 4;
+	default:
+		return 1;
+	}
+}
+
+// Decode one character. Returns the number of bytes consumed, 0 if the input ends in the middle of a sequence, -1 if it is illegal.
+static s32 _L10nDecodeChar(s32 code, const u8* src, u32 size, u32& result)
+{
+	switch (code)
+	{
+	case L10N_UTF8:
+	{
+		const u32 lead = src[0];
+
+		if (lead < 0x80)
+		{
+			result = lead;
+			return 1;
+		}
+
+		u32 length, min;
+
+		if (lead >= 0xc2 && lead < 0xe0)
+		{
+			length = 2, min = 0x80, result = lead & 0x1f;
+		}
+		else if (lead >= 0xe0 && lead < 0xf0)
+		{
+			length = 3, min = 0x800, result = lead & 0xf;
+		}
+		else if (lead >= 0xf0 && lead < 0xf5)
+		{
+			length = 4, min = 0x10000, result = lead & 0x7;
+		}
+		else
+		{
+			return -1;
+		}
+
+		for (u32 i = 1; i < length; i++)
+		{
+			if (i >= size)
+			{
+				return 0;
+			}
+
+			if ((src[i] & 0xc0) != 0x80)
+			{
+				return -1;
+			}
+
+			result = result << 6 | (src[i] & 0x3f);
+		}
+
+		if (result < min || result > 0x10ffff || (result >= 0xd800 && result < 0xe000))
+		{
+			return -1;
+		}
+
+		return length;
+	}
+	case L10N_UTF16:
+	case L10N_UCS2:
+	{
+		if (size < 2)
+		{
+			return 0;
+		}
+
+		result = src[0] << 8 | src[1];
+
+		if (result < 0xd800 || result >= 0xe000)
+		{
+			return 2;
+		}
+
+		// Surrogates are only valid as a high/low pair in UTF-16
+		if (code == L10N_UCS2 || result >= 0xdc00)
+		{
+			return -1;
+		}
+
+		if (size < 4)
+		{
+			return 0;
+		}
+
+		const u32 low = src[2] << 8 | src[3];
+
+		if (low < 0xdc00 || low >= 0xe000)
+		{
+			return -1;
+		}
+
+		result = 0x10000 + ((result - 0xd800) << 10) + (low - 0xdc00);
+		return 4;
+	}
+	case L10N_UTF32:
+	case L10N_UCS4:
+	{
+		if (size < 4)
+		{
+			return 0;
+		}
+
+		result = src[0] << 24 | src[1] << 16 | src[2] << 8 | src[3];
+
+		if (result > 0x10ffff || (result >= 0xd800 && result < 0xe000))
+		{
+			return -1;
+		}
+
+		return 4;
+	}
+	case L10N_ISO_8859_1:
+	{
+		result = src[0];
+		return 1;
+	}
+	}
+
+	return -1;
+}
+
+// Encode one character. Returns the number of bytes written, 0 if the character can't be represented.
+static u32 _L10nEncodeChar(s32 code, u32 ch, u8* dst)
+{
+	switch (code)
+	{
+	case L10N_UTF8:
+	{
+		if (ch < 0x80)
+		{
+			dst[0] = ch;
+			return 1;
+		}
+
+		if (ch < 0x800)
+		{
+			dst[0] = 0xc0 | ch >> 6;
+			dst[1] = 0x80 | (ch & 0x3f);
+			return 2;
+		}
+
+		if (ch < 0x10000)
+		{
+			dst[0] = 0xe0 | ch >> 12;
+			dst[1] = 0x80 | (ch >> 6 & 0x3f);
+			dst[2] = 0x80 | (ch & 0x3f);
+			return 3;
+		}
+
+		dst[0] = 0xf0 | ch >> 18;
+		dst[1] = 0x80 | (ch >> 12 & 0x3f);
+		dst[2] = 0x80 | (ch >> 6 & 0x3f);
+		dst[3] = 0x80 | (ch & 0x3f);
+		return 4;
+	}
+	case L10N_UTF16:
+	case L10N_UCS2:
+	{
+		if (ch < 0x10000)
+		{
+			dst[0] = ch >> 8;
+			dst[1] = ch & 0xff;
+			return 2;
+		}
+
+		if (code == L10N_UCS2)
+		{
+			return 0;
+		}
+
+		const u32 high = 0xd800 + ((ch - 0x10000) >> 10);
+		const u32 low = 0xdc00 + ((ch - 0x10000) & 0x3ff);
+		dst[0] = high >> 8;
+		dst[1] = high & 0xff;
+		dst[2] = low >> 8;
+		dst[3] = low & 0xff;
+		return 4;
+	}
+	case L10N_UTF32:
+	case L10N_UCS4:
+	{
+		dst[0] = ch >> 24;
+		dst[1] = ch >> 16 & 0xff;
+		dst[2] = ch >> 8 & 0xff;
+		dst[3] = ch & 0xff;
+		return 4;
+	}
+	case L10N_ISO_8859_1:
+	{
+		if (ch > 0xff)
+		{
+			return 0;
+		}
+
+		dst[0] = ch;
+		return 1;
+	}
+	}
+
+	return 0;
+}
+
+// Load 16 characters if they are all ASCII, as one byte each
+static bool _L10nLoadAscii(s32 code, const u8* src, __m128i& result)
+{
+	switch (_L10nUnitSize(code))
+	{
+	case 1:
+	{
+		result = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+
+		// ISO-8859-1 maps every byte to the same code point, but only ASCII stays single byte in UTF-8
+		return _mm_movemask_epi8(result) == 0;
+	}
+	case 2:
+	{
+		const __m128i mask = _mm_set1_epi16(static_cast<s16>(0x80ff)); // Big endian 0xff80
+		const __m128i v0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+		const __m128i v1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 16));
+		const __m128i bad = _mm_or_si128(_mm_and_si128(v0, mask), _mm_and_si128(v1, mask));
+
+		if (_mm_movemask_epi8(_mm_cmpeq_epi8(bad, _mm_setzero_si128())) != 0xffff)
+		{
+			return false;
+		}
+
+		result = _mm_packus_epi16(_mm_srli_epi16(v0, 8), _mm_srli_epi16(v1, 8));
+		return true;
+	}
+	}
+
+	return false;
+}
+
+// Store 16 ASCII characters
+static void _L10nStoreAscii(s32 code, __m128i v, u8* dst)
+{
+	const __m128i zero = _mm_setzero_si128();
+
+	switch (_L10nUnitSize(code))
+	{
+	case 1:
+	{
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst), v);
+		break;
+	}
+	case 2:
+	{
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_unpacklo_epi8(zero, v));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 16), _mm_unpackhi_epi8(zero, v));
+		break;
+	}
+	case 4:
+	{
+		const __m128i lo = _mm_unpacklo_epi8(zero, v);
+		const __m128i hi = _mm_unpackhi_epi8(zero, v);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_unpacklo_epi16(zero, lo));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 16), _mm_unpackhi_epi16(zero, lo));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 32), _mm_unpacklo_epi16(zero, hi));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 48), _mm_unpackhi_epi16(zero, hi));
+		break;
+	}
+	}
+}
+
+static s32 _ConvertStrNative(s32 src_code, const u8* src, u32 src_len, s32 dst_code, u8* dst, s32* dst_len, bool allowIncomplete)
+{
+	const u32 src_unit = _L10nUnitSize(src_code);
+	const u32 dst_unit = _L10nUnitSize(dst_code);
+	const u32 dst_size = dst ? *dst_len : 0;
+	const bool ascii_path = src_unit <= 2;
+
+	u32 pos = 0;
+	u32 written = 0;
+	u8 buf[4];
+
+	while (pos < src_len)
+	{
+		// Runs of ASCII are widened or narrowed 16 characters at a time
+		if (ascii_path && src_len - pos >= 16 * src_unit && (!dst || dst_size - written >= 16 * dst_unit))
+		{
+			__m128i ascii;
+
+			if (_L10nLoadAscii(src_code, src + pos, ascii))
+			{
+				if (dst)
+				{
+					_L10nStoreAscii(dst_code, ascii, dst + written);
+				}
+
+				pos += 16 * src_unit;
+				written += 16 * dst_unit;
+				continue;
+			}
+		}
+
+		u32 ch;
+		const s32 consumed = _L10nDecodeChar(src_code, src + pos, src_len - pos, ch);
+
+		if (consumed == 0)
+		{
+			if (allowIncomplete)
+			{
+				*dst_len = -1; // TODO: correct value?
+				return ConversionOK;
+			}
+
+			*dst_len = written;
+			return SRCIllegal;
+		}
+
+		const u32 size = consumed > 0 ? _L10nEncodeChar(dst_code, ch, buf) : 0;
+
+		if (size == 0)
+		{
+			*dst_len = written;
+			return SRCIllegal;
+		}
+
+		if (dst)
+		{
+			if (dst_size - written < size)
+			{
+				*dst_len = written;
+				return DSTExhausted;
+			}
+
+			std::memcpy(dst + written, buf, size);
+		}
+
+		pos += consumed;
+		written += size;
+	}
+
+	*dst_len = written;
+	return ConversionOK;
+}
+
+#ifndef _MSC_VER
+
+// Opened iconv descriptors, reused across calls for the same code pair. A descriptor is owned by one caller at a time.
+struct l10n_iconv_cache
+{
+	std::mutex mutex;
+	std::unordered_map<u64, std::vector<iconv_t>> free;
+
+	~l10n_iconv_cache()
+	{
+		for (auto& pair : free)
+		{
+			for (iconv_t ict : pair.second)
+			{
+				iconv_close(ict);
+			}
+		}
+	}
+
+	iconv_t acquire(s32 src_code, HostCode src, s32 dst_code, HostCode dst)
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+
+			auto& list = free[u64{static_cast<u32>(src_code)} << 32 | static_cast<u32>(dst_code)];
+
+			if (!list.empty())
+			{
+				iconv_t ict = list.back();
+				list.pop_back();
+				return ict;
+			}
+		}
+
+		return iconv_open(dst, src);
+	}
+
+	void release(s32 src_code, s32 dst_code, iconv_t ict)
+	{
+		// Reset the shift state before handing it to the next caller
+		iconv(ict, nullptr, nullptr, nullptr, nullptr);
+
+		std::lock_guard<std::mutex> lock(mutex);
+		free[u64{static_cast<u32>(src_code)} << 32 | static_cast<u32>(dst_code)].push_back(ict);
+	}
+};
+
+static l10n_iconv_cache s_iconv_cache;
+
+#endif
+
 s32 _ConvertStr(s32 src_code, const void *src, s32 src_len, s32 dst_code, void *dst, s32 *dst_len, bool allowIncomplete)
 {
+	if (_L10nIsNativeCode(src_code) && _L10nIsNativeCode(dst_code))
+	{
+		return _ConvertStrNative(src_code, static_cast<const u8*>(src), src_len, dst_code, static_cast<u8*>(dst), dst_len, allowIncomplete);
+	}
+
 	HostCode srcCode = 0, dstCode = 0;	//OEM code pages
 	bool src_page_converted = _L10nCodeParse(src_code, srcCode);	//Check if code is in list.
 	bool dst_page_converted = _L10nCodeParse(dst_code, dstCode);
@@ -229,7 +655,13 @@ s32 _ConvertStr(s32 src_code, const void *src, s32 src_len, s32 dst_code, void *
 	return ConversionOK;
 #else
 	s32 retValue = ConversionOK;
-	iconv_t ict = iconv_open(dstCode, srcCode);
+	iconv_t ict = s_iconv_cache.acquire(src_code, srcCode, dst_code, dstCode);
+
+	if (ict == reinterpret_cast<iconv_t>(-1))
+	{
+		return ConverterUnknown;
+	}
+
 	size_t srcLen = src_len;
 	if (dst != NULL)
 	{
@@ -276,7 +708,7 @@ s32 _ConvertStr(s32 src_code, const void *src, s32 src_len, s32 dst_code, void *
 			}
 		}
 	}
-	iconv_close(ict);
+	s_iconv_cache.release(src_code, dst_code, ict);
 	return retValue;
 #endif
 }
@@ -10,6 +10,8 @@
 
 #include <mutex>
 #include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
 
 logs::channel cellSaveData("cellSaveData");
 
@@ -61,6 +63,213 @@ vm::gvar<savedata_context> g_savedata_context;
 
 std::mutex g_savedata_mutex;
 
+// Metadata of the save directories of one user, so listing doesn't parse every PARAM.SFO and walk every directory again.
+// An entry is valid while the directory mtime and the PARAM.SFO mtime and size are unchanged. Persisted in the title cache.
+struct savedata_index
+{
+	static constexpr u32 version = 1;
+
+	struct entry
+	{
+		s64 dir_mtime;
+		s64 sfo_mtime;
+		u64 sfo_size;
+		SaveDataEntry data;
+	};
+
+	// Index file (empty if not persisted)
+	const std::string path;
+
+	std::unordered_map<std::string, entry> entries;
+
+	bool dirty = false;
+
+	explicit savedata_index(std::string path)
+		: path(std::move(path))
+	{
+		fs::file f(this->path);
+
+		if (!f || !load(f))
+		{
+			entries.clear();
+		}
+	}
+
+	static void write_string(const fs::file& f, const std::string& str)
+	{
+		f.write(::size32(str));
+		f.write(str);
+	}
+
+	static bool read_string(const fs::file& f, std::string& str)
+	{
+		u32 size;
+		return f.read(size) && size <= f.size() - f.pos() && f.read(str, size);
+	}
+
+	bool load(const fs::file& f)
+	{
+		u32 file_version, count;
+
+		if (!f.read(file_version) || file_version != version || !f.read(count))
+		{
+			return false;
+		}
+
+		for (u32 i = 0; i < count; i++)
+		{
+			std::string name;
+			entry e{};
+
+			if (!read_string(f, name) || !f.read(e.dir_mtime) || !f.read(e.sfo_mtime) || !f.read(e.sfo_size) ||
+				!read_string(f, e.data.dirName) || !read_string(f, e.data.listParam) || !read_string(f, e.data.title) ||
+				!read_string(f, e.data.subtitle) || !read_string(f, e.data.details) || !f.read(e.data.size))
+			{
+				return false;
+			}
+
+			entries.emplace(std::move(name), std::move(e));
+		}
+
+		return true;
+	}
+
+	void save()
+	{
+		if (!dirty || path.empty())
+		{
+			return;
+		}
+
+		fs::file f(path, fs::rewrite);
+
+		if (!f)
+		{
+			cellSaveData.error("Failed to write the savedata index (%s)", path);
+			return;
+		}
+
+		f.write(version);
+		f.write(::size32(entries));
+
+		for (const auto& pair : entries)
+		{
+			const entry& e = pair.second;
+			write_string(f, pair.first);
+			f.write(e.dir_mtime);
+			f.write(e.sfo_mtime);
+			f.write(e.sfo_size);
+			write_string(f, e.data.dirName);
+			write_string(f, e.data.listParam);
+			write_string(f, e.data.title);
+			write_string(f, e.data.subtitle);
+			write_string(f, e.data.details);
+			f.write(e.data.size);
+		}
+
+		dirty = false;
+	}
+
+	// Get the metadata of a save directory, from the index if it's still valid. Returns false if PARAM.SFO is missing or empty.
+	bool get(const std::string& base_dir, const fs::dir_entry& dir, SaveDataEntry& result)
+	{
+		const std::string dir_path = base_dir + dir.name;
+
+		fs::stat_t sfo_info;
+
+		if (!fs::stat(dir_path + "/PARAM.SFO", sfo_info))
+		{
+			return false;
+		}
+
+		auto found = entries.find(dir.name);
+
+		if (found == entries.end() || found->second.dir_mtime != dir.mtime || found->second.sfo_mtime != sfo_info.mtime || found->second.sfo_size != sfo_info.size)
+		{
+			// PSF parameters
+			const psf::registry psf = psf::load_object(fs::file(dir_path + "/PARAM.SFO"));
+
+			if (psf.empty())
+			{
+				return false;
+			}
+
+			entry e{dir.mtime, sfo_info.mtime, sfo_info.size};
+			e.data.dirName = psf.at("SAVEDATA_DIRECTORY").as_string();
+			e.data.listParam = psf.at("SAVEDATA_LIST_PARAM").as_string();
+			e.data.title = psf.at("TITLE").as_string();
+			e.data.subtitle = psf.at("SUB_TITLE").as_string();
+			e.data.details = psf.at("DETAIL").as_string();
+
+			e.data.size = 0;
+
+			for (const auto entry2 : fs::dir(dir_path))
+			{
+				e.data.size += entry2.size;
+			}
+
+			found = entries.find(dir.name);
+
+			if (found == entries.end())
+			{
+				found = entries.emplace(dir.name, std::move(e)).first;
+			}
+			else
+			{
+				found->second = std::move(e);
+			}
+
+			dirty = true;
+		}
+
+		result = found->second.data;
+		result.atime = dir.atime;
+		result.mtime = dir.mtime;
+		result.ctime = dir.ctime;
+		result.isNew = false;
+		return true;
+	}
+
+	// Drop the entries of directories which no longer exist
+	void retain(const std::unordered_set<std::string>& names)
+	{
+		for (auto it = entries.begin(); it != entries.end();)
+		{
+			if (!names.count(it->first))
+			{
+				it = entries.erase(it);
+				dirty = true;
+				continue;
+			}
+
+			it++;
+		}
+	}
+
+	void erase(const std::string& name)
+	{
+		dirty |= entries.erase(name) != 0;
+	}
+};
+
+// Indices by index file path (protected by g_savedata_mutex)
+static std::unordered_map<std::string, std::unique_ptr<savedata_index>> g_savedata_indices;
+
+static savedata_index& get_savedata_index(u32 userId)
+{
+	const std::string& cache_path = Emu.GetCachePath();
+	const std::string path = cache_path.empty() ? "" : cache_path + fmt::format("savedata_%08u.idx", userId ? userId : 1u);
+
+	auto& index = g_savedata_indices[path];
+
+	if (!index)
+	{
+		index = std::make_unique<savedata_index>(path);
+	}
+
+	return *index;
+}
+
 static NEVER_INLINE s32 savedata_op(ppu_thread& ppu, u32 operation, u32 version, vm::cptr<char> dirName,
 	u32 errDialog, PSetList setList, PSetBuf setBuf, PFuncList funcList, PFuncFixed funcFixed, PFuncStat funcStat,
 	PFuncFile funcFile, u32 container, u32 unknown, vm::ptr<void> userdata, u32 userId, PFuncDone funcDone)
@@ -105,6 +314,9 @@ static NEVER_INLINE s32 savedata_op(ppu_thread& ppu, u32 operation, u32 version,
 
 		const auto prefix_list = fmt::split(setList->dirNamePrefix.get_ptr(), {"|"});
 
+		auto& index = get_savedata_index(userId);
+		std::unordered_set<std::string> dir_names;
+
 		// get the saves matching the supplied prefix
 		for (auto&& entry : fs::dir(base_dir))
 		{
@@ -114,6 +326,7 @@ static NEVER_INLINE s32 savedata_op(ppu_thread& ppu, u32 operation, u32 version,
 			}
 
 			entry.name = vfs::unescape(entry.name);
+			dir_names.emplace(entry.name);
 
 			for (const auto& prefix : prefix_list)
 			{
@@ -125,35 +338,15 @@ static NEVER_INLINE s32 savedata_op(ppu_thread& ppu, u32 operation, u32 version,
 					{
 						listGet->dirListNum++; // number of directories in list
 
-						// PSF parameters
-						const psf::registry psf = psf::load_object(fs::file(base_dir + entry.name + "/PARAM.SFO"));
-
-						if (psf.empty())
-						{
-							break;
-						}
-
+						// Icons are only loaded when the list is displayed
 						SaveDataEntry save_entry2;
-						save_entry2.dirName = psf.at("SAVEDATA_DIRECTORY").as_string();
-						save_entry2.listParam = psf.at("SAVEDATA_LIST_PARAM").as_string();
-						save_entry2.title = psf.at("TITLE").as_string();
-						save_entry2.subtitle = psf.at("SUB_TITLE").as_string();
-						save_entry2.details = psf.at("DETAIL").as_string();
 
-						save_entry2.size = 0;
-
-						for (const auto entry2 : fs::dir(base_dir + entry.name))
+						if (!index.get(base_dir, entry, save_entry2))
 						{
-							save_entry2.size += entry2.size;
+							break;
 						}
 
-						save_entry2.atime = entry.atime;
-						save_entry2.mtime = entry.mtime;
-						save_entry2.ctime = entry.ctime;
-						if (fs::file icon{base_dir + entry.name + "/ICON0.PNG"})
-							save_entry2.iconBuf = icon.to_vector<uchar>();
-						save_entry2.isNew = false;
-						save_entries.emplace_back(save_entry2);
+						save_entries.emplace_back(std::move(save_entry2));
 					}
 
 					break;
@@ -161,6 +354,9 @@ static NEVER_INLINE s32 savedata_op(ppu_thread& ppu, u32 operation, u32 version,
 			}
 		}
 
+		index.retain(dir_names);
+		index.save();
+
 		// Sort the entries
 		{
 			const u32 order = setList->sortOrder;
@@ -347,6 +543,15 @@ static NEVER_INLINE s32 savedata_op(ppu_thread& ppu, u32 operation, u32 version,
 			funcDone(ppu, result, doneGet);
 		};
 
+		if (funcList)
+		{
+			for (auto& entry : save_entries)
+			{
+				if (fs::file icon{base_dir + entry.dirName + "/ICON0.PNG"})
+					entry.iconBuf = icon.to_vector<uchar>();
+			}
+		}
+
 		while (funcList)
 		{
 			// Display Save Data List asynchronously in the GUI thread.
@@ -665,6 +870,13 @@ static NEVER_INLINE s32 savedata_op(ppu_thread& ppu, u32 operation, u32 version,
 		return CELL_SAVEDATA_ERROR_ACCESS_ERROR;
 	}
 
+	// The save files may change from here on, drop the listing metadata
+	{
+		auto& index = get_savedata_index(userId);
+		index.erase(save_entry.dirName);
+		index.save();
+	}
+
 	// Enter the loop where the save files are read/created/deleted
 
 	fileGet->excSize = 0;
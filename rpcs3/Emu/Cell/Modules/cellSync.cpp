@@ -8,6 +8,42 @@
 
 logs::channel cellSync("cellSync");
 
+// Longest sleep on a control word before it's checked again (guest stores don't always notify)
+constexpr u64 sync_wait_timeout = 100;
+
+// Sleep until the control word differs from old, instead of spinning on it
+template <typename T>
+static inline void sync_wait(ppu_thread& ppu, atomic_t<T>& ctrl, const T& old)
+{
+	vm::reservation_wait(vm::get_addr(&ctrl), old, sync_wait_timeout);
+	ppu.test_state();
+}
+
+// Retry an atomic operation until it succeeds, sleeping between attempts
+template <typename T, typename F, typename... Args>
+static inline void sync_wait_op(ppu_thread& ppu, atomic_t<T>& ctrl, F&& func, Args&&... args)
+{
+	while (true)
+	{
+		// Loaded before the attempt, so a change after a failed attempt isn't missed
+		const T old = ctrl.load();
+
+		if (ctrl.atomic_op(func, args...))
+		{
+			return;
+		}
+
+		sync_wait(ppu, ctrl, old);
+	}
+}
+
+// Wake threads sleeping on the control word
+template <typename T>
+static inline void sync_notify(atomic_t<T>& ctrl)
+{
+	vm::reservation_notify(vm::get_addr(&ctrl), sizeof(T));
+}
+
 template<>
 void fmt_class_string<CellSyncError>::format(std::string& out, u64 arg)
 {
@@ -77,9 +113,9 @@ error_code cellSyncMutexLock(ppu_thread& ppu, vm::ptr<CellSyncMutex> mutex)
 	const auto order = mutex->ctrl.atomic_op(&CellSyncMutex::lock_begin);
 
 	// Wait until rel value is equal to old acq value
-	while (mutex->ctrl.load().rel != order)
+	for (auto ctrl = mutex->ctrl.load(); ctrl.rel != order; ctrl = mutex->ctrl.load())
 	{
-		ppu.test_state();
+		sync_wait(ppu, mutex->ctrl, ctrl);
 	}
 
 	_mm_mfence();
@@ -124,6 +160,7 @@ error_code cellSyncMutexUnlock(vm::ptr<CellSyncMutex> mutex)
 	}
 
 	mutex->ctrl.atomic_op(&CellSyncMutex::unlock);
+	sync_notify(mutex->ctrl);
 
 	return CELL_OK;
 }
@@ -167,10 +204,8 @@ error_code cellSyncBarrierNotify(ppu_thread& ppu, vm::ptr<CellSyncBarrier> barri
 		return CELL_SYNC_ERROR_ALIGN;
 	}
 
-	while (!barrier->ctrl.atomic_op(&CellSyncBarrier::try_notify))
-	{
-		ppu.test_state();
-	}
+	sync_wait_op(ppu, barrier->ctrl, &CellSyncBarrier::try_notify);
+	sync_notify(barrier->ctrl);
 
 	return CELL_OK;
 }
@@ -196,6 +231,8 @@ error_code cellSyncBarrierTryNotify(vm::ptr<CellSyncBarrier> barrier)
 		return not_an_error(CELL_SYNC_ERROR_BUSY);
 	}
 
+	sync_notify(barrier->ctrl);
+
 	return CELL_OK;
 }
 
@@ -215,10 +252,8 @@ error_code cellSyncBarrierWait(ppu_thread& ppu, vm::ptr<CellSyncBarrier> barrier
 
 	_mm_mfence();
 
-	while (!barrier->ctrl.atomic_op(&CellSyncBarrier::try_wait))
-	{
-		ppu.test_state();
-	}
+	sync_wait_op(ppu, barrier->ctrl, &CellSyncBarrier::try_wait);
+	sync_notify(barrier->ctrl);
 
 	return CELL_OK;
 }
@@ -244,6 +279,8 @@ error_code cellSyncBarrierTryWait(vm::ptr<CellSyncBarrier> barrier)
 		return not_an_error(CELL_SYNC_ERROR_BUSY);
 	}
 
+	sync_notify(barrier->ctrl);
+
 	return CELL_OK;
 }
 
@@ -291,10 +328,7 @@ error_code cellSyncRwmRead(ppu_thread& ppu, vm::ptr<CellSyncRwm> rwm, vm::ptr<vo
 	}
 
 	// wait until `writers` is zero, increase `readers`
-	while (!rwm->ctrl.atomic_op(&CellSyncRwm::try_read_begin))
-	{
-		ppu.test_state();
-	}
+	sync_wait_op(ppu, rwm->ctrl, &CellSyncRwm::try_read_begin);
 
 	// copy data to buffer
 	std::memcpy(buffer.get_ptr(), rwm->buffer.get_ptr(), rwm->size);
@@ -305,6 +339,8 @@ error_code cellSyncRwmRead(ppu_thread& ppu, vm::ptr<CellSyncRwm> rwm, vm::ptr<vo
 		return CELL_SYNC_ERROR_ABORT;
 	}
 
+	sync_notify(rwm->ctrl);
+
 	return CELL_OK;
 }
 
@@ -337,6 +373,8 @@ error_code cellSyncRwmTryRead(vm::ptr<CellSyncRwm> rwm, vm::ptr<void> buffer)
 		return CELL_SYNC_ERROR_ABORT;
 	}
 
+	sync_notify(rwm->ctrl);
+
 	return CELL_OK;
 }
 
@@ -355,15 +393,12 @@ error_code cellSyncRwmWrite(ppu_thread& ppu, vm::ptr<CellSyncRwm> rwm, vm::cptr<
 	}
 
 	// wait until `writers` is zero, set to 1
-	while (!rwm->ctrl.atomic_op(&CellSyncRwm::try_write_begin))
-	{
-		ppu.test_state();
-	}
+	sync_wait_op(ppu, rwm->ctrl, &CellSyncRwm::try_write_begin);
 
 	// wait until `readers` is zero
-	while (rwm->ctrl.load().readers != 0)
+	for (auto ctrl = rwm->ctrl.load(); ctrl.readers != 0; ctrl = rwm->ctrl.load())
 	{
-		ppu.test_state();
+		sync_wait(ppu, rwm->ctrl, ctrl);
 	}
 
 	// copy data from buffer
@@ -371,6 +406,7 @@ error_code cellSyncRwmWrite(ppu_thread& ppu, vm::ptr<CellSyncRwm> rwm, vm::cptr<
 
 	// sync and clear `readers` and `writers`
 	rwm->ctrl.exchange({ 0, 0 });
+	sync_notify(rwm->ctrl);
 
 	return CELL_OK;
 }
@@ -400,6 +436,7 @@ error_code cellSyncRwmTryWrite(vm::ptr<CellSyncRwm> rwm, vm::cptr<void> buffer)
 
 	// sync and clear `readers` and `writers`
 	rwm->ctrl.exchange({ 0, 0 });
+	sync_notify(rwm->ctrl);
 
 	return CELL_OK;
 }
@@ -457,15 +494,13 @@ error_code cellSyncQueuePush(ppu_thread& ppu, vm::ptr<CellSyncQueue> queue, vm::
 
 	u32 position;
 
-	while (!queue->ctrl.atomic_op(&CellSyncQueue::try_push_begin, depth, &position))
-	{
-		ppu.test_state();
-	}
+	sync_wait_op(ppu, queue->ctrl, &CellSyncQueue::try_push_begin, depth, &position);
 
 	// copy data from the buffer at the position
 	std::memcpy(&queue->buffer[position * queue->size], buffer.get_ptr(), queue->size);
 
 	queue->ctrl.atomic_op(&CellSyncQueue::push_end);
+	sync_notify(queue->ctrl);
 
 	return CELL_OK;
 }
@@ -497,6 +532,7 @@ error_code cellSyncQueueTryPush(vm::ptr<CellSyncQueue> queue, vm::cptr<void> buf
 	std::memcpy(&queue->buffer[position * queue->size], buffer.get_ptr(), queue->size);
 
 	queue->ctrl.atomic_op(&CellSyncQueue::push_end);
+	sync_notify(queue->ctrl);
 
 	return CELL_OK;
 }
@@ -519,15 +555,13 @@ error_code cellSyncQueuePop(ppu_thread& ppu, vm::ptr<CellSyncQueue> queue, vm::p
 	
 	u32 position;
 
-	while (!queue->ctrl.atomic_op(&CellSyncQueue::try_pop_begin, depth, &position))
-	{
-		ppu.test_state();
-	}
+	sync_wait_op(ppu, queue->ctrl, &CellSyncQueue::try_pop_begin, depth, &position);
 
 	// copy data at the position to the buffer
 	std::memcpy(buffer.get_ptr(), &queue->buffer[position % depth * queue->size], queue->size);
 
 	queue->ctrl.atomic_op(&CellSyncQueue::pop_end);
+	sync_notify(queue->ctrl);
 
 	return CELL_OK;
 }
@@ -559,6 +593,7 @@ error_code cellSyncQueueTryPop(vm::ptr<CellSyncQueue> queue, vm::ptr<void> buffe
 	std::memcpy(buffer.get_ptr(), &queue->buffer[position % depth * queue->size], queue->size);
 
 	queue->ctrl.atomic_op(&CellSyncQueue::pop_end);
+	sync_notify(queue->ctrl);
 
 	return CELL_OK;
 }
@@ -581,15 +616,13 @@ error_code cellSyncQueuePeek(ppu_thread& ppu, vm::ptr<CellSyncQueue> queue, vm::
 
 	u32 position;
 
-	while (!queue->ctrl.atomic_op(&CellSyncQueue::try_peek_begin, depth, &position))
-	{
-		ppu.test_state();
-	}
+	sync_wait_op(ppu, queue->ctrl, &CellSyncQueue::try_peek_begin, depth, &position);
 
 	// copy data at the position to the buffer
 	std::memcpy(buffer.get_ptr(), &queue->buffer[position % depth * queue->size], queue->size);
 
 	queue->ctrl.atomic_op(&CellSyncQueue::pop_end);
+	sync_notify(queue->ctrl);
 
 	return CELL_OK;
 }
@@ -621,6 +654,7 @@ error_code cellSyncQueueTryPeek(vm::ptr<CellSyncQueue> queue, vm::ptr<void> buff
 	std::memcpy(buffer.get_ptr(), &queue->buffer[position % depth * queue->size], queue->size);
 
 	queue->ctrl.atomic_op(&CellSyncQueue::pop_end);
+	sync_notify(queue->ctrl);
 
 	return CELL_OK;
 }
@@ -660,17 +694,12 @@ error_code cellSyncQueueClear(ppu_thread& ppu, vm::ptr<CellSyncQueue> queue)
 
 	const u32 depth = queue->check_depth();
 
-	while (!queue->ctrl.atomic_op(&CellSyncQueue::try_clear_begin_1))
-	{
-		ppu.test_state();
-	}
+	sync_wait_op(ppu, queue->ctrl, &CellSyncQueue::try_clear_begin_1);
 
-	while (!queue->ctrl.atomic_op(&CellSyncQueue::try_clear_begin_2))
-	{
-		ppu.test_state();
-	}
+	sync_wait_op(ppu, queue->ctrl, &CellSyncQueue::try_clear_begin_2);
 
 	queue->ctrl.exchange({ 0, 0 });
+	sync_notify(queue->ctrl);
 
 	return CELL_OK;
 }
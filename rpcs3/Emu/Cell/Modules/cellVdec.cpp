@@ -10,14 +10,15 @@ extern "C"
 {
 #include "libavcodec/avcodec.h"
 #include "libavutil/imgutils.h"
-#include "libswscale/swscale.h"
 }
 
 #include "cellPamf.h"
 #include "cellVdec.h"
+#include "Utilities/color_convert.h"
 
 #include <mutex>
 #include <queue>
+#include <vector>
 #include <cmath>
 
 std::mutex g_mutex_avcodec_open2;
@@ -48,7 +49,9 @@ struct vdec_frame
 		}
 	};
 
-	std::unique_ptr<AVFrame, frame_dtor> avf;
+	using frame_ptr = std::unique_ptr<AVFrame, frame_dtor>;
+
+	frame_ptr avf;
 	u64 dts;
 	u64 pts;
 	u64 userdata;
@@ -64,7 +67,6 @@ struct vdec_thread : ppu_thread
 {
 	AVCodec* codec{};
 	AVCodecContext* ctx{};
-	SwsContext* sws{};
 
 	const s32 type;
 	const u32 profile;
@@ -83,6 +85,10 @@ struct vdec_thread : ppu_thread
 	std::queue<vdec_frame> out;
 	u32 max_frames = 60;
 
+	// Released AVFrame structures kept for reuse (protected by mutex)
+	std::vector<vdec_frame::frame_ptr> frame_pool;
+	static constexpr u32 max_pooled_frames = 8;
+
 	atomic_t<u32> au_count{0};
 
 	vdec_thread(s32 type, u32 profile, u32 addr, u32 size, vm::ptr<CellVdecCbMsg> func, u32 arg, u32 prio, u32 stack)
@@ -131,6 +137,10 @@ struct vdec_thread : ppu_thread
 			fmt::throw_exception("avcodec_alloc_context3() failed (type=0x%x)" HERE, type);
 		}
 
+		// Frame threading decodes several pictures in flight, which delays output by (thread_count - 1) pictures
+		ctx->thread_count = g_cfg.core.video_decoder_threads;
+		ctx->thread_type = FF_THREAD_FRAME | FF_THREAD_SLICE;
+
 		AVDictionary* opts{};
 		av_dict_set(&opts, "refcounted_frames", "1", 0);
 
@@ -148,7 +158,6 @@ struct vdec_thread : ppu_thread
 	{
 		avcodec_close(ctx);
 		avcodec_free_context(&ctx);
-		sws_freeContext(sws);
 	}
 
 	virtual std::string dump() const override
@@ -157,6 +166,48 @@ struct vdec_thread : ppu_thread
 		return ppu_thread::dump();
 	}
 
+	// Get an empty frame, reusing a released one if possible
+	vdec_frame::frame_ptr alloc_frame()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+
+			if (!frame_pool.empty())
+			{
+				auto result = std::move(frame_pool.back());
+				frame_pool.pop_back();
+				return result;
+			}
+		}
+
+		vdec_frame::frame_ptr result(av_frame_alloc());
+
+		if (!result)
+		{
+			fmt::throw_exception("av_frame_alloc() failed" HERE);
+		}
+
+		return result;
+	}
+
+	// Release picture data back to the codec and keep the frame structure for reuse
+	void recycle_frame(vdec_frame::frame_ptr frame)
+	{
+		if (!frame)
+		{
+			return;
+		}
+
+		av_frame_unref(frame.get());
+
+		std::lock_guard<std::mutex> lock(mutex);
+
+		if (frame_pool.size() < max_pooled_frames)
+		{
+			frame_pool.emplace_back(std::move(frame));
+		}
+	}
+
 	virtual void cpu_task() override
 	{
 		while (cmd64 cmd = cmd_wait())
@@ -219,6 +270,7 @@ struct vdec_thread : ppu_thread
 				{
 					cmd_pop();
 
+					// Empty packet: drain pictures still held by the decoder (reordering, frame threads)
 					packet.pts = AV_NOPTS_VALUE;
 					packet.dts = AV_NOPTS_VALUE;
 					cellVdec.trace("End sequence...");
@@ -226,18 +278,8 @@ struct vdec_thread : ppu_thread
 
 				while (max_frames)
 				{
-					if (vcmd == vdec_cmd::end_seq)
-					{
-						break;
-					}
-
 					vdec_frame frame;
-					frame.avf.reset(av_frame_alloc());
-
-					if (!frame.avf)
-					{
-						fmt::throw_exception("av_frame_alloc() failed" HERE);
-					}
+					frame.avf = alloc_frame();
 
 					int got_picture = 0;
 
@@ -250,6 +292,7 @@ struct vdec_thread : ppu_thread
 
 					if (got_picture == 0)
 					{
+						recycle_frame(std::move(frame.avf));
 						break;
 					}
 
@@ -600,75 +643,65 @@ s32 cellVdecGetPicture(u32 handle, vm::cptr<CellVdecPicFormat> format, vm::ptr<u
 		const int w = frame->width;
 		const int h = frame->height;
 
-		AVPixelFormat out_f = AV_PIX_FMT_YUV420P;
-
-		std::unique_ptr<u8[]> alpha_plane;
-
-		switch (const u32 type = format->formatType)
-		{
-		case CELL_VDEC_PICFMT_ARGB32_ILV: out_f = AV_PIX_FMT_ARGB; alpha_plane.reset(new u8[w * h]); break;
-		case CELL_VDEC_PICFMT_RGBA32_ILV: out_f = AV_PIX_FMT_RGBA; alpha_plane.reset(new u8[w * h]); break;
-		case CELL_VDEC_PICFMT_UYVY422_ILV: out_f = AV_PIX_FMT_UYVY422; break;
-		case CELL_VDEC_PICFMT_YUV420_PLANAR: out_f = AV_PIX_FMT_YUV420P; break;
-
-		default:
+		if (frame->format != AV_PIX_FMT_YUV420P)
 		{
-			fmt::throw_exception("Unknown formatType (%d)" HERE, type);
-		}
+			fmt::throw_exception("Unknown format (%d)" HERE, frame->format);
 		}
 
-		// TODO: color matrix
 		if (format->colorMatrixType & ~1)
 		{
 			fmt::throw_exception("Unknown colorMatrixType (%d)" HERE, format->colorMatrixType);
 		}
 
-		if (alpha_plane)
-		{
-			std::memset(alpha_plane.get(), format->alpha, w * h);
-		}
+		color_convert::yuv420_image src;
+		src.y = frame->data[0];
+		src.u = frame->data[1];
+		src.v = frame->data[2];
+		src.y_pitch = frame->linesize[0];
+		src.uv_pitch = frame->linesize[1];
+		src.width = w;
+		src.height = h;
 
-		AVPixelFormat in_f = AV_PIX_FMT_YUV420P;
+		const auto matrix = format->colorMatrixType == CELL_VDEC_COLOR_MATRIX_TYPE_BT709 ? color_convert::yuv_matrix::bt709 : color_convert::yuv_matrix::bt601;
 
-		switch (frame->format)
+		switch (const u32 type = format->formatType)
 		{
-		case AV_PIX_FMT_YUV420P: in_f = alpha_plane ? AV_PIX_FMT_YUVA420P : AV_PIX_FMT_YUV420P; break;
-
-		default:
+		case CELL_VDEC_PICFMT_ARGB32_ILV:
 		{
-			fmt::throw_exception("Unknown format (%d)" HERE, frame->format);
+			color_convert::yuv420_to_rgb32(src, outBuff.get_ptr(), w * 4, color_convert::rgb32_layout::argb, format->alpha, matrix);
+			break;
+		}
+		case CELL_VDEC_PICFMT_RGBA32_ILV:
+		{
+			color_convert::yuv420_to_rgb32(src, outBuff.get_ptr(), w * 4, color_convert::rgb32_layout::rgba, format->alpha, matrix);
+			break;
 		}
+		case CELL_VDEC_PICFMT_YUV420_PLANAR:
+		{
+			// Same layout as the decoder output, only the line padding differs
+			u8* const out_y = outBuff.get_ptr();
+			u8* const out_u = out_y + w * h;
+			u8* const out_v = out_y + w * h * 5 / 4;
+
+			av_image_copy_plane(out_y, w, frame->data[0], frame->linesize[0], w, h);
+			av_image_copy_plane(out_u, w / 2, frame->data[1], frame->linesize[1], w / 2, h / 2);
+			av_image_copy_plane(out_v, w / 2, frame->data[2], frame->linesize[2], w / 2, h / 2);
+			break;
 		}
-
-		vdec->sws = sws_getCachedContext(vdec->sws, w, h, in_f, w, h, out_f, SWS_POINT, NULL, NULL, NULL);
-
-		u8* in_data[4] = { frame->data[0], frame->data[1], frame->data[2], alpha_plane.get() };
-		int in_line[4] = { frame->linesize[0], frame->linesize[1], frame->linesize[2], w * 1 };
-		u8* out_data[4] = { outBuff.get_ptr() };
-		int out_line[4] = { w * 4 };
-
-		if (!alpha_plane)
+		case CELL_VDEC_PICFMT_UYVY422_ILV:
 		{
-			out_data[1] = out_data[0] + w * h;
-			out_data[2] = out_data[0] + w * h * 5 / 4;
-			out_line[0] = w;
-			out_line[1] = w / 2;
-			out_line[2] = w / 2;
+			color_convert::yuv420_to_uyvy422(src, outBuff.get_ptr(), w * 2);
+			break;
+		}
+		default:
+		{
+			fmt::throw_exception("Unknown formatType (%d)" HERE, type);
+		}
 		}
-
-		sws_scale(vdec->sws, in_data, in_line, 0, h, out_data, out_line);
-
-		//const u32 buf_size = align(av_image_get_buffer_size(vdec->ctx->pix_fmt, vdec->ctx->width, vdec->ctx->height, 1), 128);
-
-		//// TODO: zero padding bytes
-
-		//int err = av_image_copy_to_buffer(outBuff.get_ptr(), buf_size, frame->data, frame->linesize, vdec->ctx->pix_fmt, frame->width, frame->height, 1);
-		//if (err < 0)
-		//{
-		//	cellVdec.Fatal("cellVdecGetPicture: av_image_copy_to_buffer failed (err=0x%x)", err);
-		//}
 	}
 
+	vdec->recycle_frame(std::move(frame.avf));
+
 	return CELL_OK;
 }
 
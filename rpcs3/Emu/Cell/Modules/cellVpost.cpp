@@ -9,6 +9,7 @@ extern "C"
 }
 
 #include "cellVpost.h"
+#include "Utilities/color_convert.h"
 
 logs::channel cellVpost("cellVpost");
 
@@ -113,17 +114,42 @@ s32 cellVpostExec(u32 handle, vm::cptr<u8> inPicBuff, vm::cptr<CellVpostCtrlPara
 	picInfo->reserved1 = 0;
 	picInfo->reserved2 = 0;
 
-	//u64 stamp0 = get_system_time();
+	color_convert::yuv420_image src;
+	src.y = inPicBuff.get_ptr();
+	src.u = src.y + w * h;
+	src.v = src.y + w * h * 5 / 4;
+	src.y_pitch = w;
+	src.uv_pitch = w / 2;
+	src.width = w;
+	src.height = h;
+
+	const auto matrix = ctrlParam->inColorMatrix == CELL_VPOST_COLOR_MATRIX_BT709 ? color_convert::yuv_matrix::bt709 : color_convert::yuv_matrix::bt601;
+
+	if (ow == w && oh == h)
+	{
+		color_convert::yuv420_to_rgb32(src, outPicBuff.get_ptr(), ow * 4, color_convert::rgb32_layout::rgba, ctrlParam->outAlpha, matrix);
+		return CELL_OK;
+	}
+
+	if ((ow == w * 2 && oh == h * 2) || (ow * 2 == w && oh * 2 == h))
+	{
+		// Convert at the input size, then scale by the exact ratio
+		vpost->rgba.resize(w * h * 4);
+		color_convert::yuv420_to_rgb32(src, vpost->rgba.data(), w * 4, color_convert::rgb32_layout::rgba, ctrlParam->outAlpha, matrix);
+
+		if (color_convert::scale_rgb32_bilinear(vpost->rgba.data(), w, h, w * 4, outPicBuff.get_ptr(), ow, oh, ow * 4))
+		{
+			return CELL_OK;
+		}
+	}
+
+	// Other scaling ratios go through swscale, with a constant alpha plane
 	std::unique_ptr<u8[]> pA(new u8[w*h]);
 
 	memset(pA.get(), ctrlParam->outAlpha, w*h);
 
-	//u64 stamp1 = get_system_time();
-
 	vpost->sws = sws_getCachedContext(vpost->sws, w, h, AV_PIX_FMT_YUVA420P, ow, oh, AV_PIX_FMT_RGBA, SWS_BILINEAR, NULL, NULL, NULL);
 
-	//u64 stamp2 = get_system_time();
-
 	const u8* in_data[4] = { &inPicBuff[0], &inPicBuff[w * h], &inPicBuff[w * h * 5 / 4], pA.get() };
 	int in_line[4] = { w, w/2, w/2, w };
 	u8* out_data[4] = { outPicBuff.get_ptr(), NULL, NULL, NULL };
@@ -131,8 +157,6 @@ s32 cellVpostExec(u32 handle, vm::cptr<u8> inPicBuff, vm::cptr<CellVpostCtrlPara
 
 	sws_scale(vpost->sws, in_data, in_line, 0, h, out_data, out_line);
 
-	//ConLog.Write("cellVpostExec() perf (access=%d, getContext=%d, scale=%d, finalize=%d)",
-		//stamp1 - stamp0, stamp2 - stamp1, stamp3 - stamp2, get_system_time() - stamp3);
 	return CELL_OK;
 }
 
@@ -334,6 +334,9 @@ public:
 
 	SwsContext* sws{};
 
+	// RGBA picture at the input size, used when scaling by exactly 2x or 0.5x
+	std::vector<u8> rgba;
+
 	VpostInstance(bool rgba)
 		: to_rgba(rgba)
 	{
@@ -0,0 +1,170 @@
+#include "stdafx.h"
+#include "image_decoder.h"
+#include "Utilities/worker_pool.h"
+
+// STB_IMAGE_IMPLEMENTATION is already defined in stb_image.cpp
+#include <stb_image.h>
+
+namespace image_decoder
+{
+	// Output smaller than this is converted on the calling thread
+	constexpr u32 parallel_write_threshold = 1 << 20;
+
+	void image::pixels_deleter::operator()(u8* pixels) const
+	{
+		stbi_image_free(pixels);
+	}
+
+	static int file_read(void* user, char* data, int size)
+	{
+		return static_cast<int>(static_cast<const fs::file*>(user)->read(data, size));
+	}
+
+	static void file_skip(void* user, int n)
+	{
+		static_cast<const fs::file*>(user)->seek(n, fs::seek_cur);
+	}
+
+	static int file_eof(void* user)
+	{
+		const auto file = static_cast<const fs::file*>(user);
+		return file->pos() >= file->size();
+	}
+
+	static const stbi_io_callbacks s_file_callbacks{ file_read, file_skip, file_eof };
+
+	bool get_info(const source& src, u32& width, u32& height, u32& components)
+	{
+		int x, y, comp;
+		int result;
+
+		if (src.file)
+		{
+			src.file->seek(0);
+			result = stbi_info_from_callbacks(&s_file_callbacks, const_cast<fs::file*>(src.file), &x, &y, &comp);
+		}
+		else
+		{
+			result = stbi_info_from_memory(src.buffer, ::narrow<int>(src.size, "size" HERE), &x, &y, &comp);
+		}
+
+		if (!result)
+		{
+			return false;
+		}
+
+		width = x;
+		height = y;
+		components = comp;
+		return true;
+	}
+
+	bool decode(const source& src, pixel_layout layout, image& out)
+	{
+		const int req_comp = layout == pixel_layout::rgb ? 3 : 4;
+		int x, y, comp;
+		u8* pixels;
+
+		if (src.file)
+		{
+			src.file->seek(0);
+			pixels = stbi_load_from_callbacks(&s_file_callbacks, const_cast<fs::file*>(src.file), &x, &y, &comp, req_comp);
+		}
+		else
+		{
+			pixels = stbi_load_from_memory(src.buffer, ::narrow<int>(src.size, "size" HERE), &x, &y, &comp, req_comp);
+		}
+
+		if (!pixels)
+		{
+			return false;
+		}
+
+		out.pixels.reset(pixels);
+		out.width = x;
+		out.height = y;
+		out.bytes_per_pixel = req_comp;
+		return true;
+	}
+
+	// RGBA -> ARGB byte order, i.e. rotate every texel left by one byte
+	static void write_argb_row(const u8* src, u8* dst, u32 count)
+	{
+		u32 i = 0;
+
+		for (; i + 4 <= count; i += 4)
+		{
+			const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 4));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 4), _mm_or_si128(_mm_slli_epi32(v, 8), _mm_srli_epi32(v, 24)));
+		}
+
+		for (; i < count; i++)
+		{
+			u32 v;
+			std::memcpy(&v, src + i * 4, 4);
+			v = (v << 8) | (v >> 24);
+			std::memcpy(dst + i * 4, &v, 4);
+		}
+	}
+
+	u32 write(const image& img, pixel_layout layout, u8* dst, u32 dst_pitch, bool flip)
+	{
+		const u32 src_pitch = img.width * img.bytes_per_pixel;
+
+		// No pitch given: tightly packed output
+		if (!dst_pitch)
+		{
+			dst_pitch = src_pitch;
+		}
+
+		const u32 line_size = std::min(dst_pitch, src_pitch);
+
+		if (!line_size)
+		{
+			return 0;
+		}
+
+		const auto write_rows = [&](u32 row_begin, u32 row_end)
+		{
+			for (u32 row = row_begin; row < row_end; row++)
+			{
+				const u8* src = img.pixels.get() + src_pitch * (flip ? img.height - row - 1 : row);
+				u8* out = dst + dst_pitch * row;
+
+				if (layout == pixel_layout::argb)
+				{
+					write_argb_row(src, out, line_size / 4);
+				}
+				else
+				{
+					std::memcpy(out, src, line_size);
+				}
+			}
+		};
+
+		auto& pool = worker_pool::get();
+		const u32 band_count = std::min<u32>(pool.size() + 1, img.height / 16);
+
+		if (line_size * img.height < parallel_write_threshold || band_count <= 1)
+		{
+			write_rows(0, img.height);
+		}
+		else
+		{
+			const u32 rows_per_band = (img.height + band_count - 1) / band_count;
+
+			pool.parallel_for(band_count, [&](u32 band)
+			{
+				const u32 row_begin = band * rows_per_band;
+				const u32 row_end = std::min(row_begin + rows_per_band, img.height);
+
+				if (row_begin < row_end)
+				{
+					write_rows(row_begin, row_end);
+				}
+			});
+		}
+
+		return img.height;
+	}
+}
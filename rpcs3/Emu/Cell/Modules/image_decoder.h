@@ -0,0 +1,48 @@
+#pragma once
+
+#include "Utilities/File.h"
+
+#include <memory>
+
+// Shared stb_image based decoding for the JPEG and GIF decoder modules
+namespace image_decoder
+{
+	enum class pixel_layout : u8
+	{
+		rgb,
+		rgba,
+		argb,
+	};
+
+	// Compressed input: either guest memory read in place, or a file read on demand from its start
+	struct source
+	{
+		const u8* buffer = nullptr;
+		const fs::file* file = nullptr;
+		u64 size = 0;
+	};
+
+	struct image
+	{
+		struct pixels_deleter
+		{
+			void operator()(u8* pixels) const;
+		};
+
+		std::unique_ptr<u8, pixels_deleter> pixels;
+		u32 width = 0;
+		u32 height = 0;
+		u32 bytes_per_pixel = 0;
+	};
+
+	// Read image dimensions and the number of components stored in the stream
+	bool get_info(const source& src, u32& width, u32& height, u32& components);
+
+	// Decode to RGB (layout rgb) or RGBA (layouts rgba and argb)
+	bool decode(const source& src, pixel_layout layout, image& out);
+
+	// Convert a decoded image into the output buffer in a single pass, honouring the output pitch and vertical flip.
+	// Rows are clipped to the pitch, a zero pitch means tightly packed. Large images are split across the worker pool.
+	// Returns the number of lines written.
+	u32 write(const image& img, pixel_layout layout, u8* dst, u32 dst_pitch, bool flip);
+}
@@ -1237,6 +1237,9 @@ bool SPUThread::process_mfc_cmd(spu_mfc_cmd args)
 			rtime = vm::reservation_acquire(raddr, 128);
 			_mm_lfence();
 
+			// Sleep until a store to the line notifies its reservation
+			std::shared_lock<notifier> pseudo_lock(vm::reservation_notifier(raddr, 128));
+
 			while (vm::reservation_acquire(raddr, 128) == rtime && rdata == data)
 			{
 				if (test(state, cpu_flag::stop))
@@ -1244,7 +1247,7 @@ bool SPUThread::process_mfc_cmd(spu_mfc_cmd args)
 					break;
 				}
 
-				thread_ctrl::wait_for(100);
+				pseudo_lock.mutex()->wait(100);
 			}
 		}
 
@@ -24,6 +24,12 @@
 #include <poll.h>
 #endif
 
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <mutex>
+#endif
+
 
 
 logs::channel sys_net("sys_net");
@@ -32,6 +38,15 @@ static std::vector<ppu_thread*> s_to_awake;
 
 static semaphore<> s_nw_mutex;
 
+#ifdef __linux__
+// Wakeup eventfd of the network thread
+static atomic_t<int> s_nw_wakeup{-1};
+
+// Sockets whose selected events have changed outside of the network thread
+static std::mutex s_nw_update_mutex;
+static std::vector<u32> s_nw_update;
+#endif
+
 extern u64 get_system_time();
 
 // Error helper functions
@@ -110,10 +125,175 @@ static void network_clear_queue(ppu_thread& ppu)
 	});
 }
 
+// Let the network thread pick up the selected events of the socket (must be called after adding to lv2_socket::events)
+static void network_update_socket(u32 id)
+{
+#ifdef __linux__
+	{
+		std::lock_guard<std::mutex> lock(s_nw_update_mutex);
+		s_nw_update.emplace_back(id);
+	}
+
+	const u64 value = 1;
+	::write(s_nw_wakeup, &value, sizeof(value));
+#endif
+}
+
+// Run the event processing workload of the socket
+static void network_process_events(lv2_socket& sock, bs_t<lv2_socket::poll> events)
+{
+	semaphore_lock lock(sock.mutex);
+
+	for (auto it = sock.queue.begin(); test(events) && it != sock.queue.end();)
+	{
+		if (it->second(events))
+		{
+			it = sock.queue.erase(it);
+			continue;
+		}
+
+		it++;
+	}
+
+	if (sock.queue.empty())
+	{
+		sock.events = {};
+	}
+}
+
+static void network_awake_threads()
+{
+	s_to_awake.erase(std::unique(s_to_awake.begin(), s_to_awake.end()), s_to_awake.end());
+
+	for (ppu_thread* ppu : s_to_awake)
+	{
+		network_clear_queue(*ppu);
+		lv2_obj::awake(*ppu);
+	}
+
+	s_to_awake.clear();
+}
+
+#ifdef __linux__
+
+// Edge-triggered epoll loop: sockets are only watched while some events are selected
+static void network_thread_epoll()
+{
+	const int epfd = ::epoll_create1(EPOLL_CLOEXEC);
+	const int wakeup = ::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+
+	verify("epoll" HERE), epfd != -1, wakeup != -1;
+
+	// Tag of the wakeup eventfd (socket ids are 32-bit)
+	constexpr u64 wakeup_tag = UINT64_MAX;
+
+	::epoll_event wakeup_event{};
+	wakeup_event.events = EPOLLIN;
+	wakeup_event.data.u64 = wakeup_tag;
+	verify("epoll_ctl" HERE), ::epoll_ctl(epfd, EPOLL_CTL_ADD, wakeup, &wakeup_event) == 0;
+
+	s_nw_wakeup = wakeup;
+
+	std::vector<u32> update;
+	std::array<::epoll_event, 64> ready;
+
+	do
+	{
+		// The timeout only serves to notice the emulation stop
+		const int count = ::epoll_wait(epfd, ready.data(), ::size32(ready), 100);
+
+		semaphore_lock lock(s_nw_mutex);
+
+		for (int i = 0; i < count; i++)
+		{
+			if (ready[i].data.u64 == wakeup_tag)
+			{
+				u64 value;
+				::read(wakeup, &value, sizeof(value));
+				continue;
+			}
+
+			const u32 id = static_cast<u32>(ready[i].data.u64);
+			const auto sock = idm::get_unlocked<lv2_socket>(id);
+
+			if (!sock)
+			{
+				continue;
+			}
+
+			bs_t<lv2_socket::poll> events{};
+
+			if (ready[i].events & (EPOLLIN | EPOLLHUP) && sock->events.test_and_reset(lv2_socket::poll::read))
+				events += lv2_socket::poll::read;
+			if (ready[i].events & EPOLLOUT && sock->events.test_and_reset(lv2_socket::poll::write))
+				events += lv2_socket::poll::write;
+			if (ready[i].events & EPOLLERR && sock->events.test_and_reset(lv2_socket::poll::error))
+				events += lv2_socket::poll::error;
+
+			if (test(events))
+			{
+				network_process_events(*sock, events);
+
+				// Callbacks may have selected the events again
+				update.emplace_back(id);
+			}
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(s_nw_update_mutex);
+			update.insert(update.end(), s_nw_update.begin(), s_nw_update.end());
+			s_nw_update.clear();
+		}
+
+		std::sort(update.begin(), update.end());
+		update.erase(std::unique(update.begin(), update.end()), update.end());
+
+		// Modifying the interest set reports the events which are already pending, so none are lost between edges
+		for (u32 id : update)
+		{
+			const auto sock = idm::get_unlocked<lv2_socket>(id);
+
+			if (!sock)
+			{
+				continue;
+			}
+
+			const auto events = sock->events.load();
+
+			::epoll_event ev{};
+			ev.events = EPOLLET |
+				(test(events, lv2_socket::poll::read) ? EPOLLIN : 0) |
+				(test(events, lv2_socket::poll::write) ? EPOLLOUT : 0);
+			ev.data.u64 = id;
+
+			if (::epoll_ctl(epfd, EPOLL_CTL_MOD, sock->socket, &ev) != 0 && errno == ENOENT)
+			{
+				// First use of the socket (closed sockets are removed from the set automatically)
+				::epoll_ctl(epfd, EPOLL_CTL_ADD, sock->socket, &ev);
+			}
+		}
+
+		update.clear();
+
+		network_awake_threads();
+	}
+	while (!Emu.IsStopped());
+
+	s_nw_wakeup.compare_and_swap(wakeup, -1);
+	::close(wakeup);
+	::close(epfd);
+}
+
+#endif
+
 extern void network_thread_init()
 {
 	thread_ctrl::spawn("Network Thread", []()
 	{
+#ifdef __linux__
+		s_to_awake.clear();
+		network_thread_epoll();
+#else
 		std::vector<std::shared_ptr<lv2_socket>> socklist;
 		socklist.reserve(lv2_socket::id_count);
 
@@ -182,35 +362,11 @@ extern void network_thread_init()
 
 				if (test(events))
 				{
-					semaphore_lock lock(socklist[i]->mutex);
-
-					for (auto it = socklist[i]->queue.begin(); test(events) && it != socklist[i]->queue.end();)
-					{
-						if (it->second(events))
-						{
-							it = socklist[i]->queue.erase(it);
-							continue;
-						}
-
-						it++;
-					}
-
-					if (socklist[i]->queue.empty())
-					{
-						socklist[i]->events = {};
-					}
+					network_process_events(*socklist[i], events);
 				}
 			}
 
-			s_to_awake.erase(std::unique(s_to_awake.begin(), s_to_awake.end()), s_to_awake.end());
-
-			for (ppu_thread* ppu : s_to_awake)
-			{
-				network_clear_queue(*ppu);
-				lv2_obj::awake(*ppu);
-			}
-
-			s_to_awake.clear();
+			network_awake_threads();
 			socklist.clear();
 
 			// Obtain all active sockets
@@ -240,6 +396,7 @@ extern void network_thread_init()
 #ifdef _WIN32
 		CloseHandle(_eventh);
 		WSACleanup();
+#endif
 #endif
 	});
 }
@@ -300,6 +457,7 @@ s32 sys_net_bnet_accept(ppu_thread& ppu, s32 s, vm::ptr<sys_net_sockaddr> addr,
 
 		// Enable read event
 		sock.events += lv2_socket::poll::read;
+		network_update_socket(s);
 		sock.queue.emplace_back(ppu.id, [&](bs_t<lv2_socket::poll> events) -> bool
 		{
 			if (test(events, lv2_socket::poll::read))
@@ -470,6 +628,7 @@ s32 sys_net_bnet_connect(ppu_thread& ppu, s32 s, vm::ptr<sys_net_sockaddr> addr,
 			if (result == SYS_NET_EINPROGRESS)
 			{
 				sock.events += lv2_socket::poll::write;
+				network_update_socket(s);
 				sock.queue.emplace_back(u32{0}, [&sock](bs_t<lv2_socket::poll> events) -> bool
 				{
 					if (test(events, lv2_socket::poll::write))
@@ -501,6 +660,7 @@ s32 sys_net_bnet_connect(ppu_thread& ppu, s32 s, vm::ptr<sys_net_sockaddr> addr,
 		}
 
 		sock.events += lv2_socket::poll::write;
+		network_update_socket(s);
 		sock.queue.emplace_back(ppu.id, [&](bs_t<lv2_socket::poll> events) -> bool
 		{
 			if (test(events, lv2_socket::poll::write))
@@ -908,6 +1068,7 @@ s32 sys_net_bnet_recvfrom(ppu_thread& ppu, s32 s, vm::ptr<void> buf, u32 len, s3
 
 		// Enable read event
 		sock.events += lv2_socket::poll::read;
+		network_update_socket(s);
 		sock.queue.emplace_back(ppu.id, [&](bs_t<lv2_socket::poll> events) -> bool
 		{
 			if (test(events, lv2_socket::poll::read))
@@ -1061,6 +1222,7 @@ s32 sys_net_bnet_sendto(ppu_thread& ppu, s32 s, vm::cptr<void> buf, u32 len, s32
 
 		// Enable write event
 		sock.events += lv2_socket::poll::write;
+		network_update_socket(s);
 		sock.queue.emplace_back(ppu.id, [&](bs_t<lv2_socket::poll> events) -> bool
 		{
 			if (test(events, lv2_socket::poll::write))
@@ -1515,6 +1677,7 @@ s32 sys_net_bnet_poll(ppu_thread& ppu, vm::ptr<sys_net_pollfd> fds, s32 nfds, s3
 				//	selected += lv2_socket::poll::error;
 
 				sock->events += selected;
+				network_update_socket(fds[i].fd);
 				sock->queue.emplace_back(ppu.id, [sock, selected, fds, i, &signaled, &ppu](bs_t<lv2_socket::poll> events)
 				{
 					if (test(events, selected))
@@ -1705,6 +1868,7 @@ s32 sys_net_bnet_select(ppu_thread& ppu, s32 nfds, vm::ptr<sys_net_fd_set> readf
 				semaphore_lock lock(sock->mutex);
 
 				sock->events += selected;
+				network_update_socket((lv2_socket::id_base & -1024) + i);
 				sock->queue.emplace_back(ppu.id, [sock, selected, i, &rread, &rwrite, &rexcept, &signaled, &ppu](bs_t<lv2_socket::poll> events)
 				{
 					if (test(events, selected))
@@ -10,6 +10,7 @@
 #include "Emu/RSX/GSRender.h"
 #include <atomic>
 #include <deque>
+#include <shared_mutex>
 
 static_assert(sizeof(notifier) == 8, "Unexpected size of notifier");
 
@@ -283,6 +284,28 @@ namespace vm
 		}
 	}
 
+	void reservation_notify(u32 addr, u32 size)
+	{
+		reservation_notifier(addr, size).notify_all();
+	}
+
+	bool reservation_wait(u32 addr, u32 size, u64 old, u64 usec_timeout)
+	{
+		auto& sync = reservation_notifier(addr, size);
+
+		// The value is checked under the pseudo lock, so a notification can't be lost before wait()
+		std::shared_lock<notifier> lock(sync);
+
+		const u64 value = size == 4 ? u64{*reinterpret_cast<volatile u32*>(g_base_addr + addr)} : *reinterpret_cast<volatile u64*>(g_base_addr + addr);
+
+		if (value != old)
+		{
+			return true;
+		}
+
+		return static_cast<bool>(sync.wait(usec_timeout));
+	}
+
 	bool page_protect(u32 addr, u32 size, u8 flags_test, u8 flags_set, u8 flags_clear)
 	{
 		vm::writer_lock lock(0);
@@ -105,6 +105,24 @@ namespace vm
 		return *reinterpret_cast<notifier*>(g_reservations2 + addr / 16);
 	}
 
+	// Wake threads blocked in reservation_wait() on the reservation granule of addr (for stores done by HLE code)
+	void reservation_notify(u32 addr, u32 size);
+
+	// Futex-style wait: block while the 4 or 8 bytes at addr are equal to old (raw guest byte order).
+	// Stores which notify the reservation granule wake the thread, other stores are only noticed on timeout.
+	// Returns false on timeout.
+	bool reservation_wait(u32 addr, u32 size, u64 old, u64 usec_timeout);
+
+	template <typename T>
+	inline bool reservation_wait(u32 addr, const T& old, u64 usec_timeout)
+	{
+		static_assert(sizeof(T) == 4 || sizeof(T) == 8, "Unsupported wait size");
+
+		u64 raw = 0;
+		std::memcpy(&raw, &old, sizeof(T));
+		return reservation_wait(addr, sizeof(T), raw, usec_timeout);
+	}
+
 	// Change memory protection of specified memory region
 	bool page_protect(u32 addr, u32 size, u8 flags_test = 0, u8 flags_set = 0, u8 flags_clear = 0);
 
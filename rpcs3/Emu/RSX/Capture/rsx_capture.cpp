@@ -9,10 +9,105 @@
 
 #include "xxhash.h"
 
+#include <sstream>
+#include <zlib.h>
+#include <cereal/archives/binary.hpp>
+
 namespace rsx
 {
+	bool frame_capture_writer::open(const std::string& path)
+	{
+		m_blobs.clear();
+
+		if (!m_file.open(path, fs::rewrite))
+			return false;
+
+		const u32 header[2]{ FRAME_CAPTURE_MAGIC, FRAME_CAPTURE_VERSION };
+		m_file.write(header);
+		return true;
+	}
+
+	void frame_capture_writer::add_blob(u64 hash, const void* data, u32 size)
+	{
+		const u64 check_hash = XXH64(data, size, 1);
+
+		const auto found = m_blobs.find(hash);
+		if (found != m_blobs.end())
+		{
+			if (found->second.check_hash != check_hash)
+				fmt::throw_exception("Memory map hash collision detected...cant capture" HERE);
+
+			return;
+		}
+
+		blob_entry& entry = m_blobs[hash];
+		entry.check_hash = check_hash;
+		entry.info.hash = hash;
+		entry.info.offset = m_file.pos();
+		entry.info.size = size;
+
+		m_buffer.resize(compressBound(size));
+		uLongf compressed_size = static_cast<uLongf>(m_buffer.size());
+
+		// Fall back to storing the block as is if it doesn't shrink
+		if (compress2(m_buffer.data(), &compressed_size, static_cast<const Bytef*>(data), size, Z_BEST_SPEED) == Z_OK && compressed_size < size)
+		{
+			entry.info.compressed_size = static_cast<u32>(compressed_size);
+			m_file.write(m_buffer.data(), compressed_size);
+		}
+		else
+		{
+			entry.info.compressed_size = size;
+			m_file.write(data, size);
+		}
+	}
+
+	bool frame_capture_writer::finish(const frame_capture_data& frame)
+	{
+		std::ostringstream os;
+		{
+			cereal::BinaryOutputArchive archive(os);
+			archive(frame);
+		}
+
+		const std::string metadata = os.str();
+
+		m_buffer.resize(compressBound(static_cast<uLong>(metadata.size())));
+		uLongf compressed_size = static_cast<uLongf>(m_buffer.size());
+
+		if (compress2(m_buffer.data(), &compressed_size, reinterpret_cast<const Bytef*>(metadata.data()), static_cast<uLong>(metadata.size()), Z_DEFAULT_COMPRESSION) != Z_OK)
+		{
+			m_file.close();
+			return false;
+		}
+
+		frame_capture_footer footer{};
+		footer.metadata_offset = m_file.pos();
+		footer.metadata_size = metadata.size();
+		footer.metadata_compressed_size = compressed_size;
+		m_file.write(m_buffer.data(), compressed_size);
+
+		footer.index_offset = m_file.pos();
+		footer.blob_count = m_blobs.size();
+
+		for (const auto& blob : m_blobs)
+		{
+			m_file.write(blob.second.info);
+		}
+
+		footer.magic = FRAME_CAPTURE_MAGIC;
+		footer.version = FRAME_CAPTURE_VERSION;
+		m_file.write(footer);
+
+		m_file.close();
+		m_blobs.clear();
+		return true;
+	}
+
 	namespace capture
 	{
+		frame_capture_writer file_writer;
+
 		u32 get_io_offset(u32 offset, u32 location)
 		{
 			switch (location)
@@ -49,15 +144,8 @@ namespace rsx
 				block.size       = data.data.size();
 				block.data_state = data_hash;
 
-				auto it = frame_capture.memory_data_map.find(data_hash);
-				if (it != frame_capture.memory_data_map.end())
-				{
-					if (it->second.data != data.data)
-						// screw this
-						fmt::throw_exception("Memory map hash collision detected...cant capture");
-				}
-				else
-					frame_capture.memory_data_map.insert(std::make_pair(data_hash, std::move(data)));
+				// data goes straight to disk instead of memory_data_map
+				file_writer.add_blob(data_hash, data.data.data(), ::size32(data.data));
 			}
 
 			u64 block_hash = XXH64(&block, sizeof(frame_capture_data::memory_block), 0);
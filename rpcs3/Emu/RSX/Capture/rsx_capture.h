@@ -4,8 +4,35 @@
 namespace rsx
 {
 	class thread;
+
+	// Writes memory blocks to the capture file as soon as they are captured, see frame_capture_blob
+	class frame_capture_writer
+	{
+		struct blob_entry
+		{
+			frame_capture_blob info;
+			u64 check_hash; // second hash with a different seed to detect collisions
+		};
+
+		fs::file m_file;
+		std::unordered_map<u64, blob_entry> m_blobs;
+		std::vector<u8> m_buffer;
+
+	public:
+		bool open(const std::string& path);
+		bool is_open() const { return !!m_file; }
+
+		// Stores data under hash unless it is already in the file
+		void add_blob(u64 hash, const void* data, u32 size);
+
+		// Appends metadata, index and footer, and closes the file
+		bool finish(const frame_capture_data& frame);
+	};
+
 	namespace capture
 	{
+		extern frame_capture_writer file_writer;
+
 		void capture_draw_memory(thread* rsx);
 		void capture_image_in(thread* rsx, frame_capture_data::replay_command& replay_command);
 		void capture_buffer_notify(thread* rsx, frame_capture_data::replay_command& replay_command);
@@ -7,9 +7,117 @@
 #include "Emu/RSX/GSRender.h"
 
 #include <map>
+#include <sstream>
+#include <zlib.h>
+#include <cereal/archives/binary.hpp>
 
 namespace rsx
 {
+	bool frame_capture_reader::open(const std::string& path, frame_capture_data& frame)
+	{
+		if (!m_file.open(path))
+		{
+			LOG_ERROR(LOADER, "Failed to open rsx capture file: %s", path);
+			return false;
+		}
+
+		u32 header[2]{};
+		if (!m_file.read(header) || header[0] != FRAME_CAPTURE_MAGIC)
+		{
+			LOG_ERROR(LOADER, "Invalid rsx capture file!");
+			return false;
+		}
+
+		if (header[1] == FRAME_CAPTURE_VERSION_MONOLITHIC)
+		{
+			// Everything including memory data is in one archive
+			std::istringstream is(m_file.to_string());
+			cereal::BinaryInputArchive archive(is);
+			archive(frame);
+			m_file.close();
+			return true;
+		}
+
+		if (header[1] != FRAME_CAPTURE_VERSION)
+		{
+			LOG_ERROR(LOADER, "Rsx capture file version not supported! Expected %d, found %d", FRAME_CAPTURE_VERSION, header[1]);
+			return false;
+		}
+
+		frame_capture_footer footer{};
+		const u64 file_size = m_file.size();
+
+		// The uncompressed metadata size is bounded by zlib's maximum expansion ratio (about 1032:1)
+		if (file_size < sizeof(header) + sizeof(footer) || m_file.read_at(file_size - sizeof(footer), &footer, sizeof(footer)) != sizeof(footer) ||
+			footer.magic != FRAME_CAPTURE_MAGIC || footer.version != FRAME_CAPTURE_VERSION ||
+			footer.index_offset > file_size || footer.blob_count > (file_size - footer.index_offset) / sizeof(frame_capture_blob) ||
+			footer.metadata_offset > file_size || footer.metadata_compressed_size > file_size - footer.metadata_offset ||
+			footer.metadata_size == 0 || footer.metadata_size > footer.metadata_compressed_size * 1032)
+		{
+			LOG_ERROR(LOADER, "Rsx capture file is truncated or corrupted");
+			return false;
+		}
+
+		// Load the blob index, the blobs themselves stay on disk
+		std::vector<frame_capture_blob> index(footer.blob_count);
+
+		if (m_file.read_at(footer.index_offset, index.data(), index.size() * sizeof(frame_capture_blob)) != index.size() * sizeof(frame_capture_blob))
+		{
+			LOG_ERROR(LOADER, "Failed to read rsx capture blob index");
+			return false;
+		}
+
+		m_blobs.reserve(index.size());
+		for (const auto& blob : index)
+		{
+			m_blobs.emplace(blob.hash, blob);
+		}
+
+		std::vector<u8> compressed(footer.metadata_compressed_size);
+		std::string metadata(footer.metadata_size, '\0');
+		uLongf metadata_size = static_cast<uLongf>(footer.metadata_size);
+
+		if (m_file.read_at(footer.metadata_offset, compressed.data(), compressed.size()) != compressed.size() ||
+			uncompress(reinterpret_cast<Bytef*>(&metadata[0]), &metadata_size, compressed.data(), static_cast<uLong>(compressed.size())) != Z_OK ||
+			metadata_size != footer.metadata_size)
+		{
+			LOG_ERROR(LOADER, "Failed to decompress rsx capture metadata");
+			return false;
+		}
+
+		std::istringstream is(metadata);
+		cereal::BinaryInputArchive archive(is);
+		archive(frame);
+		return true;
+	}
+
+	u32 frame_capture_reader::get_blob_size(u64 hash) const
+	{
+		const auto found = m_blobs.find(hash);
+		return found == m_blobs.end() ? 0 : found->second.size;
+	}
+
+	bool frame_capture_reader::read_blob(u64 hash, void* dst)
+	{
+		const auto found = m_blobs.find(hash);
+		if (found == m_blobs.end())
+			return false;
+
+		const auto& blob = found->second;
+
+		if (blob.compressed_size == blob.size)
+		{
+			return m_file.read_at(blob.offset, dst, blob.size) == blob.size;
+		}
+
+		m_buffer.resize(blob.compressed_size);
+		if (m_file.read_at(blob.offset, m_buffer.data(), blob.compressed_size) != blob.compressed_size)
+			return false;
+
+		uLongf size = blob.size;
+		return uncompress(static_cast<Bytef*>(dst), &size, m_buffer.data(), blob.compressed_size) == Z_OK && size == blob.size;
+	}
+
 	be_t<u32> rsx_replay_thread::allocate_context()
 	{
 		const u32 contextAddr = vm::alloc(sizeof(rsx_context), vm::main);
@@ -170,11 +278,16 @@ namespace rsx
 			{
 				const auto& memblock = it->second;
 				auto it_data = frame->memory_data_map.find(it->second.data_state);
-				if (it_data == frame->memory_data_map.end())
-					fmt::throw_exception("requested memory data state for command not found in memory_data_map");
+				if (it_data != frame->memory_data_map.end())
+				{
+					const auto& data_block = it_data->second;
+					std::memcpy(vm::base(memblock.addr + memblock.offset), data_block.data.data(), data_block.data.size());
+					continue;
+				}
 
-				const auto& data_block = it_data->second;
-				std::memcpy(vm::base(memblock.addr + memblock.offset), data_block.data.data(), data_block.data.size());
+				// Streamed captures decompress directly into guest memory
+				if (!reader || !reader->get_blob_size(memblock.data_state) || !reader->read_blob(memblock.data_state, vm::base(memblock.addr + memblock.offset)))
+					fmt::throw_exception("requested memory data state for command not found in capture file");
 			}
 		}
 
@@ -257,8 +370,108 @@ namespace rsx
 		}
 	}
 
+	// Timings gathered by the benchmark mode, filled by the rsx thread on every flip
+	struct replay_benchmark
+	{
+		struct frame_result
+		{
+			u32 pass;
+			u64 time; // wall time since the previous flip or the pass start
+			frame_statistics_t stats;
+		};
+
+		std::mutex mutex;
+		std::vector<frame_result> frames;
+		std::vector<u64> pass_times;
+		u32 current_pass = 0;
+		u64 pass_start = 0;
+		u64 last_timestamp = 0;
+
+		void begin_pass(u32 pass)
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			current_pass = pass;
+			pass_start = last_timestamp = get_system_time();
+		}
+
+		void end_pass()
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			pass_times.push_back(get_system_time() - pass_start);
+		}
+
+		void on_frame(const frame_statistics_t& stats)
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			const u64 timestamp = get_system_time();
+			frames.push_back({ current_pass, timestamp - last_timestamp, stats });
+			last_timestamp = timestamp;
+		}
+
+		std::string to_json()
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+
+			u64 min_time = frames.empty() ? 0 : UINT64_MAX, max_time = 0, total_time = 0;
+			u64 draw_calls = 0, method_count = 0;
+			frame_statistics_t total;
+
+			std::string frame_list;
+			for (const auto& frame : frames)
+			{
+				min_time = std::min(min_time, frame.time);
+				max_time = std::max(max_time, frame.time);
+				total_time += frame.time;
+
+				const auto& s = frame.stats;
+				draw_calls += s.draw_calls;
+				method_count += s.method_count;
+				total.fifo_time += s.fifo_time;
+				total.setup_time += s.setup_time;
+				total.vertex_upload_time += s.vertex_upload_time;
+				total.textures_upload_time += s.textures_upload_time;
+				total.draw_exec_time += s.draw_exec_time;
+				total.flip_time += s.flip_time;
+
+				frame_list += fmt::format("%s\n    {\"pass\": %u, \"time_us\": %llu, \"draw_calls\": %u, \"methods\": %u, \"fifo_us\": %lld, \"setup_us\": %lld, "
+					"\"vertex_upload_us\": %lld, \"texture_upload_us\": %lld, \"draw_exec_us\": %lld, \"flip_us\": %lld, \"vertex_cache_hits\": %u, \"vertex_cache_misses\": %u}",
+					frame_list.empty() ? "" : ",", frame.pass, frame.time, s.draw_calls, s.method_count, s.fifo_time, s.setup_time,
+					s.vertex_upload_time, s.textures_upload_time, s.draw_exec_time, s.flip_time, s.vertex_cache_hits, s.vertex_cache_misses);
+			}
+
+			std::string pass_list;
+			for (const u64 time : pass_times)
+			{
+				pass_list += fmt::format("%s%llu", pass_list.empty() ? "" : ", ", time);
+			}
+
+			const u64 count = std::max<u64>(frames.size(), 1);
+
+			return fmt::format("{\n  \"passes_us\": [%s],\n"
+				"  \"summary\": {\"frames\": %llu, \"frame_min_us\": %llu, \"frame_avg_us\": %llu, \"frame_max_us\": %llu, "
+				"\"draw_calls_avg\": %llu, \"methods_avg\": %llu, \"fifo_avg_us\": %lld, \"setup_avg_us\": %lld, \"vertex_upload_avg_us\": %lld, "
+				"\"texture_upload_avg_us\": %lld, \"draw_exec_avg_us\": %lld, \"flip_avg_us\": %lld},\n  \"frames\": [%s\n  ]\n}\n",
+				pass_list,
+				(u64)frames.size(), min_time, total_time / count, max_time,
+				draw_calls / count, method_count / count, total.fifo_time / (s64)count, total.setup_time / (s64)count, total.vertex_upload_time / (s64)count,
+				total.textures_upload_time / (s64)count, total.draw_exec_time / (s64)count, total.flip_time / (s64)count, frame_list);
+		}
+	};
+
 	void rsx_replay_thread::cpu_task()
 	{
+		std::shared_ptr<replay_benchmark> benchmark;
+
+		if (replay_count)
+		{
+			// Installed before the rsx thread is started by the context allocation below
+			benchmark = std::make_shared<replay_benchmark>();
+			fxm::get<GSRender>()->frame_statistics_callback = [benchmark](const frame_statistics_t& stats)
+			{
+				benchmark->on_frame(stats);
+			};
+		}
+
 		be_t<u32> context_id = allocate_context();
 
 		auto fifo_info = get_usable_fifo_range();
@@ -283,8 +496,16 @@ namespace rsx
 				fmt::throw_exception("rsx io map failed for block");
 		}
 
-		while (!Emu.IsStopped())
+		for (u32 pass = 0; !Emu.IsStopped(); pass++)
 		{
+			if (benchmark)
+			{
+				if (pass == replay_count)
+					break;
+
+				benchmark->begin_pass(pass);
+			}
+
 			// start up fifo buffer by dumping the put ptr to first stop
 			sys_rsx_context_attribute(context_id, 0x001, fifo_start_addr, fifo_stops[0], 0, 0);
 
@@ -331,10 +552,32 @@ namespace rsx
 					std::this_thread::sleep_for(10ms);
 			}
 
+			if (benchmark)
+			{
+				benchmark->end_pass();
+				continue;
+			}
+
 			// random pause to not destroy gpu
 			std::this_thread::sleep_for(10ms);
 		}
 
+		if (benchmark && !Emu.IsStopped())
+		{
+			const std::string report = benchmark->to_json();
+
+			if (!report_path.empty() && fs::write_file(report_path, fs::rewrite, report))
+			{
+				LOG_SUCCESS(RSX, "Capture Replay: %u passes done, results written to %s", replay_count, report_path);
+			}
+			else
+			{
+				LOG_ERROR(RSX, "Capture Replay: failed to write benchmark results to '%s'", report_path);
+			}
+
+			Emu.CallAfter([]() { Emu.Stop(); });
+		}
+
 		state += cpu_flag::exit;
 	}
 }
@@ -15,7 +15,8 @@
 namespace rsx
 {
 	constexpr u32 FRAME_CAPTURE_MAGIC = 0x52524300; // ascii 'RRC/0'
-	constexpr u32 FRAME_CAPTURE_VERSION = 0x1;
+	constexpr u32 FRAME_CAPTURE_VERSION = 0x2;
+	constexpr u32 FRAME_CAPTURE_VERSION_MONOLITHIC = 0x1; // single cereal archive holding all memory data
 	struct frame_capture_data
 	{
 
@@ -199,10 +200,58 @@ namespace rsx
 			version = FRAME_CAPTURE_VERSION;
 			tile_map.clear();
 			memory_map.clear();
+			memory_data_map.clear();
+			display_buffers_map.clear();
 			replay_commands.clear();
 		}
 	};
 
+	// Version 2 capture files are written while capturing, memory data never has to be held in RAM:
+	//   header   : magic, version
+	//   blobs    : memory block data deduplicated by XXH64 hash, zlib compressed
+	//   metadata : zlib compressed cereal archive of frame_capture_data with an empty memory_data_map
+	//   index    : frame_capture_blob for every blob
+	//   footer   : frame_capture_footer
+	struct frame_capture_blob
+	{
+		u64 hash;
+		u64 offset;
+		u32 size;
+		u32 compressed_size; // equal to size if the data is stored uncompressed
+	};
+
+	CHECK_SIZE(frame_capture_blob, 24);
+
+	struct frame_capture_footer
+	{
+		u64 metadata_offset;
+		u64 metadata_size;
+		u64 metadata_compressed_size;
+		u64 index_offset;
+		u64 blob_count;
+		u32 magic;
+		u32 version;
+	};
+
+	CHECK_SIZE(frame_capture_footer, 48);
+
+	// Loads the capture metadata up front, memory blocks are only read and decompressed when applied
+	class frame_capture_reader
+	{
+		fs::file m_file;
+		std::unordered_map<u64, frame_capture_blob> m_blobs;
+		std::vector<u8> m_buffer;
+
+	public:
+		bool open(const std::string& path, frame_capture_data& frame);
+
+		// Returns uncompressed size of the memory block, 0 if it isn't stored in the file
+		u32 get_blob_size(u64 hash) const;
+
+		// Decompresses the memory block into dst, which must hold get_blob_size(hash) bytes
+		bool read_blob(u64 hash, void* dst);
+	};
+
 
 	class rsx_replay_thread : public ppu_thread
 	{
@@ -226,10 +275,15 @@ namespace rsx
 
 		current_state cs;
 		std::unique_ptr<frame_capture_data> frame;
+		std::unique_ptr<frame_capture_reader> reader;
+
+		// benchmark mode, replays the capture replay_count times then stops the emulator, 0 loops forever
+		u32 replay_count;
+		std::string report_path;
 
 	public:
-		rsx_replay_thread(std::unique_ptr<frame_capture_data>&& frame_data)
-			: ppu_thread("Rsx Capture Replay Thread"), frame(std::move(frame_data)) {};
+		rsx_replay_thread(std::unique_ptr<frame_capture_data>&& frame_data, std::unique_ptr<frame_capture_reader>&& frame_reader, u32 replay_count = 0, const std::string& report_path = {})
+			: ppu_thread("Rsx Capture Replay Thread"), frame(std::move(frame_data)), reader(std::move(frame_reader)), replay_count(replay_count), report_path(report_path) {};
 
 		virtual void cpu_task() override;
 	private:
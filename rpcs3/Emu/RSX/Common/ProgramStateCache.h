@@ -6,6 +6,11 @@
 
 #include "Utilities/GSL.h"
 #include "Utilities/hash.h"
+#include "Utilities/Atomic.h"
+#include "Utilities/worker_pool.h"
+
+#include <memory>
+#include <thread>
 
 enum class SHADER_TYPE
 {
@@ -89,10 +94,14 @@ namespace program_hash_util
 * - a typedef PipelineProperties to a type that encapsulate various state info relevant to program compilation (alpha test, primitive type,...)
 * - a	typedef ExtraData type that will be passed to the buildProgram function.
 * It should also contains the following function member :
-* - static void recompile_fragment_program(RSXFragmentProgram *RSXFP, FragmentProgramData& fragmentProgramData, size_t ID);
-* - static void recompile_vertex_program(RSXVertexProgram *RSXVP, VertexProgramData& vertexProgramData, size_t ID);
+* - static void decompile_fragment_program(const RSXFragmentProgram &RSXFP, FragmentProgramData& fragmentProgramData, size_t ID);
+* - static void decompile_vertex_program(const RSXVertexProgram &RSXVP, VertexProgramData& vertexProgramData, size_t ID);
+* - static void compile_fragment_program(FragmentProgramData& fragmentProgramData);
+* - static void compile_vertex_program(VertexProgramData& vertexProgramData);
 * - static PipelineData build_program(VertexProgramData &vertexProgramData, FragmentProgramData &fragmentProgramData, const PipelineProperties &pipelineProperties, const ExtraData& extraData);
 * - static void validate_pipeline_properties(const VertexProgramData &vertexProgramData, const FragmentProgramData &fragmentProgramData, PipelineProperties& props);
+* decompile_* must not touch the graphics API as it may run on a worker thread when asynchronous decompilation is enabled.
+* compile_* always runs on the thread requesting the pipeline.
 */
 template<typename backend_traits>
 class program_state_cache
@@ -133,15 +142,91 @@ class program_state_cache
 		}
 	};
 
+	enum decompile_state : u32
+	{
+		decompile_pending,
+		decompile_done,
+		decompile_failed,
+	};
+
 protected:
 	size_t m_next_id = 0;
 	bool m_cache_miss_flag;
+	bool m_async_decompilation = false;
 	binary_to_vertex_program m_vertex_shader_cache;
 	binary_to_fragment_program m_fragment_shader_cache;
 	std::unordered_map <pipeline_key, pipeline_storage_type, pipeline_key_hash, pipeline_key_compare> m_storage;
 
+	// Programs whose decompilation was handed to the worker pool, keyed by the cached program object
+	std::unordered_map<const void*, std::shared_ptr<atomic_t<u32>>> m_pending_programs;
+
+	// Decompiles the program in place, either immediately or on the worker pool. The source is captured by value
+	// since the job may outlive the caller's copy (fragment keys point to the ucode copy owned by the cache).
+	template <typename RSXProgram, typename Program, typename Decompile, typename Compile>
+	void decompile_program(const RSXProgram& source, Program& program, Decompile decompile, Compile compile)
+	{
+		const size_t id = m_next_id++;
+
+		if (!m_async_decompilation)
+		{
+			decompile(source, program, id);
+			compile(program);
+			return;
+		}
+
+		auto state = std::make_shared<atomic_t<u32>>(decompile_pending);
+		m_pending_programs.emplace(&program, state);
+
+		worker_pool::get().push([source, &program, id, state, decompile]()
+		{
+			try
+			{
+				decompile(source, program, id);
+				state->store(decompile_done);
+			}
+			catch (const std::exception& e)
+			{
+				LOG_ERROR(RSX, "Shader decompilation failed: %s", e.what());
+				state->store(decompile_failed);
+			}
+		});
+	}
+
+	// Returns false if the program is still being decompiled and wait is not set.
+	// Once the decompiled source is available it is compiled on the calling thread.
+	template <typename Program, typename Compile>
+	bool finalize_program(Program& program, Compile compile, bool wait)
+	{
+		const auto found = m_pending_programs.find(&program);
+		if (found == m_pending_programs.end())
+		{
+			return true;
+		}
+
+		u32 state;
+		while ((state = found->second->load()) == decompile_pending)
+		{
+			if (!wait)
+			{
+				return false;
+			}
+
+			std::this_thread::yield();
+		}
+
+		m_pending_programs.erase(found);
+
+		if (state == decompile_failed)
+		{
+			fmt::throw_exception("Shader program could not be decompiled" HERE);
+		}
+
+		compile(program);
+		return true;
+	}
+
 	/// bool here to inform that the program was preexisting.
-	std::tuple<const vertex_program_type&, bool> search_vertex_program(const RSXVertexProgram& rsx_vp)
+	std::tuple<vertex_program_type&, bool> search_vertex_program(const RSXVertexProgram& rsx_vp)
 	{
 		const auto& I = m_vertex_shader_cache.find(rsx_vp);
 		if (I != m_vertex_shader_cache.end())
@@ -150,13 +235,13 @@ protected:
 		}
 		LOG_NOTICE(RSX, "VP not found in buffer!");
 		vertex_program_type& new_shader = m_vertex_shader_cache[rsx_vp];
-		backend_traits::recompile_vertex_program(rsx_vp, new_shader, m_next_id++);
+		decompile_program(rsx_vp, new_shader, &backend_traits::decompile_vertex_program, &backend_traits::compile_vertex_program);
 
 		return std::forward_as_tuple(new_shader, false);
 	}
 
 	/// bool here to inform that the program was preexisting.
-	std::tuple<const fragment_program_type&, bool> search_fragment_program(const RSXFragmentProgram& rsx_fp)
+	std::tuple<fragment_program_type&, bool> search_fragment_program(const RSXFragmentProgram& rsx_fp)
 	{
 		const auto& I = m_fragment_shader_cache.find(rsx_fp);
 		if (I != m_fragment_shader_cache.end())
@@ -170,11 +255,61 @@ protected:
 		RSXFragmentProgram new_fp_key = rsx_fp;
 		new_fp_key.addr = fragment_program_ucode_copy;
 		fragment_program_type &new_shader = m_fragment_shader_cache[new_fp_key];
-		backend_traits::recompile_fragment_program(rsx_fp, new_shader, m_next_id++);
+		decompile_program(new_fp_key, new_shader, &backend_traits::decompile_fragment_program, &backend_traits::compile_fragment_program);
 
 		return std::forward_as_tuple(new_shader, false);
 	}
 
+	template<typename... Args>
+	pipeline_storage_type* find_or_build_pipeline(
+		bool wait,
+		const RSXVertexProgram& vertexShader,
+		const RSXFragmentProgram& fragmentShader,
+		pipeline_properties& pipelineProperties,
+		Args&& ...args
+		)
+	{
+		// TODO : use tie and implicit variable declaration syntax with c++17
+		const auto &vp_search = search_vertex_program(vertexShader);
+		const auto &fp_search = search_fragment_program(fragmentShader);
+		vertex_program_type &vertex_program = std::get<0>(vp_search);
+		fragment_program_type &fragment_program = std::get<0>(fp_search);
+		bool already_existing_fragment_program = std::get<1>(fp_search);
+		bool already_existing_vertex_program = std::get<1>(vp_search);
+
+		// Both programs are finalized independently so neither has to wait for the other on the next call
+		const bool vertex_program_ready = finalize_program(vertex_program, &backend_traits::compile_vertex_program, wait);
+		const bool fragment_program_ready = finalize_program(fragment_program, &backend_traits::compile_fragment_program, wait);
+
+		if (!vertex_program_ready || !fragment_program_ready)
+		{
+			return nullptr;
+		}
+
+		backend_traits::validate_pipeline_properties(vertex_program, fragment_program, pipelineProperties);
+		pipeline_key key = { vertex_program.id, fragment_program.id, pipelineProperties };
+
+		if (already_existing_fragment_program && already_existing_vertex_program)
+		{
+			const auto I = m_storage.find(key);
+			if (I != m_storage.end())
+			{
+				m_cache_miss_flag = false;
+				return &I->second;
+			}
+		}
+
+		LOG_NOTICE(RSX, "Add program :");
+		LOG_NOTICE(RSX, "*** vp id = %d", vertex_program.id);
+		LOG_NOTICE(RSX, "*** fp id = %d", fragment_program.id);
+
+		m_storage[key] = backend_traits::build_pipeline(vertex_program, fragment_program, pipelineProperties, std::forward<Args>(args)...);
+		m_cache_miss_flag = true;
+
+		LOG_SUCCESS(RSX, "New program compiled successfully");
+		return &m_storage[key];
+	}
+
 public:
 
 	struct program_buffer_patch_entry
@@ -250,6 +385,15 @@ public:
 	program_state_cache() = default;
 	~program_state_cache()
 	{
+		// Jobs still reference the cached programs and fragment ucode copies
+		for (auto& pending : m_pending_programs)
+		{
+			while (pending.second->load() == decompile_pending)
+			{
+				std::this_thread::yield();
+			}
+		}
+
 		for (auto& pair : m_fragment_shader_cache)
 		{
 			free(pair.first.addr);
@@ -272,6 +416,12 @@ public:
 		fmt::throw_exception("Trying to get unknown shader program" HERE);
 	}
 
+	// Decompile new programs on the worker pool instead of the calling thread
+	void set_async_decompilation(bool enabled)
+	{
+		m_async_decompilation = enabled;
+	}
+
 	template<typename... Args>
 	pipeline_storage_type& getGraphicPipelineState(
 		const RSXVertexProgram& vertexShader,
@@ -280,36 +430,22 @@ public:
 		Args&& ...args
 		)
 	{
-		// TODO : use tie and implicit variable declaration syntax with c++17
-		const auto &vp_search = search_vertex_program(vertexShader);
-		const auto &fp_search = search_fragment_program(fragmentShader);
-		const vertex_program_type &vertex_program = std::get<0>(vp_search);
-		const fragment_program_type &fragment_program = std::get<0>(fp_search);
-		bool already_existing_fragment_program = std::get<1>(fp_search);
-		bool already_existing_vertex_program = std::get<1>(vp_search);
-
-		backend_traits::validate_pipeline_properties(vertex_program, fragment_program, pipelineProperties);
-		pipeline_key key = { vertex_program.id, fragment_program.id, pipelineProperties };
-
-		if (already_existing_fragment_program && already_existing_vertex_program)
-		{
-			const auto I = m_storage.find(key);
-			if (I != m_storage.end())
-			{
-				m_cache_miss_flag = false;
-				return I->second;
-			}
-		}
-
-		LOG_NOTICE(RSX, "Add program :");
-		LOG_NOTICE(RSX, "*** vp id = %d", vertex_program.id);
-		LOG_NOTICE(RSX, "*** fp id = %d", fragment_program.id);
-
-		m_storage[key] = backend_traits::build_pipeline(vertex_program, fragment_program, pipelineProperties, std::forward<Args>(args)...);
-		m_cache_miss_flag = true;
+		return *find_or_build_pipeline(true, vertexShader, fragmentShader, pipelineProperties, std::forward<Args>(args)...);
+	}
 
-		LOG_SUCCESS(RSX, "New program compiled successfully");
-		return m_storage[key];
+	/**
+	* Same as getGraphicPipelineState but returns nullptr instead of blocking while one of the programs is still being decompiled.
+	* The caller is expected to skip the draw and retry with the same programs later.
+	*/
+	template<typename... Args>
+	pipeline_storage_type* try_get_graphic_pipeline_state(
+		const RSXVertexProgram& vertexShader,
+		const RSXFragmentProgram& fragmentShader,
+		pipeline_properties& pipelineProperties,
+		Args&& ...args
+		)
+	{
+		return find_or_build_pipeline(false, vertexShader, fragmentShader, pipelineProperties, std::forward<Args>(args)...);
 	}
 
 	size_t get_fragment_constants_buffer_size(const RSXFragmentProgram &fragmentShader) const
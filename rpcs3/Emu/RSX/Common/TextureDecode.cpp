@@ -0,0 +1,398 @@
+#include "stdafx.h"
+#include "TextureDecode.h"
+#include "../gcm_enums.h"
+
+namespace
+{
+	constexpr u32 expand4(u32 x) { return (x << 4) | x; }
+	constexpr u32 expand5(u32 x) { return (x << 3) | (x >> 2); }
+	constexpr u32 expand6(u32 x) { return (x << 2) | (x >> 4); }
+
+	inline u32 pack_rgba8(u32 r, u32 g, u32 b, u32 a)
+	{
+		return r | (g << 8) | (b << 16) | (a << 24);
+	}
+
+	// 16-bit lane variants of the expand helpers
+	inline __m128i expand4(__m128i x) { return _mm_or_si128(_mm_slli_epi16(x, 4), x); }
+	inline __m128i expand5(__m128i x) { return _mm_or_si128(_mm_slli_epi16(x, 3), _mm_srli_epi16(x, 2)); }
+	inline __m128i expand6(__m128i x) { return _mm_or_si128(_mm_slli_epi16(x, 2), _mm_srli_epi16(x, 4)); }
+
+	inline __m128i field(__m128i v, int shift, u16 mask)
+	{
+		return _mm_and_si128(_mm_srli_epi16(v, shift), _mm_set1_epi16(mask));
+	}
+
+	/**
+	 * Each 16bpp format provides a scalar decode for a single texel and a vector decode for 8 texels.
+	 * Source words are big endian in memory and are byteswapped before reaching either function.
+	 */
+	struct r5g6b5
+	{
+		static u32 decode(u16 v)
+		{
+			return pack_rgba8(expand5(v >> 11), expand6((v >> 5) & 0x3f), expand5(v & 0x1f), 0xff);
+		}
+
+		static void decode(__m128i v, __m128i& r, __m128i& g, __m128i& b, __m128i& a)
+		{
+			r = expand5(_mm_srli_epi16(v, 11));
+			g = expand6(field(v, 5, 0x3f));
+			b = expand5(field(v, 0, 0x1f));
+			a = _mm_set1_epi16(0xff);
+		}
+	};
+
+	struct r6g5b5
+	{
+		static u32 decode(u16 v)
+		{
+			return pack_rgba8(expand6(v >> 10), expand5((v >> 5) & 0x1f), expand5(v & 0x1f), 0xff);
+		}
+
+		static void decode(__m128i v, __m128i& r, __m128i& g, __m128i& b, __m128i& a)
+		{
+			r = expand6(_mm_srli_epi16(v, 10));
+			g = expand5(field(v, 5, 0x1f));
+			b = expand5(field(v, 0, 0x1f));
+			a = _mm_set1_epi16(0xff);
+		}
+	};
+
+	template <bool has_alpha>
+	struct x1r5g5b5
+	{
+		static u32 decode(u16 v)
+		{
+			const u32 alpha = has_alpha ? (v >> 15) * 0xff : 0xff;
+			return pack_rgba8(expand5((v >> 10) & 0x1f), expand5((v >> 5) & 0x1f), expand5(v & 0x1f), alpha);
+		}
+
+		static void decode(__m128i v, __m128i& r, __m128i& g, __m128i& b, __m128i& a)
+		{
+			r = expand5(field(v, 10, 0x1f));
+			g = expand5(field(v, 5, 0x1f));
+			b = expand5(field(v, 0, 0x1f));
+			a = has_alpha ? _mm_mullo_epi16(_mm_srli_epi16(v, 15), _mm_set1_epi16(0xff)) : _mm_set1_epi16(0xff);
+		}
+	};
+
+	struct a4r4g4b4
+	{
+		static u32 decode(u16 v)
+		{
+			return pack_rgba8(expand4((v >> 8) & 0xf), expand4((v >> 4) & 0xf), expand4(v & 0xf), expand4(v >> 12));
+		}
+
+		static void decode(__m128i v, __m128i& r, __m128i& g, __m128i& b, __m128i& a)
+		{
+			r = expand4(field(v, 8, 0xf));
+			g = expand4(field(v, 4, 0xf));
+			b = expand4(field(v, 0, 0xf));
+			a = expand4(_mm_srli_epi16(v, 12));
+		}
+	};
+
+	// Matches the backends, which upload HILO8 as a two channel RG8 texture
+	struct hilo8
+	{
+		static u32 decode(u16 v)
+		{
+			return pack_rgba8(v & 0xff, v >> 8, 0, 0xff);
+		}
+
+		static void decode(__m128i v, __m128i& r, __m128i& g, __m128i& b, __m128i& a)
+		{
+			r = field(v, 0, 0xff);
+			g = _mm_srli_epi16(v, 8);
+			b = _mm_setzero_si128();
+			a = _mm_set1_epi16(0xff);
+		}
+	};
+
+	struct g8b8
+	{
+		static u32 decode(u16 v)
+		{
+			return pack_rgba8(0, v >> 8, v & 0xff, 0xff);
+		}
+
+		static void decode(__m128i v, __m128i& r, __m128i& g, __m128i& b, __m128i& a)
+		{
+			r = _mm_setzero_si128();
+			g = _mm_srli_epi16(v, 8);
+			b = field(v, 0, 0xff);
+			a = _mm_set1_epi16(0xff);
+		}
+	};
+
+	template <typename Format>
+	void decode_16bpp(const u8* src, u32 src_pitch, u8* dst, u32 dst_pitch, u16 width, u16 height)
+	{
+		for (u32 row = 0; row < height; ++row)
+		{
+			const u8* in = src + row * src_pitch;
+			u8* out = dst + row * dst_pitch;
+			u32 x = 0;
+
+			for (; x + 8 <= width; x += 8)
+			{
+				__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + x * 2));
+				v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+
+				__m128i r, g, b, a;
+				Format::decode(v, r, g, b, a);
+
+				const __m128i rg = _mm_or_si128(r, _mm_slli_epi16(g, 8));
+				const __m128i ba = _mm_or_si128(b, _mm_slli_epi16(a, 8));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(out + x * 4), _mm_unpacklo_epi16(rg, ba));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(out + x * 4 + 16), _mm_unpackhi_epi16(rg, ba));
+			}
+
+			for (; x < width; ++x)
+			{
+				const u16 v = (in[x * 2] << 8) | in[x * 2 + 1];
+				const u32 texel = Format::decode(v);
+				std::memcpy(out + x * 4, &texel, 4);
+			}
+		}
+	}
+
+	// A8R8G8B8 / D8R8G8B8, stored as A, R, G, B bytes
+	template <bool has_alpha>
+	void decode_32bpp(const u8* src, u32 src_pitch, u8* dst, u32 dst_pitch, u16 width, u16 height)
+	{
+		const u32 alpha_mask = has_alpha ? 0 : 0xff000000;
+		const __m128i alpha_mask_vec = _mm_set1_epi32(alpha_mask);
+
+		for (u32 row = 0; row < height; ++row)
+		{
+			const u8* in = src + row * src_pitch;
+			u8* out = dst + row * dst_pitch;
+			u32 x = 0;
+
+			for (; x + 4 <= width; x += 4)
+			{
+				const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + x * 4));
+				const __m128i rotated = _mm_or_si128(_mm_srli_epi32(v, 8), _mm_slli_epi32(v, 24));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(out + x * 4), _mm_or_si128(rotated, alpha_mask_vec));
+			}
+
+			for (; x < width; ++x)
+			{
+				u32 v;
+				std::memcpy(&v, in + x * 4, 4);
+				v = ((v >> 8) | (v << 24)) | alpha_mask;
+				std::memcpy(out + x * 4, &v, 4);
+			}
+		}
+	}
+
+	// Single channel data is replicated to RGB for display
+	void decode_b8(const u8* src, u32 src_pitch, u8* dst, u32 dst_pitch, u16 width, u16 height)
+	{
+		for (u32 row = 0; row < height; ++row)
+		{
+			const u8* in = src + row * src_pitch;
+			u8* out = dst + row * dst_pitch;
+
+			for (u32 x = 0; x < width; ++x)
+			{
+				const u32 texel = pack_rgba8(in[x], in[x], in[x], 0xff);
+				std::memcpy(out + x * 4, &texel, 4);
+			}
+		}
+	}
+
+	/**
+	 * Builds the 4 entry colour palette of a DXT colour block.
+	 * DXT23/45 always use the 4 colour mode; DXT1 switches to 3 colours + transparent black when c0 <= c1.
+	 */
+	void decode_color_palette(const u8* block, bool dxt1_mode, u32 (&palette)[4])
+	{
+		const u16 c0 = block[0] | (block[1] << 8);
+		const u16 c1 = block[2] | (block[3] << 8);
+
+		const u32 r0 = expand5(c0 >> 11), g0 = expand6((c0 >> 5) & 0x3f), b0 = expand5(c0 & 0x1f);
+		const u32 r1 = expand5(c1 >> 11), g1 = expand6((c1 >> 5) & 0x3f), b1 = expand5(c1 & 0x1f);
+
+		palette[0] = pack_rgba8(r0, g0, b0, 0xff);
+		palette[1] = pack_rgba8(r1, g1, b1, 0xff);
+
+		if (!dxt1_mode || c0 > c1)
+		{
+			palette[2] = pack_rgba8((2 * r0 + r1) / 3, (2 * g0 + g1) / 3, (2 * b0 + b1) / 3, 0xff);
+			palette[3] = pack_rgba8((r0 + 2 * r1) / 3, (g0 + 2 * g1) / 3, (b0 + 2 * b1) / 3, 0xff);
+		}
+		else
+		{
+			palette[2] = pack_rgba8((r0 + r1) / 2, (g0 + g1) / 2, (b0 + b1) / 2, 0xff);
+			palette[3] = 0;
+		}
+	}
+
+	void decode_alpha_palette(const u8* block, u8 (&palette)[8])
+	{
+		const u32 a0 = block[0];
+		const u32 a1 = block[1];
+
+		palette[0] = a0;
+		palette[1] = a1;
+
+		if (a0 > a1)
+		{
+			for (u32 i = 1; i < 7; ++i)
+				palette[i + 1] = ((7 - i) * a0 + i * a1) / 7;
+		}
+		else
+		{
+			for (u32 i = 1; i < 5; ++i)
+				palette[i + 1] = ((5 - i) * a0 + i * a1) / 5;
+
+			palette[6] = 0;
+			palette[7] = 0xff;
+		}
+	}
+
+	enum class dxt_alpha
+	{
+		none,
+		explicit_4bit,
+		interpolated
+	};
+
+	template <dxt_alpha Alpha>
+	void decode_dxt(const u8* src, u32 src_pitch, u8* dst, u32 dst_pitch, u16 width, u16 height)
+	{
+		constexpr u32 block_size = Alpha == dxt_alpha::none ? 8 : 16;
+		const u32 blocks_x = (width + 3) / 4;
+		const u32 blocks_y = (height + 3) / 4;
+
+		for (u32 by = 0; by < blocks_y; ++by)
+		{
+			const u8* block_row = src + by * src_pitch;
+			const u32 rows = std::min<u32>(4, height - by * 4);
+
+			for (u32 bx = 0; bx < blocks_x; ++bx)
+			{
+				const u8* block = block_row + bx * block_size;
+				const u8* color_block = Alpha == dxt_alpha::none ? block : block + 8;
+				const u32 columns = std::min<u32>(4, width - bx * 4);
+
+				u32 palette[4];
+				decode_color_palette(color_block, Alpha == dxt_alpha::none, palette);
+
+				u8 alpha_palette[8];
+				u64 alpha_indices = 0;
+				if (Alpha == dxt_alpha::interpolated)
+				{
+					decode_alpha_palette(block, alpha_palette);
+					for (u32 i = 0; i < 6; ++i)
+						alpha_indices |= u64{ block[2 + i] } << (i * 8);
+				}
+
+				const u32 color_indices = color_block[4] | (color_block[5] << 8) | (color_block[6] << 16) | (u32{ color_block[7] } << 24);
+
+				for (u32 y = 0; y < rows; ++y)
+				{
+					u8* out = dst + (by * 4 + y) * dst_pitch + bx * 16;
+
+					for (u32 x = 0; x < columns; ++x)
+					{
+						const u32 texel_index = y * 4 + x;
+						u32 texel = palette[(color_indices >> (texel_index * 2)) & 3];
+
+						if (Alpha == dxt_alpha::explicit_4bit)
+						{
+							const u32 alpha = (block[texel_index / 2] >> ((texel_index & 1) * 4)) & 0xf;
+							texel = (texel & 0xffffff) | (expand4(alpha) << 24);
+						}
+						else if (Alpha == dxt_alpha::interpolated)
+						{
+							const u32 alpha = alpha_palette[(alpha_indices >> (texel_index * 3)) & 7];
+							texel = (texel & 0xffffff) | (alpha << 24);
+						}
+
+						std::memcpy(out + x * 4, &texel, 4);
+					}
+				}
+			}
+		}
+	}
+}
+
+namespace rsx
+{
+	bool is_cpu_decodable_format(u32 gcm_format)
+	{
+		switch (gcm_format & ~(CELL_GCM_TEXTURE_LN | CELL_GCM_TEXTURE_UN))
+		{
+		case CELL_GCM_TEXTURE_B8:
+		case CELL_GCM_TEXTURE_A1R5G5B5:
+		case CELL_GCM_TEXTURE_A4R4G4B4:
+		case CELL_GCM_TEXTURE_R5G6B5:
+		case CELL_GCM_TEXTURE_A8R8G8B8:
+		case CELL_GCM_TEXTURE_COMPRESSED_DXT1:
+		case CELL_GCM_TEXTURE_COMPRESSED_DXT23:
+		case CELL_GCM_TEXTURE_COMPRESSED_DXT45:
+		case CELL_GCM_TEXTURE_G8B8:
+		case CELL_GCM_TEXTURE_R6G5B5:
+		case CELL_GCM_TEXTURE_D1R5G5B5:
+		case CELL_GCM_TEXTURE_D8R8G8B8:
+		case CELL_GCM_TEXTURE_COMPRESSED_HILO8:
+			return true;
+		}
+
+		return false;
+	}
+
+	void decode_dxt1_to_rgba8(const u8* src, u32 src_pitch, u8* dst, u32 dst_pitch, u16 width, u16 height)
+	{
+		decode_dxt<dxt_alpha::none>(src, src_pitch, dst, dst_pitch, width, height);
+	}
+
+	void decode_dxt23_to_rgba8(const u8* src, u32 src_pitch, u8* dst, u32 dst_pitch, u16 width, u16 height)
+	{
+		decode_dxt<dxt_alpha::explicit_4bit>(src, src_pitch, dst, dst_pitch, width, height);
+	}
+
+	void decode_dxt45_to_rgba8(const u8* src, u32 src_pitch, u8* dst, u32 dst_pitch, u16 width, u16 height)
+	{
+		decode_dxt<dxt_alpha::interpolated>(src, src_pitch, dst, dst_pitch, width, height);
+	}
+
+	void decode_texture_to_rgba8(u32 gcm_format, const u8* src, u32 src_pitch, u8* dst, u32 dst_pitch, u16 width, u16 height)
+	{
+		switch (gcm_format & ~(CELL_GCM_TEXTURE_LN | CELL_GCM_TEXTURE_UN))
+		{
+		case CELL_GCM_TEXTURE_B8:
+			return decode_b8(src, src_pitch, dst, dst_pitch, width, height);
+		case CELL_GCM_TEXTURE_A1R5G5B5:
+			return decode_16bpp<x1r5g5b5<true>>(src, src_pitch, dst, dst_pitch, width, height);
+		case CELL_GCM_TEXTURE_D1R5G5B5:
+			return decode_16bpp<x1r5g5b5<false>>(src, src_pitch, dst, dst_pitch, width, height);
+		case CELL_GCM_TEXTURE_A4R4G4B4:
+			return decode_16bpp<a4r4g4b4>(src, src_pitch, dst, dst_pitch, width, height);
+		case CELL_GCM_TEXTURE_R5G6B5:
+			return decode_16bpp<r5g6b5>(src, src_pitch, dst, dst_pitch, width, height);
+		case CELL_GCM_TEXTURE_R6G5B5:
+			return decode_16bpp<r6g5b5>(src, src_pitch, dst, dst_pitch, width, height);
+		case CELL_GCM_TEXTURE_G8B8:
+			return decode_16bpp<g8b8>(src, src_pitch, dst, dst_pitch, width, height);
+		case CELL_GCM_TEXTURE_COMPRESSED_HILO8:
+			return decode_16bpp<hilo8>(src, src_pitch, dst, dst_pitch, width, height);
+		case CELL_GCM_TEXTURE_A8R8G8B8:
+			return decode_32bpp<true>(src, src_pitch, dst, dst_pitch, width, height);
+		case CELL_GCM_TEXTURE_D8R8G8B8:
+			return decode_32bpp<false>(src, src_pitch, dst, dst_pitch, width, height);
+		case CELL_GCM_TEXTURE_COMPRESSED_DXT1:
+			return decode_dxt1_to_rgba8(src, src_pitch, dst, dst_pitch, width, height);
+		case CELL_GCM_TEXTURE_COMPRESSED_DXT23:
+			return decode_dxt23_to_rgba8(src, src_pitch, dst, dst_pitch, width, height);
+		case CELL_GCM_TEXTURE_COMPRESSED_DXT45:
+			return decode_dxt45_to_rgba8(src, src_pitch, dst, dst_pitch, width, height);
+		}
+
+		fmt::throw_exception("Texture format 0x%x cannot be decoded on the CPU" HERE, gcm_format);
+	}
+}
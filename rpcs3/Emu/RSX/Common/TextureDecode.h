@@ -0,0 +1,28 @@
+#pragma once
+
+#include "Utilities/types.h"
+
+/**
+ * CPU-side decoders turning RSX texture data into tightly defined RGBA8 (R, G, B, A byte order).
+ * Used where the raw texel values are needed outside of a GPU backend (debugger previews, captures, tooling).
+ *
+ * All decoders operate on linear (unswizzled) data; swizzled sources must be passed through
+ * rsx::convert_linear_swizzle first. The texture remap registers are not applied, channels are returned as stored.
+ * Block compressed sources use src_pitch as the size in bytes of one row of 4x4 blocks.
+ */
+namespace rsx
+{
+	/**
+	 * Returns true if decode_texture_to_rgba8 accepts the format (with or without the LN/UN flags).
+	 */
+	bool is_cpu_decodable_format(u32 gcm_format);
+
+	void decode_dxt1_to_rgba8(const u8* src, u32 src_pitch, u8* dst, u32 dst_pitch, u16 width, u16 height);
+	void decode_dxt23_to_rgba8(const u8* src, u32 src_pitch, u8* dst, u32 dst_pitch, u16 width, u16 height);
+	void decode_dxt45_to_rgba8(const u8* src, u32 src_pitch, u8* dst, u32 dst_pitch, u16 width, u16 height);
+
+	/**
+	 * Decodes one mip level of a CELL_GCM_TEXTURE_* format. Throws if the format is not CPU decodable.
+	 */
+	void decode_texture_to_rgba8(u32 gcm_format, const u8* src, u32 src_pitch, u8* dst, u32 dst_pitch, u16 width, u16 height);
+}
@@ -3,6 +3,7 @@
 #include "TextureUtils.h"
 #include "../RSXThread.h"
 #include "../rsx_utils.h"
+#include "Utilities/worker_pool.h"
 
 
 namespace
@@ -25,15 +26,54 @@ namespace
 		std::copy(src.begin(), src.end(), dst.begin());
 	}
 
+	// Subresources (or sets of subresources) smaller than this are converted on the calling thread
+	constexpr u32 parallel_upload_threshold = 1 << 20;
+
+	/**
+	 * Calls func(row_begin, row_end) over [0, row_count), splitting large images across the worker pool.
+	 * Bands are 4-row aligned so that the tiled swizzle kernels apply to every band.
+	 */
+	template <typename F>
+	void for_each_row_band(u32 row_count, u32 row_size_in_bytes, F&& func)
+	{
+		if (!g_cfg.video.multithreaded_texture_upload || row_count * row_size_in_bytes < parallel_upload_threshold)
+		{
+			return func(0, row_count);
+		}
+
+		auto& pool = worker_pool::get();
+		const u32 band_count = std::min<u32>(pool.size() + 1, row_count / 4);
+
+		if (band_count <= 1)
+		{
+			return func(0, row_count);
+		}
+
+		const u32 rows_per_band = align((row_count + band_count - 1) / band_count, 4);
+
+		pool.parallel_for(band_count, [&](u32 band)
+		{
+			const u32 row_begin = band * rows_per_band;
+			const u32 row_end = std::min(row_begin + rows_per_band, row_count);
+
+			if (row_begin < row_end)
+			{
+				func(row_begin, row_end);
+			}
+		});
+	}
+
 struct copy_unmodified_block
 {
 	template<typename T, typename U>
 	static void copy_mipmap_level(gsl::span<T> dst, gsl::span<const U> src, u16 width_in_block, u16 row_count, u16 depth, u32 dst_pitch_in_block, u32 src_pitch_in_block)
 	{
-		size_t row_element_count = dst_pitch_in_block;
 		static_assert(sizeof(T) == sizeof(U), "Type size doesn't match.");
-		for (int row = 0; row < row_count * depth; ++row)
-			copy(dst.subspan(row * dst_pitch_in_block, width_in_block), src.subspan(row * src_pitch_in_block, width_in_block));
+		for_each_row_band(row_count * depth, width_in_block * sizeof(T), [&](u32 row_begin, u32 row_end)
+		{
+			for (u32 row = row_begin; row < row_end; ++row)
+				copy(dst.subspan(row * dst_pitch_in_block, width_in_block), src.subspan(row * src_pitch_in_block, width_in_block));
+		});
 	}
 };
 
@@ -42,6 +82,34 @@ struct copy_unmodified_block_swizzled
 	template<typename T, typename U>
 	static void copy_mipmap_level(gsl::span<T> dst, gsl::span<const U> src, u16 width_in_block, u16 row_count, u16 depth, u32 dst_pitch_in_block)
 	{
+		if (depth == 1)
+		{
+			const auto table = rsx::get_swizzle_offset_table(width_in_block, row_count);
+
+			if (std::is_same<T, U>::value && dst_pitch_in_block == width_in_block)
+			{
+				for_each_row_band(row_count, width_in_block * sizeof(T), [&](u32 row_begin, u32 row_end)
+				{
+					rsx::convert_linear_swizzle_rows<T>(table, (void*)src.data(), (void*)dst.data(), width_in_block, row_begin, row_end, true);
+				});
+			}
+			else
+			{
+				std::vector<U> tmp(width_in_block * row_count);
+				gsl::span<U> src_span = tmp;
+
+				for_each_row_band(row_count, width_in_block * sizeof(T), [&](u32 row_begin, u32 row_end)
+				{
+					rsx::convert_linear_swizzle_rows<U>(table, (void*)src.data(), tmp.data(), width_in_block, row_begin, row_end, true);
+
+					for (u32 row = row_begin; row < row_end; ++row)
+						copy(dst.subspan(row * dst_pitch_in_block, width_in_block), src_span.subspan(row * width_in_block, width_in_block));
+				});
+			}
+
+			return;
+		}
+
 		if (std::is_same<T, U>::value && dst_pitch_in_block == width_in_block)
 		{
 			rsx::convert_linear_swizzle_3d<T>((void*)src.data(), (void*)dst.data(), width_in_block, row_count, depth);
@@ -384,6 +452,38 @@ void upload_texture_subresource(gsl::span<gsl::byte> dst_buffer, const rsx_subre
 	}
 }
 
+void upload_texture_subresources(const std::vector<gsl::span<gsl::byte>> &dst_buffers, const std::vector<rsx_subresource_layout> &src_layouts, int format, bool is_swizzled, bool vtc_support, size_t dst_row_pitch_multiple_of)
+{
+	verify(HERE), dst_buffers.size() == src_layouts.size();
+
+	size_t total_size = 0;
+	for (const rsx_subresource_layout &layout : src_layouts)
+	{
+		total_size += layout.data.size_bytes();
+	}
+
+	if (g_cfg.video.multithreaded_texture_upload && src_layouts.size() > 1 && total_size >= parallel_upload_threshold)
+	{
+		worker_pool::get().parallel_for(::size32(src_layouts), [&](u32 index)
+		{
+			upload_texture_subresource(dst_buffers[index], src_layouts[index], format, is_swizzled, vtc_support, dst_row_pitch_multiple_of);
+		});
+
+		return;
+	}
+
+	for (size_t index = 0; index < src_layouts.size(); ++index)
+	{
+		upload_texture_subresource(dst_buffers[index], src_layouts[index], format, is_swizzled, vtc_support, dst_row_pitch_multiple_of);
+	}
+}
+
+size_t get_subresource_upload_size(const rsx_subresource_layout &layout, int format, size_t dst_row_pitch_multiple_of)
+{
+	const size_t row_pitch = align(size_t{ layout.width_in_block } * get_format_block_size_in_bytes(format), dst_row_pitch_multiple_of);
+	return row_pitch * layout.height_in_block * layout.depth;
+}
+
 /**
  * A texture is stored as an array of blocks, where a block is a pixel for standard texture
  * but is a structure containing several pixels for compressed format
@@ -58,6 +58,17 @@ std::vector<rsx_subresource_layout> get_subresources_layout(const rsx::vertex_te
 
 void upload_texture_subresource(gsl::span<gsl::byte> dst_buffer, const rsx_subresource_layout &src_layout, int format, bool is_swizzled, bool vtc_support, size_t dst_row_pitch_multiple_of);
 
+/**
+ * Upload every subresource of src_layouts into the matching span of dst_buffers.
+ * Large textures are converted in parallel (per subresource and per row band) on the shared worker pool.
+ */
+void upload_texture_subresources(const std::vector<gsl::span<gsl::byte>> &dst_buffers, const std::vector<rsx_subresource_layout> &src_layouts, int format, bool is_swizzled, bool vtc_support, size_t dst_row_pitch_multiple_of);
+
+/**
+ * Get size in bytes written by upload_texture_subresource for this layout.
+ */
+size_t get_subresource_upload_size(const rsx_subresource_layout &layout, int format, size_t dst_row_pitch_multiple_of);
+
 u8 get_format_block_size_in_bytes(int format);
 u8 get_format_block_size_in_texel(int format);
 u8 get_format_block_size_in_bytes(rsx::surface_color_format format);
@@ -46,6 +46,7 @@ struct data_heap
 	size_t m_min_guard_size; //If an allocation touches the guard region, reset the heap to avoid going over budget
 	size_t m_current_allocated_size;
 	size_t m_largest_allocated_pool;
+	u64 m_total_allocated; // Bytes consumed since init, including padding skipped when wrapping
 
 	char* m_name;
 public:
@@ -55,6 +56,7 @@ public:
 	data_heap(data_heap&&) = delete;
 
 	size_t m_get_pos; // End of free space
+	u64 m_sync_position; // Allocation counter matching m_get_pos; data allocated at or after it is not overwritten
 
 	void init(size_t heap_size, const char* buffer_name = "unnamed", size_t min_guard_size=0x10000)
 	{
@@ -63,11 +65,13 @@ public:
 		m_size = heap_size;
 		m_put_pos = 0;
 		m_get_pos = heap_size - 1;
+		m_sync_position = 0;
 
 		//allocation stats
 		m_min_guard_size = min_guard_size;
 		m_current_allocated_size = 0;
 		m_largest_allocated_pool = 0;
+		m_total_allocated = 0;
 	}
 
 	template<int Alignment>
@@ -88,16 +92,34 @@ public:
 
 		if (aligned_put_pos + alloc_size < m_size)
 		{
+			m_total_allocated += block_length;
 			m_put_pos = aligned_put_pos + alloc_size;
 			return aligned_put_pos;
 		}
 		else
 		{
+			m_total_allocated += (m_size - m_put_pos) + alloc_size;
 			m_put_pos = alloc_size;
 			return 0;
 		}
 	}
 
+	/**
+	* Monotonic allocation counter
+	*/
+	u64 get_total_allocated() const
+	{
+		return m_total_allocated;
+	}
+
+	/**
+	* Allocation counter value of the get position. Space allocated before it may be reused at any time
+	*/
+	u64 get_sync_position() const
+	{
+		return m_sync_position;
+	}
+
 	/**
 	* return current putpos - 1
 	*/
@@ -117,6 +139,7 @@ public:
 		m_current_allocated_size = 0;
 		m_largest_allocated_pool = 0;
 		m_get_pos = get_current_put_pos_minus_one();
+		m_sync_position = m_total_allocated;
 	}
 
 	// Updates the current_allocated_size metrics
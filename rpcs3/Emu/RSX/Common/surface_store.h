@@ -3,6 +3,7 @@
 #include "Utilities/GSL.h"
 #include "../GCM.h"
 #include <list>
+#include <map>
 
 namespace rsx
 {
@@ -125,8 +126,12 @@ namespace rsx
 		using surface_subresource = surface_subresource_storage<surface_type>;
 		using surface_overlap_info = surface_overlap_info_t<surface_type>;
 
-		std::unordered_map<u32, surface_storage_type> m_render_targets_storage = {};
-		std::unordered_map<u32, surface_storage_type> m_depth_stencil_storage = {};
+		// Sorted by address, so that overlap queries only visit surfaces which can reach the queried range
+		std::map<u32, surface_storage_type> m_render_targets_storage = {};
+		std::map<u32, surface_storage_type> m_depth_stencil_storage = {};
+
+		// Height of the tallest surface stored, bounds the memory span of surfaces of a given pitch
+		u32 m_max_surface_height = 0;
 
 	public:
 		std::array<std::tuple<u32, surface_type>, 4> m_bound_render_targets = {};
@@ -219,6 +224,8 @@ namespace rsx
 				invalidated_resources.push_back(std::move(old_surface_storage));
 			}
 
+			m_max_surface_height = std::max<u32>(m_max_surface_height, ::narrow<u32>(height));
+
 			if (new_surface != nullptr)
 			{
 				//New surface was found among existing surfaces
@@ -302,6 +309,8 @@ namespace rsx
 				invalidated_resources.push_back(std::move(old_surface_storage));
 			}
 
+			m_max_surface_height = std::max<u32>(m_max_surface_height, ::narrow<u32>(height));
+
 			if (new_surface != nullptr)
 			{
 				//New surface was found among existing surfaces
@@ -720,6 +729,24 @@ namespace rsx
 			return false;
 		}
 
+		/**
+		 * Visit stored surfaces of the given pitch whose base address lies in [texaddr - max span, limit), in address order.
+		 * Surfaces of that pitch starting below this range cannot reach texaddr. Stops when func returns true.
+		 */
+		template <typename F>
+		void for_each_surface_in_range(std::map<u32, surface_storage_type>& data, u32 texaddr, u32 limit, u32 pitch, F&& func)
+		{
+			// Anti-aliased surfaces may span up to twice their height in memory
+			const u64 max_span = u64{pitch} * m_max_surface_height * 2;
+			const u32 first = texaddr > max_span ? static_cast<u32>(texaddr - max_span) : 0;
+
+			for (auto It = data.lower_bound(first); It != data.end() && It->first < limit; ++It)
+			{
+				if (func(It->first, It->second))
+					return;
+			}
+		}
+
 		inline bool region_fits(u16 region_width, u16 region_height, u16 x_offset, u16 y_offset, u16 width, u16 height) const
 		{
 			if ((x_offset + width) > region_width) return false;
@@ -785,56 +812,44 @@ namespace rsx
 			u16  w;
 			u16  h;
 
-			if (!ignore_color_formats)
+			surface_subresource result = {};
+
+			auto process_list_function = [&](std::map<u32, surface_storage_type>& data, bool is_depth)
 			{
-				for (auto &tex_info : m_render_targets_storage)
+				//Only surfaces starting at or below texaddr can contain it
+				for_each_surface_in_range(data, texaddr, texaddr + 1, requested_pitch, [&](u32 this_address, surface_storage_type& storage)
 				{
-					const u32 this_address = std::get<0>(tex_info);
-					if (texaddr < this_address)
-						continue;
-
-					surface = std::get<1>(tex_info).get();
+					surface = storage.get();
 					if (surface->get_rsx_pitch() != requested_pitch)
-						continue;
+						return false;
 
 					if (requested_width == 0 || requested_height == 0)
 					{
 						if (!surface_overlaps_address_fast(surface, this_address, texaddr))
-							continue;
-						else
-							return{ this_address, surface, 0, 0, 0, 0, false, false, false };
+							return false;
+
+						result = { this_address, surface, 0, 0, 0, 0, false, is_depth, false };
+						return true;
 					}
 
 					if (test_surface(surface, this_address, x_offset, y_offset, w, h, clipped))
-						return{ this_address, surface, x_offset, y_offset, w, h, address_is_bound(this_address, false), false, clipped };
-				}
-			}
+					{
+						result = { this_address, surface, x_offset, y_offset, w, h, address_is_bound(this_address, is_depth), is_depth, clipped };
+						return true;
+					}
 
-			if (!ignore_depth_formats)
-			{
-				//Check depth surfaces for overlap
-				for (auto &tex_info : m_depth_stencil_storage)
-				{
-					const u32 this_address = std::get<0>(tex_info);
-					if (texaddr < this_address)
-						continue;
+					return false;
+				});
 
-					surface = std::get<1>(tex_info).get();
-					if (surface->get_rsx_pitch() != requested_pitch)
-						continue;
+				return result.surface != nullptr;
+			};
 
-					if (requested_width == 0 || requested_height == 0)
-					{
-						if (!surface_overlaps_address_fast(surface, this_address, texaddr))
-							continue;
-						else
-							return{ this_address, surface, 0, 0, 0, 0, false, true, false };
-					}
+			if (!ignore_color_formats && process_list_function(m_render_targets_storage, false))
+				return result;
 
-					if (test_surface(surface, this_address, x_offset, y_offset, w, h, clipped))
-						return{ this_address, surface, x_offset, y_offset, w, h, address_is_bound(this_address, true), true, clipped };
-				}
-			}
+			//Check depth surfaces for overlap
+			if (!ignore_depth_formats && process_list_function(m_depth_stencil_storage, true))
+				return result;
 
 			return{};
 		}
@@ -844,22 +859,18 @@ namespace rsx
 			std::vector<surface_overlap_info> result;
 			const u32 limit = texaddr + (required_pitch * required_height);
 
-			auto process_list_function = [&](std::unordered_map<u32, surface_storage_type>& data, bool is_depth)
+			auto process_list_function = [&](std::map<u32, surface_storage_type>& data, bool is_depth)
 			{
-				for (auto &tex_info : data)
+				for_each_surface_in_range(data, texaddr, limit, required_pitch, [&](u32 this_address, surface_storage_type& storage)
 				{
-					auto this_address = std::get<0>(tex_info);
-					if (this_address >= limit)
-						continue;
-
-					auto surface = std::get<1>(tex_info).get();
+					auto surface = storage.get();
 					const auto pitch = surface->get_rsx_pitch();
 					if (pitch != required_pitch)
-						continue;
+						return false;
 
 					const auto texture_size = pitch * surface->get_surface_height();
 					if ((this_address + texture_size) <= texaddr)
-						continue;
+						return false;
 
 					surface_overlap_info info;
 					info.surface = surface;
@@ -887,7 +898,8 @@ namespace rsx
 					}
 
 					result.push_back(info);
-				}
+					return false;
+				});
 			};
 
 			process_list_function(m_render_targets_storage, false);
@@ -3,6 +3,7 @@
 #include "../rsx_cache.h"
 #include "../rsx_utils.h"
 #include "TextureUtils.h"
+#include "Utilities/Interval.h"
 
 #include <atomic>
 
@@ -374,6 +375,9 @@ namespace rsx
 
 		shared_mutex m_cache_mutex;
 		std::unordered_map<u32, ranged_storage> m_cache;
+
+		//Page-bucketed index of section ranges, keyed by owning block and slot (see get_section_key)
+		range_index<u64> m_cache_index;
 		std::unordered_multimap<u32, std::pair<deferred_subresource, image_view_type>> m_temporary_subresource_cache;
 
 		std::atomic<u64> m_cache_update_tag = {0};
@@ -423,6 +427,37 @@ namespace rsx
 		constexpr u32 get_block_size() const { return 0x1000000; }
 		inline u32 get_block_address(u32 address) const { return (address & ~0xFFFFFF); }
 
+		static inline u64 get_section_key(u32 block_address, u32 slot) { return (u64{block_address} << 32) | slot; }
+
+		//Register the memory range assigned to a cache slot (full page-aligned range, superset of the protected range)
+		void index_section(u32 block_address, u32 slot, u32 address, u32 size)
+		{
+			const u32 last = static_cast<u32>(std::min<u64>(align<u64>(u64{address} + std::max(size, 1u), 4096) - 1, UINT32_MAX));
+			m_cache_index.insert(get_section_key(block_address, slot), make_range(address & ~4095, last));
+		}
+
+		//Visit the sections whose range overlaps [start, limit), func(section, owning block)
+		template <typename F>
+		void for_each_indexed_section(u32 start, u32 limit, F&& func)
+		{
+			if (limit <= start)
+			{
+				return;
+			}
+
+			m_cache_index.for_each_overlapping(make_range(start, limit - 1), [&](u64 key, const range_t<u32, u32>&)
+			{
+				const auto found = m_cache.find(static_cast<u32>(key >> 32));
+				const u32 slot = static_cast<u32>(key);
+
+				//Slots may have been released by the backend without updating the index
+				if (found != m_cache.end() && slot < found->second.data.size())
+				{
+					func(found->second.data[slot], found->second);
+				}
+			});
+		}
+
 		inline void update_cache_tag()
 		{
 			m_cache_update_tag++;
@@ -513,33 +548,24 @@ namespace rsx
 		std::vector<std::pair<section_storage_type*, ranged_storage*>> get_intersecting_set(u32 address, u32 range)
 		{
 			std::vector<std::pair<section_storage_type*, ranged_storage*>> result;
-			u32 last_dirty_block = UINT32_MAX;
 			const u64 cache_tag = get_system_time();
 
 			std::pair<u32, u32> trampled_range = std::make_pair(address, address + range);
 			const bool strict_range_check = g_cfg.video.write_color_buffers || g_cfg.video.write_depth_buffer;
 
-			for (auto It = m_cache.begin(); It != m_cache.end(); It++)
+			//Only sections overlapping the trampled range are visited. Repeat while the range keeps growing.
+			for (bool range_reset = true; range_reset;)
 			{
-				auto &range_data = It->second;
-				const u32 base = It->first;
-				bool range_reset = false;
+				range_reset = false;
 
-				if (base == last_dirty_block && range_data.valid_count == 0)
-					continue;
+				//overlaps_page also tests against the page containing the address
+				const u32 query_base = std::min(trampled_range.first, address & ~4095);
+				const u32 query_limit = std::max(trampled_range.second, address + 4096);
 
-				if (trampled_range.first <= trampled_range.second)
+				for_each_indexed_section(query_base, query_limit, [&](section_storage_type& tex, ranged_storage& range_data)
 				{
-					//Only if a valid range, ignore empty sets
-					if (trampled_range.first >= (range_data.max_addr + range_data.max_range) || range_data.min_addr >= trampled_range.second)
-						continue;
-				}
-
-				for (int i = 0; i < range_data.data.size(); i++)
-				{
-					auto &tex = range_data.data[i];
-					if (tex.cache_tag == cache_tag) continue; //already processed
-					if (!tex.is_locked()) continue;	//flushable sections can be 'clean' but unlocked. TODO: Handle this better
+					if (tex.cache_tag == cache_tag) return; //already processed
+					if (!tex.is_locked()) return; //flushable sections can be 'clean' but unlocked. TODO: Handle this better
 
 					auto overlapped = tex.overlaps_page(trampled_range, address, strict_range_check || tex.get_context() == rsx::texture_upload_context::blit_engine_dst);
 					if (std::get<0>(overlapped))
@@ -549,7 +575,6 @@ namespace rsx
 						if (new_range.first != trampled_range.first ||
 							new_range.second != trampled_range.second)
 						{
-							i = 0;
 							trampled_range = new_range;
 							range_reset = true;
 						}
@@ -557,13 +582,7 @@ namespace rsx
 						tex.cache_tag = cache_tag;
 						result.push_back({&tex, &range_data});
 					}
-				}
-
-				if (range_reset)
-				{
-					last_dirty_block = base;
-					It = m_cache.begin();
-				}
+				});
 			}
 
 			return result;
@@ -797,20 +816,14 @@ namespace rsx
 		{
 			std::vector<section_storage_type*> results;
 			auto test = std::make_pair(rsx_address, range);
-			for (auto &address_range : m_cache)
+			for_each_indexed_section(rsx_address & ~4095, rsx_address + range, [&](section_storage_type& tex, ranged_storage&)
 			{
-				auto &range_data = address_range.second;
-				if (!range_data.overlaps(rsx_address, range)) continue;
+				if (tex.get_section_base() > rsx_address)
+					return;
 
-				for (auto &tex : range_data.data)
-				{
-					if (tex.get_section_base() > rsx_address)
-						continue;
-
-					if (!tex.is_dirty() && tex.overlaps(test, true))
-						results.push_back(&tex);
-				}
-			}
+				if (!tex.is_dirty() && tex.overlaps(test, true))
+					results.push_back(&tex);
+			});
 
 			return results;
 		}
@@ -843,36 +856,44 @@ namespace rsx
 				auto &range_data = found->second;
 				std::pair<section_storage_type*, ranged_storage*> best_fit = {};
 
-				for (auto &tex : range_data.data)
+				//Gather slots holding this exact range, in slot order
+				std::vector<section_storage_type*> matches;
+				for_each_indexed_section(rsx_address, rsx_address + 1, [&](section_storage_type& tex, ranged_storage& owner)
 				{
-					if (tex.matches(rsx_address, rsx_size))
+					if (&owner == &range_data && tex.matches(rsx_address, rsx_size))
+						matches.push_back(&tex);
+				});
+
+				std::sort(matches.begin(), matches.end());
+
+				for (auto tex_ptr : matches)
+				{
+					auto &tex = *tex_ptr;
+					if (!tex.is_dirty())
 					{
-						if (!tex.is_dirty())
+						if (!confirm_dimensions || tex.matches(rsx_address, width, height, depth, mipmaps))
 						{
-							if (!confirm_dimensions || tex.matches(rsx_address, width, height, depth, mipmaps))
+							if (!tex.is_locked())
 							{
-								if (!tex.is_locked())
-								{
-									//Data is valid from cache pov but region has been unlocked and flushed
-									if (tex.get_context() == texture_upload_context::framebuffer_storage ||
-										tex.get_context() == texture_upload_context::blit_engine_dst)
-										range_data.notify();
-								}
-
-								return tex;
-							}
-							else
-							{
-								LOG_ERROR(RSX, "Cached object for address 0x%X was found, but it does not match stored parameters.", rsx_address);
-								LOG_ERROR(RSX, "%d x %d vs %d x %d", width, height, tex.get_width(), tex.get_height());
+								//Data is valid from cache pov but region has been unlocked and flushed
+								if (tex.get_context() == texture_upload_context::framebuffer_storage ||
+									tex.get_context() == texture_upload_context::blit_engine_dst)
+									range_data.notify();
 							}
+
+							return tex;
 						}
-						else if (!best_fit.first)
+						else
 						{
-							//By grabbing a ref to a matching entry, duplicates are avoided
-							best_fit = { &tex, &range_data };
+							LOG_ERROR(RSX, "Cached object for address 0x%X was found, but it does not match stored parameters.", rsx_address);
+							LOG_ERROR(RSX, "%d x %d vs %d x %d", width, height, tex.get_width(), tex.get_height());
 						}
 					}
+					else if (!best_fit.first)
+					{
+						//By grabbing a ref to a matching entry, duplicates are avoided
+						best_fit = { &tex, &range_data };
+					}
 				}
 
 				if (best_fit.first)
@@ -904,6 +925,7 @@ namespace rsx
 						}
 
 						range_data.notify(rsx_address, rsx_size);
+						index_section(block_address, static_cast<u32>(&tex - range_data.data.data()), rsx_address, rsx_size);
 						return tex;
 					}
 				}
@@ -911,8 +933,10 @@ namespace rsx
 
 			section_storage_type tmp;
 			update_cache_tag();
-			m_cache[block_address].add(tmp, rsx_address, rsx_size);
-			return m_cache[block_address].data.back();
+			auto &range_data = m_cache[block_address];
+			range_data.add(tmp, rsx_address, rsx_size);
+			index_section(block_address, ::size32(range_data.data) - 1, rsx_address, rsx_size);
+			return range_data.data.back();
 		}
 
 		section_storage_type* find_flushable_section(u32 address, u32 range)
@@ -1067,45 +1091,18 @@ namespace rsx
 
 			reader_lock lock(m_cache_mutex);
 
-			auto found = m_cache.find(get_block_address(address));
-			if (found != m_cache.end())
-			{
-				auto &range_data = found->second;
-				for (auto &tex : range_data.data)
-				{
-					if (tex.is_dirty()) continue;
-					if (!tex.is_flushable()) continue;
-
-					if (tex.overlaps(address, false))
-						return std::make_tuple(true, &tex);
-				}
-			}
-
-			for (auto &address_range : m_cache)
+			section_storage_type* result = nullptr;
+			for_each_indexed_section(address, address + 1, [&](section_storage_type& tex, ranged_storage&)
 			{
-				if (address_range.first == address)
-					continue;
-
-				auto &range_data = address_range.second;
+				if (result) return;
+				if (tex.is_dirty()) return;
+				if (!tex.is_flushable()) return;
 
-				//Quickly discard range
-				const u32 lock_base = address_range.first & ~0xfff;
-				const u32 lock_limit = align(range_data.max_range + address_range.first, 4096);
+				if (tex.overlaps(address, false))
+					result = &tex;
+			});
 
-				if (address < lock_base || address >= lock_limit)
-					continue;
-
-				for (auto &tex : range_data.data)
-				{
-					if (tex.is_dirty()) continue;
-					if (!tex.is_flushable()) continue;
-
-					if (tex.overlaps(address, false))
-						return std::make_tuple(true, &tex);
-				}
-			}
-
-			return std::make_tuple(false, nullptr);
+			return std::make_tuple(result != nullptr, result);
 		}
 
 		template <typename ...Args>
@@ -1307,7 +1304,16 @@ namespace rsx
 			//Free descriptor objects as well
 			for (const auto &address : empty_addresses)
 			{
-				m_cache.erase(address);
+				const auto found = m_cache.find(address);
+				if (found == m_cache.end())
+					continue;
+
+				for (u32 slot = 0; slot < found->second.data.size(); slot++)
+				{
+					m_cache_index.erase(get_section_key(address, slot));
+				}
+
+				m_cache.erase(found);
 			}
 
 			m_unreleased_texture_objects = 0;
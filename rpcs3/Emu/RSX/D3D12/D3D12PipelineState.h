@@ -107,8 +107,9 @@ struct D3D12Traits
 	using pipeline_storage_type = std::tuple<ComPtr<ID3D12PipelineState>, size_t, size_t>;
 	using pipeline_properties  = D3D12PipelineProperties;
 
+	// HLSL is compiled to bytecode along with the decompilation, nothing is left for the render thread
 	static
-	void recompile_fragment_program(const RSXFragmentProgram &RSXFP, fragment_program_type& fragmentProgramData, size_t ID)
+	void decompile_fragment_program(const RSXFragmentProgram &RSXFP, fragment_program_type& fragmentProgramData, size_t ID)
 	{
 		u32 size;
 		D3D12FragmentDecompiler FS(RSXFP, size);
@@ -135,7 +136,12 @@ struct D3D12Traits
 	}
 
 	static
-	void recompile_vertex_program(const RSXVertexProgram &RSXVP, vertex_program_type& vertexProgramData, size_t ID)
+	void compile_fragment_program(fragment_program_type&)
+	{
+	}
+
+	static
+	void decompile_vertex_program(const RSXVertexProgram &RSXVP, vertex_program_type& vertexProgramData, size_t ID)
 	{
 		D3D12VertexProgramDecompiler VS(RSXVP);
 		std::string shaderCode = VS.Decompile();
@@ -145,6 +151,11 @@ struct D3D12Traits
 		vertexProgramData.id = (u32)ID;
 	}
 
+	static
+	void compile_vertex_program(vertex_program_type&)
+	{
+	}
+
 	static
 	void validate_pipeline_properties(const vertex_program_type&, const fragment_program_type&, pipeline_properties&)
 	{
@@ -112,10 +112,20 @@ namespace {
 		u8 block_size_in_bytes = get_format_block_size_in_bytes(format);
 		u8 block_size_in_texel = get_format_block_size_in_texel(format);
 		bool is_swizzled = !(texture.format() & CELL_GCM_TEXTURE_LN);
+		std::vector<gsl::span<gsl::byte>> subresource_data;
 		size_t offset_in_buffer = 0;
 		for (const rsx_subresource_layout &layout : input_layouts)
 		{
-			upload_texture_subresource(mapped_buffer.subspan(offset_in_buffer), layout, format, is_swizzled, false, 256);
+			subresource_data.push_back(mapped_buffer.subspan(offset_in_buffer));
+			offset_in_buffer += get_subresource_upload_size(layout, format, 256);
+			offset_in_buffer = align(offset_in_buffer, 512);
+		}
+
+		upload_texture_subresources(subresource_data, input_layouts, format, is_swizzled, false, 256);
+
+		offset_in_buffer = 0;
+		for (const rsx_subresource_layout &layout : input_layouts)
+		{
 			UINT row_pitch = align(layout.width_in_block * block_size_in_bytes, 256);
 			command_list->CopyTextureRegion(&CD3DX12_TEXTURE_COPY_LOCATION(existing_texture, (UINT)mip_level), 0, 0, 0,
 				&CD3DX12_TEXTURE_COPY_LOCATION(texture_buffer_heap.get_heap(),
@@ -26,11 +26,6 @@ GLGSRender::GLGSRender() : GSRender()
 {
 	m_shaders_cache.reset(new gl::shader_cache(m_prog_buffer, "opengl", "v1.3"));
 
-	if (g_cfg.video.disable_vertex_cache)
-		m_vertex_cache.reset(new gl::null_vertex_cache());
-	else
-		m_vertex_cache.reset(new gl::weak_vertex_cache());
-
 	supports_multidraw = !g_cfg.video.strict_rendering_mode;
 	supports_native_ui = (bool)g_cfg.misc.use_native_interface;
 }
@@ -189,7 +184,7 @@ void GLGSRender::end()
 	}
 
 	std::chrono::time_point<steady_clock> state_check_end = steady_clock::now();
-	m_begin_time += (u32)std::chrono::duration_cast<std::chrono::microseconds>(state_check_end - state_check_start).count();
+	m_frame_stats.setup_time += (u32)std::chrono::duration_cast<std::chrono::microseconds>(state_check_end - state_check_start).count();
 
 	if (manually_flush_ring_buffers)
 	{
@@ -376,16 +371,29 @@ void GLGSRender::end()
 		m_samplers_dirty.store(false);
 
 		std::chrono::time_point<steady_clock> textures_end = steady_clock::now();
-		m_textures_upload_time += (u32)std::chrono::duration_cast<std::chrono::microseconds>(textures_end - textures_start).count();
+		m_frame_stats.textures_upload_time += (u32)std::chrono::duration_cast<std::chrono::microseconds>(textures_end - textures_start).count();
 	}
 
 	std::chrono::time_point<steady_clock> program_start = steady_clock::now();
 	//Load program here since it is dependent on vertex state
 
-	load_program(upload_info);
+	const bool program_ready = load_program(upload_info);
 
 	std::chrono::time_point<steady_clock> program_stop = steady_clock::now();
-	m_begin_time += (u32)std::chrono::duration_cast<std::chrono::microseconds>(program_stop - program_start).count();
+	m_frame_stats.setup_time += (u32)std::chrono::duration_cast<std::chrono::microseconds>(program_stop - program_start).count();
+
+	if (!program_ready)
+	{
+		//Shaders are still being decompiled in the background; drop this draw and retry on the next one
+		if (manually_flush_ring_buffers)
+		{
+			m_attrib_ring_buffer->unmap();
+			m_index_ring_buffer->unmap();
+		}
+
+		rsx::thread::end();
+		return;
+	}
 
 	if (manually_flush_ring_buffers)
 	{
@@ -464,7 +472,7 @@ void GLGSRender::end()
 	}
 
 	std::chrono::time_point<steady_clock> textures_end = steady_clock::now();
-	m_textures_upload_time += (u32)std::chrono::duration_cast<std::chrono::microseconds>(textures_end - textures_start).count();
+	m_frame_stats.textures_upload_time += (u32)std::chrono::duration_cast<std::chrono::microseconds>(textures_end - textures_start).count();
 
 	update_draw_state();
 
@@ -476,12 +484,13 @@ void GLGSRender::end()
 	}
 
 	const GLenum draw_mode = gl::draw_mode(rsx::method_registers.current_draw_clause.primitive);
-	bool single_draw = !supports_multidraw || (rsx::method_registers.current_draw_clause.first_count_commands.size() <= 1 || rsx::method_registers.current_draw_clause.is_disjoint_primitive);
+	const auto& constant_segments = rsx::method_registers.current_draw_clause.transform_constant_segments;
+	const u32 draw_count = ::size32(rsx::method_registers.current_draw_clause.first_count_commands);
+	const bool single_draw = constant_segments.empty() && (!supports_multidraw || draw_count <= 1 || rsx::method_registers.current_draw_clause.is_disjoint_primitive);
 
 	if (upload_info.index_info)
 	{
 		const GLenum index_type = std::get<0>(upload_info.index_info.value());
-		const u32 index_offset = std::get<1>(upload_info.index_info.value());
 		const bool restarts_valid = gl::is_primitive_native(rsx::method_registers.current_draw_clause.primitive) && !rsx::method_registers.current_draw_clause.is_disjoint_primitive;
 
 		if (gl_state.enable(restarts_valid && rsx::method_registers.restart_index_enabled(), GL_PRIMITIVE_RESTART))
@@ -490,89 +499,67 @@ void GLGSRender::end()
 		}
 
 		m_index_ring_buffer->bind();
+	}
 
-		if (single_draw)
+	if (single_draw)
+	{
+		if (upload_info.index_info)
 		{
+			const GLenum index_type = std::get<0>(upload_info.index_info.value());
+			const u32 index_offset = std::get<1>(upload_info.index_info.value());
 			glDrawElements(draw_mode, upload_info.vertex_draw_count, index_type, (GLvoid *)(uintptr_t)index_offset);
 		}
 		else
 		{
-			const auto draw_count = rsx::method_registers.current_draw_clause.first_count_commands.size();
-			const u32 type_scale = (index_type == GL_UNSIGNED_SHORT) ? 1 : 2;
-			uintptr_t index_ptr = index_offset;
-			m_scratch_buffer.resize(draw_count * 16);
-
-			GLsizei *counts = (GLsizei*)m_scratch_buffer.data();
-			const GLvoid** offsets = (const GLvoid**)(counts + draw_count);
-			int dst_index = 0;
-
-			for (const auto &range : rsx::method_registers.current_draw_clause.first_count_commands)
-			{
-				const auto index_size = get_index_count(rsx::method_registers.current_draw_clause.primitive, range.second);
-				counts[dst_index] = index_size;
-				offsets[dst_index++] = (const GLvoid*)index_ptr;
-
-				index_ptr += (index_size << type_scale);
-			}
-
-			glMultiDrawElements(draw_mode, counts, index_type, offsets, (GLsizei)draw_count);
+			glDrawArrays(draw_mode, 0, upload_info.vertex_draw_count);
 		}
 	}
+	else if (constant_segments.empty())
+	{
+		draw_ranges(draw_mode, upload_info, 0, draw_count);
+	}
 	else
 	{
-		if (single_draw)
+		//Batched draws with different transform constants; upload every set (the current registers last) and rebind between the ranges
+		const u32 constants_count = ::size32(constant_segments) + 1;
+		std::vector<u32> constants_offsets(constants_count);
+
+		if (manually_flush_ring_buffers)
 		{
-			glDrawArrays(draw_mode, 0, upload_info.vertex_draw_count);
+			m_transform_constants_buffer->reserve_storage_on_heap(8192 * constants_count);
 		}
-		else
-		{
-			const u32 base_index = rsx::method_registers.current_draw_clause.first_count_commands.front().first;
-			bool use_draw_arrays_fallback = false;
 
-			const auto draw_count = rsx::method_registers.current_draw_clause.first_count_commands.size();
-			const auto driver_caps = gl::get_driver_caps();
-
-			m_scratch_buffer.resize(draw_count * 24);
-			GLint* firsts = (GLint*)m_scratch_buffer.data();
-			GLsizei* counts = (GLsizei*)(firsts + draw_count);
-			const GLvoid** offsets = (const GLvoid**)(counts + draw_count);
-			int dst_index = 0;
-
-			for (const auto &range : rsx::method_registers.current_draw_clause.first_count_commands)
-			{
-				const GLint first = range.first - base_index;
-				const GLsizei count = range.second;
-
-				firsts[dst_index] = first;
-				counts[dst_index] = count;
-				offsets[dst_index++] = (const GLvoid*)(first << 2);
-
-				if (driver_caps.vendor_AMD && (first + count) > (0x100000 >> 2))
-				{
-					//Unlikely, but added here in case the identity buffer is not large enough somehow
-					use_draw_arrays_fallback = true;
-					break;
-				}
-			}
+		for (u32 i = 0; i < constants_count; i++)
+		{
+			const auto mapping = m_transform_constants_buffer->alloc_from_heap(8192, m_uniform_buffer_offset_align);
+			constants_offsets[i] = mapping.second;
 
-			if (use_draw_arrays_fallback)
+			if (i < constant_segments.size())
 			{
-				//MultiDrawArrays is broken on some primitive types using AMD. One known type is GL_TRIANGLE_STRIP but there could be more
-				for (const auto &range : rsx::method_registers.current_draw_clause.first_count_commands)
-				{
-					glDrawArrays(draw_mode, range.first - base_index, range.second);
-				}
+				std::memcpy(mapping.first, constant_segments[i].constants.data(), 468 * 4 * sizeof(float));
 			}
-			else if (driver_caps.vendor_AMD)
+			else
 			{
-				//Use identity index buffer to fix broken vertexID on AMD
-				m_identity_index_buffer->bind();
-				glMultiDrawElements(draw_mode, counts, GL_UNSIGNED_INT, offsets, (GLsizei)draw_count);
+				fill_vertex_program_constants_data(mapping.first);
 			}
-			else
+		}
+
+		if (manually_flush_ring_buffers)
+		{
+			m_transform_constants_buffer->unmap();
+		}
+
+		u32 first_draw = 0;
+
+		for (u32 i = 0; i < constants_count && first_draw < draw_count; i++)
+		{
+			const u32 last_draw = i < constant_segments.size() ? std::min(constant_segments[i].draw_end, draw_count) : draw_count;
+
+			if (last_draw > first_draw)
 			{
-				//Normal render
-				glMultiDrawArrays(draw_mode, firsts, counts, (GLsizei)draw_count);
+				m_transform_constants_buffer->bind_range(1, constants_offsets[i], 8192);
+				draw_ranges(draw_mode, upload_info, first_draw, last_draw);
+				first_draw = last_draw;
 			}
 		}
 	}
@@ -584,8 +571,8 @@ void GLGSRender::end()
 	m_transform_constants_buffer->notify();
 
 	std::chrono::time_point<steady_clock> draw_end = steady_clock::now();
-	m_draw_time += (u32)std::chrono::duration_cast<std::chrono::microseconds>(draw_end - draw_start).count();
-	m_draw_calls++;
+	m_frame_stats.draw_exec_time += (u32)std::chrono::duration_cast<std::chrono::microseconds>(draw_end - draw_start).count();
+	m_frame_stats.draw_calls++;
 
 	synchronize_buffers();
 	rsx::thread::end();
@@ -751,6 +738,15 @@ void GLGSRender::on_init_thread()
 	}
 
 	m_attrib_ring_buffer->create(gl::buffer::target::texture, 256 * 0x100000);
+
+	//The persistent cache tracks the attribute heap, create it once the heap exists
+	if (g_cfg.video.disable_vertex_cache)
+		m_vertex_cache.reset(new gl::null_vertex_cache());
+	else if (g_cfg.video.persistent_vertex_cache)
+		m_vertex_cache.reset(new gl::persistent_vertex_cache([this]() { return m_attrib_ring_buffer->get_total_allocated(); },
+			[this]() { return m_attrib_ring_buffer->get_sync_position(); }, m_attrib_ring_buffer->size()));
+	else
+		m_vertex_cache.reset(new gl::weak_vertex_cache());
 	m_index_ring_buffer->create(gl::buffer::target::element_array, 64 * 0x100000);
 	m_transform_constants_buffer->create(gl::buffer::target::uniform, 64 * 0x100000);
 	m_fragment_constants_buffer->create(gl::buffer::target::uniform, 16 * 0x100000);
@@ -878,6 +874,9 @@ void GLGSRender::on_init_thread()
 		m_frame->enable_wm_event_queue();
 		m_shaders_cache->load(&helper);
 	}
+
+	//Only programs discovered at runtime are decompiled in the background, the disk cache is loaded synchronously
+	m_prog_buffer.set_async_decompilation(g_cfg.video.async_shader_decompilation.get());
 }
 
 
@@ -1085,12 +1084,116 @@ bool GLGSRender::do_method(u32 cmd, u32 arg)
 	return false;
 }
 
+bool GLGSRender::can_batch_transform_constant_changes() const
+{
+	//Ranges are drawn separately from one upload, which requires their index (or vertex) offsets to be known in advance
+	const auto& clause = rsx::method_registers.current_draw_clause;
+
+	if (!gl::is_primitive_native(clause.primitive) || clause.is_immediate_draw)
+	{
+		return false;
+	}
+
+	switch (clause.command)
+	{
+	case rsx::draw_command::array:
+		return true;
+	case rsx::draw_command::indexed:
+		return !rsx::method_registers.restart_index_enabled();
+	default:
+		return false;
+	}
+}
+
+void GLGSRender::draw_ranges(GLenum draw_mode, const gl::vertex_upload_info& upload_info, u32 first_draw, u32 last_draw)
+{
+	const auto& first_count_commands = rsx::method_registers.current_draw_clause.first_count_commands;
+	const u32 draw_count = last_draw - first_draw;
+
+	if (upload_info.index_info)
+	{
+		const GLenum index_type = std::get<0>(upload_info.index_info.value());
+		const u32 index_offset = std::get<1>(upload_info.index_info.value());
+		const u32 type_scale = (index_type == GL_UNSIGNED_SHORT) ? 1 : 2;
+		uintptr_t index_ptr = index_offset;
+		m_scratch_buffer.resize(draw_count * 16);
+
+		GLsizei *counts = (GLsizei*)m_scratch_buffer.data();
+		const GLvoid** offsets = (const GLvoid**)(counts + draw_count);
+		int dst_index = 0;
+
+		for (u32 draw = 0; draw < last_draw; draw++)
+		{
+			const auto index_size = get_index_count(rsx::method_registers.current_draw_clause.primitive, first_count_commands[draw].second);
+
+			if (draw >= first_draw)
+			{
+				counts[dst_index] = index_size;
+				offsets[dst_index++] = (const GLvoid*)index_ptr;
+			}
+
+			index_ptr += (index_size << type_scale);
+		}
+
+		glMultiDrawElements(draw_mode, counts, index_type, offsets, (GLsizei)draw_count);
+		return;
+	}
+
+	const u32 base_index = first_count_commands.front().first;
+	bool use_draw_arrays_fallback = false;
+
+	const auto driver_caps = gl::get_driver_caps();
+
+	m_scratch_buffer.resize(draw_count * 24);
+	GLint* firsts = (GLint*)m_scratch_buffer.data();
+	GLsizei* counts = (GLsizei*)(firsts + draw_count);
+	const GLvoid** offsets = (const GLvoid**)(counts + draw_count);
+	int dst_index = 0;
+
+	for (u32 draw = first_draw; draw < last_draw; draw++)
+	{
+		const GLint first = first_count_commands[draw].first - base_index;
+		const GLsizei count = first_count_commands[draw].second;
+
+		firsts[dst_index] = first;
+		counts[dst_index] = count;
+		offsets[dst_index++] = (const GLvoid*)(first << 2);
+
+		if (driver_caps.vendor_AMD && (first + count) > (0x100000 >> 2))
+		{
+			//Unlikely, but added here in case the identity buffer is not large enough somehow
+			use_draw_arrays_fallback = true;
+			break;
+		}
+	}
+
+	if (use_draw_arrays_fallback)
+	{
+		//MultiDrawArrays is broken on some primitive types using AMD. One known type is GL_TRIANGLE_STRIP but there could be more
+		for (u32 draw = first_draw; draw < last_draw; draw++)
+		{
+			glDrawArrays(draw_mode, first_count_commands[draw].first - base_index, first_count_commands[draw].second);
+		}
+	}
+	else if (driver_caps.vendor_AMD)
+	{
+		//Use identity index buffer to fix broken vertexID on AMD
+		m_identity_index_buffer->bind();
+		glMultiDrawElements(draw_mode, counts, GL_UNSIGNED_INT, offsets, (GLsizei)draw_count);
+	}
+	else
+	{
+		//Normal render
+		glMultiDrawArrays(draw_mode, firsts, counts, (GLsizei)draw_count);
+	}
+}
+
 bool GLGSRender::check_program_state()
 {
 	return (rsx::method_registers.shader_program_address() != 0);
 }
 
-void GLGSRender::load_program(const gl::vertex_upload_info& upload_info)
+bool GLGSRender::load_program(const gl::vertex_upload_info& upload_info)
 {
 	if (m_graphics_state & rsx::pipeline_state::invalidate_pipeline_bits)
 	{
@@ -1103,7 +1206,15 @@ void GLGSRender::load_program(const gl::vertex_upload_info& upload_info)
 		current_fragment_program.unnormalized_coords = 0; //unused
 		void* pipeline_properties = nullptr;
 
-		m_program = &m_prog_buffer.getGraphicPipelineState(current_vertex_program, current_fragment_program, pipeline_properties);
+		auto program = m_prog_buffer.try_get_graphic_pipeline_state(current_vertex_program, current_fragment_program, pipeline_properties);
+		if (!program)
+		{
+			//Programs were consumed by the lookup above; mark them dirty again so the next draw repeats it
+			m_graphics_state |= rsx::pipeline_state::invalidate_pipeline_bits;
+			return false;
+		}
+
+		m_program = program;
 		m_program->use();
 
 		if (m_prog_buffer.check_cache_missed())
@@ -1192,6 +1303,7 @@ void GLGSRender::load_program(const gl::vertex_upload_info& upload_info)
 	}
 
 	m_graphics_state = 0;
+	return true;
 }
 
 void GLGSRender::update_draw_state()
@@ -1334,7 +1446,7 @@ void GLGSRender::update_draw_state()
 	//NV4097_SET_CLIP_ID_TEST_ENABLE
 
 	std::chrono::time_point<steady_clock> now = steady_clock::now();
-	m_begin_time += (u32)std::chrono::duration_cast<std::chrono::microseconds>(now - then).count();
+	m_frame_stats.setup_time += (u32)std::chrono::duration_cast<std::chrono::microseconds>(now - then).count();
 }
 
 void GLGSRender::flip(int buffer)
@@ -1344,15 +1456,6 @@ void GLGSRender::flip(int buffer)
 		m_frame->flip(m_context, true);
 		rsx::thread::flip(buffer);
 
-		if (!skip_frame)
-		{
-			m_draw_calls = 0;
-			m_begin_time = 0;
-			m_draw_time = 0;
-			m_vertex_upload_time = 0;
-			m_textures_upload_time = 0;
-		}
-
 		return;
 	}
 
@@ -1474,11 +1577,12 @@ void GLGSRender::flip(int buffer)
 		glViewport(0, 0, m_frame->client_width(), m_frame->client_height());
 
 		m_text_printer.print_text(0, 0, m_frame->client_width(), m_frame->client_height(), "RSX Load: " + std::to_string(get_load()) + "%");
-		m_text_printer.print_text(0, 18, m_frame->client_width(), m_frame->client_height(), "draw calls: " + std::to_string(m_draw_calls));
-		m_text_printer.print_text(0, 36, m_frame->client_width(), m_frame->client_height(), "draw call setup: " + std::to_string(m_begin_time) + "us");
-		m_text_printer.print_text(0, 54, m_frame->client_width(), m_frame->client_height(), "vertex upload time: " + std::to_string(m_vertex_upload_time) + "us");
-		m_text_printer.print_text(0, 72, m_frame->client_width(), m_frame->client_height(), "textures upload time: " + std::to_string(m_textures_upload_time) + "us");
-		m_text_printer.print_text(0, 90, m_frame->client_width(), m_frame->client_height(), "draw call execution: " + std::to_string(m_draw_time) + "us");
+		m_text_printer.print_text(0, 18, m_frame->client_width(), m_frame->client_height(), "draw calls: " + std::to_string(m_frame_stats.draw_calls));
+		m_text_printer.print_text(0, 36, m_frame->client_width(), m_frame->client_height(), "draw call setup: " + std::to_string(m_frame_stats.setup_time) + "us");
+		m_text_printer.print_text(0, 54, m_frame->client_width(), m_frame->client_height(), "vertex upload time: " + std::to_string(m_frame_stats.vertex_upload_time) + "us");
+		m_text_printer.print_text(0, 72, m_frame->client_width(), m_frame->client_height(), "textures upload time: " + std::to_string(m_frame_stats.textures_upload_time) + "us");
+		m_text_printer.print_text(0, 90, m_frame->client_width(), m_frame->client_height(), "draw call execution: " + std::to_string(m_frame_stats.draw_exec_time) + "us");
+		m_text_printer.print_text(0, 108, m_frame->client_width(), m_frame->client_height(), fmt::format("vertex cache: %u hits, %u misses", m_frame_stats.vertex_cache_hits, m_frame_stats.vertex_cache_misses));
 
 		const auto num_dirty_textures = m_gl_texture_cache.get_unreleased_textures_count();
 		const auto texture_memory_size = m_gl_texture_cache.get_texture_memory_in_use() / (1024 * 1024);
@@ -1497,16 +1601,7 @@ void GLGSRender::flip(int buffer)
 	m_gl_texture_cache.on_frame_end();
 
 	m_rtts.free_invalidated();
-	m_vertex_cache->purge();
-
-	//If we are skipping the next frame, do not reset perf counters
-	if (skip_frame) return;
-
-	m_draw_calls = 0;
-	m_begin_time = 0;
-	m_draw_time = 0;
-	m_vertex_upload_time = 0;
-	m_textures_upload_time = 0;
+	m_vertex_cache->on_frame_end();
 }
 
 bool GLGSRender::on_access_violation(u32 address, bool is_writing)
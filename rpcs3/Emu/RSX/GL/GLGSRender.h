@@ -18,6 +18,7 @@ namespace gl
 {
 	using vertex_cache = rsx::vertex_cache::default_vertex_cache<rsx::vertex_cache::uploaded_range<GLenum>, GLenum>;
 	using weak_vertex_cache = rsx::vertex_cache::weak_vertex_cache<GLenum>;
+	using persistent_vertex_cache = rsx::vertex_cache::persistent_vertex_cache<GLenum>;
 	using null_vertex_cache = vertex_cache;
 
 	using shader_cache = rsx::shaders_cache<void*, GLProgramBuffer>;
@@ -293,12 +294,6 @@ private:
 	// Identity buffer used to fix broken gl_VertexID on ATI stack
 	std::unique_ptr<gl::buffer> m_identity_index_buffer;
 
-	u32 m_draw_calls = 0;
-	s64 m_begin_time = 0;
-	s64 m_draw_time = 0;
-	s64 m_vertex_upload_time = 0;
-	s64 m_textures_upload_time = 0;
-
 	std::unique_ptr<gl::vertex_cache> m_vertex_cache;
 	std::unique_ptr<gl::shader_cache> m_shaders_cache;
 
@@ -354,7 +349,10 @@ private:
 	void init_buffers(rsx::framebuffer_creation_context context, bool skip_reading = false);
 
 	bool check_program_state();
-	void load_program(const gl::vertex_upload_info& upload_info);
+	bool load_program(const gl::vertex_upload_info& upload_info);
+
+	// Issue the draw ranges [first_draw, last_draw) of the current clause from the uploaded vertex and index data
+	void draw_ranges(GLenum draw_mode, const gl::vertex_upload_info& upload_info, u32 first_draw, u32 last_draw);
 
 	void update_draw_state();
 
@@ -377,6 +375,7 @@ public:
 protected:
 	void begin() override;
 	void end() override;
+	bool can_batch_transform_constant_changes() const override;
 
 	void on_init_thread() override;
 	void on_exit() override;
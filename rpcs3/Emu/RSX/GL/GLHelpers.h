@@ -238,6 +238,7 @@ namespace gl
 		{
 			m_value = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
 			flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+			signaled = false;
 		}
 
 		void destroy()
@@ -866,6 +867,15 @@ namespace gl
 		u32 m_data_loc = 0;
 		void *m_memory_mapping = nullptr;
 
+		//Bytes consumed since creation, including padding skipped when wrapping
+		u64 m_total_allocated = 0;
+
+		//Allocation counter at the start of the current pass through the buffer; older data gets overwritten without further synchronization
+		u64 m_sync_position = 0;
+
+		//Data allocated before the fence was referenced by commands recorded after it
+		bool m_reused_after_fence = false;
+
 		fence m_fence;
 
 	public:
@@ -905,6 +915,13 @@ namespace gl
 
 			if ((offset + alloc_size) > m_size)
 			{
+				if (m_reused_after_fence)
+				{
+					//The fence does not cover every command reading this pass; wait for all of them
+					m_fence.reset();
+					m_reused_after_fence = false;
+				}
+
 				if (!m_fence.is_empty())
 				{
 					m_fence.wait_for_signal();
@@ -915,15 +932,31 @@ namespace gl
 					glFinish();
 				}
 
+				m_total_allocated += (m_size - m_data_loc);
+				m_sync_position = m_total_allocated;
 				m_data_loc = 0;
 				offset = 0;
 			}
 
 			//Align data loc to 256; allows some "guard" region so we dont trample our own data inadvertently
-			m_data_loc = align(offset + alloc_size, 256);
+			const u32 next_loc = align(offset + alloc_size, 256);
+			m_total_allocated += (next_loc - m_data_loc);
+			m_data_loc = next_loc;
 			return std::make_pair(((char*)m_memory_mapping) + offset, offset);
 		}
 
+		//Monotonic allocation counter
+		u64 get_total_allocated() const
+		{
+			return m_total_allocated;
+		}
+
+		//Data allocated at or after this counter value is not overwritten before the commands reading it have completed
+		u64 get_sync_position() const
+		{
+			return m_sync_position;
+		}
+
 		virtual void remove()
 		{
 			if (m_memory_mapping)
@@ -954,7 +987,16 @@ namespace gl
 		{
 			//Insert fence about 25% into the buffer
 			if (m_fence.is_empty() && (m_data_loc > (m_size >> 2)))
+			{
 				m_fence.reset();
+				m_reused_after_fence = false;
+			}
+		}
+
+		//Notification of a draw command reading data allocated by earlier draws
+		void notify_reuse()
+		{
+			m_reused_after_fence = true;
 		}
 	};
 
@@ -996,7 +1038,10 @@ namespace gl
 
 			if ((offset + block_size) > m_size)
 			{
+				//Orphaning discards all previous contents, commands already recorded keep reading the old storage
 				buffer::data(m_size, nullptr);
+				m_total_allocated += m_size;
+				m_sync_position = m_total_allocated;
 				m_data_loc = 0;
 			}
 
@@ -1045,6 +1090,7 @@ namespace gl
 				real_size = align(padding + alloc_size, alignment);
 			}
 
+			m_total_allocated += (offset + real_size) - m_data_loc;
 			m_data_loc = offset + real_size;
 			m_mapped_bytes -= real_size;
 
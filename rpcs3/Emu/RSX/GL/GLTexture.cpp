@@ -421,14 +421,29 @@ namespace gl
 			height = align(height, 4);
 		}
 
+		// Convert every subresource up front so that the work can be spread across threads
+		std::vector<gsl::span<gsl::byte>> subresource_data;
+		subresource_data.reserve(input_layouts.size());
+
+		size_t offset_in_staging = 0;
+		for (const rsx_subresource_layout &layout : input_layouts)
+		{
+			const size_t size = get_subresource_upload_size(layout, format, 4);
+			subresource_data.push_back({ staging_buffer.data() + offset_in_staging, ::narrow<int>(size) });
+			offset_in_staging += size;
+		}
+
+		verify(HERE), offset_in_staging <= staging_buffer.size();
+		upload_texture_subresources(subresource_data, input_layouts, format, is_swizzled, vtc_support, 4);
+
 		if (dim == rsx::texture_dimension_extended::texture_dimension_1d)
 		{
 			if (!is_compressed_format(format))
 			{
 				for (const rsx_subresource_layout &layout : input_layouts)
 				{
-					upload_texture_subresource(staging_buffer, layout, format, is_swizzled, vtc_support, 4);
-					glTexSubImage1D(GL_TEXTURE_1D, mip_level++, 0, layout.width_in_block, gl_format, gl_type, staging_buffer.data());
+					glTexSubImage1D(GL_TEXTURE_1D, mip_level, 0, layout.width_in_block, gl_format, gl_type, subresource_data[mip_level].data());
+					mip_level++;
 				}
 			}
 			else
@@ -436,8 +451,8 @@ namespace gl
 				for (const rsx_subresource_layout &layout : input_layouts)
 				{
 					u32 size = layout.width_in_block * ((format == CELL_GCM_TEXTURE_COMPRESSED_DXT1) ? 8 : 16);
-					upload_texture_subresource(staging_buffer, layout, format, is_swizzled, vtc_support, 4);
-					glCompressedTexSubImage1D(GL_TEXTURE_1D, mip_level++, 0, layout.width_in_block * 4, gl_format, size, staging_buffer.data());
+					glCompressedTexSubImage1D(GL_TEXTURE_1D, mip_level, 0, layout.width_in_block * 4, gl_format, size, subresource_data[mip_level].data());
+					mip_level++;
 				}
 			}
 			return;
@@ -449,8 +464,8 @@ namespace gl
 			{
 				for (const rsx_subresource_layout &layout : input_layouts)
 				{
-					upload_texture_subresource(staging_buffer, layout, format, is_swizzled, vtc_support, 4);
-					glTexSubImage2D(GL_TEXTURE_2D, mip_level++, 0, 0, layout.width_in_block, layout.height_in_block, gl_format, gl_type, staging_buffer.data());
+					glTexSubImage2D(GL_TEXTURE_2D, mip_level, 0, 0, layout.width_in_block, layout.height_in_block, gl_format, gl_type, subresource_data[mip_level].data());
+					mip_level++;
 				}
 			}
 			else
@@ -458,8 +473,8 @@ namespace gl
 				for (const rsx_subresource_layout &layout : input_layouts)
 				{
 					u32 size = layout.width_in_block * layout.height_in_block * ((format == CELL_GCM_TEXTURE_COMPRESSED_DXT1) ? 8 : 16);
-					upload_texture_subresource(staging_buffer, layout, format, is_swizzled, vtc_support, 4);
-					glCompressedTexSubImage2D(GL_TEXTURE_2D, mip_level++, 0, 0, layout.width_in_block * 4, layout.height_in_block * 4, gl_format, size, staging_buffer.data());
+					glCompressedTexSubImage2D(GL_TEXTURE_2D, mip_level, 0, 0, layout.width_in_block * 4, layout.height_in_block * 4, gl_format, size, subresource_data[mip_level].data());
+					mip_level++;
 				}
 			}
 			return;
@@ -474,8 +489,7 @@ namespace gl
 			{
 				for (const rsx_subresource_layout &layout : input_layouts)
 				{
-					upload_texture_subresource(staging_buffer, layout, format, is_swizzled, vtc_support, 4);
-					glTexSubImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + mip_level / mipmap_count, mip_level % mipmap_count, 0, 0, layout.width_in_block, layout.height_in_block, gl_format, gl_type, staging_buffer.data());
+					glTexSubImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + mip_level / mipmap_count, mip_level % mipmap_count, 0, 0, layout.width_in_block, layout.height_in_block, gl_format, gl_type, subresource_data[mip_level].data());
 					mip_level++;
 				}
 			}
@@ -484,8 +498,7 @@ namespace gl
 				for (const rsx_subresource_layout &layout : input_layouts)
 				{
 					u32 size = layout.width_in_block * layout.height_in_block * ((format == CELL_GCM_TEXTURE_COMPRESSED_DXT1) ? 8 : 16);
-					upload_texture_subresource(staging_buffer, layout, format, is_swizzled, vtc_support, 4);
-					glCompressedTexSubImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + mip_level / mipmap_count, mip_level % mipmap_count, 0, 0, layout.width_in_block * 4, layout.height_in_block * 4, gl_format, size, staging_buffer.data());
+					glCompressedTexSubImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + mip_level / mipmap_count, mip_level % mipmap_count, 0, 0, layout.width_in_block * 4, layout.height_in_block * 4, gl_format, size, subresource_data[mip_level].data());
 					mip_level++;
 				}
 			}
@@ -498,8 +511,8 @@ namespace gl
 			{
 				for (const rsx_subresource_layout &layout : input_layouts)
 				{
-					upload_texture_subresource(staging_buffer, layout, format, is_swizzled, vtc_support, 4);
-					glTexSubImage3D(GL_TEXTURE_3D, mip_level++, 0, 0, 0, layout.width_in_block, layout.height_in_block, depth, gl_format, gl_type, staging_buffer.data());
+					glTexSubImage3D(GL_TEXTURE_3D, mip_level, 0, 0, 0, layout.width_in_block, layout.height_in_block, depth, gl_format, gl_type, subresource_data[mip_level].data());
+					mip_level++;
 				}
 			}
 			else
@@ -507,8 +520,8 @@ namespace gl
 				for (const rsx_subresource_layout &layout : input_layouts)
 				{
 					u32 size = layout.width_in_block * layout.height_in_block * layout.depth * ((format == CELL_GCM_TEXTURE_COMPRESSED_DXT1) ? 8 : 16);
-					upload_texture_subresource(staging_buffer, layout, format, is_swizzled, vtc_support, 4);
-					glCompressedTexSubImage3D(GL_TEXTURE_3D, mip_level++, 0, 0, 0, layout.width_in_block * 4, layout.height_in_block * 4, layout.depth, gl_format, size, staging_buffer.data());
+					glCompressedTexSubImage3D(GL_TEXTURE_3D, mip_level, 0, 0, 0, layout.width_in_block * 4, layout.height_in_block * 4, layout.depth, gl_format, size, subresource_data[mip_level].data());
+					mip_level++;
 				}
 			}
 			return;
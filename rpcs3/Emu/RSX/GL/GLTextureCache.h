@@ -723,6 +723,7 @@ namespace gl
 				range_data.data.resize(0);
 			}
 
+			m_cache_index.clear();
 			clear_temporary_subresources();
 			m_unreleased_texture_objects = 0;
 		}
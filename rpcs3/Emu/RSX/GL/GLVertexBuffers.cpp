@@ -202,7 +202,6 @@ gl::vertex_upload_info GLGSRender::set_vertex_buffer()
 	{
 		//Check if cacheable
 		//Only data in the 'persistent' block may be cached
-		//TODO: make vertex cache keep local data beyond frame boundaries and hook notify command
 		bool in_cache = false;
 		bool to_store = false;
 		u32  storage_address = UINT32_MAX;
@@ -210,15 +209,18 @@ gl::vertex_upload_info GLGSRender::set_vertex_buffer()
 		if (m_vertex_layout.interleaved_blocks.size() == 1 &&
 			rsx::method_registers.current_draw_clause.command != rsx::draw_command::inlined_array)
 		{
-			storage_address = m_vertex_layout.interleaved_blocks[0].real_offset_address + vertex_base;
+			storage_address = get_persistent_block_address(m_vertex_layout.interleaved_blocks[0], vertex_base);
 			if (auto cached = m_vertex_cache->find_vertex_range(storage_address, GL_R8UI, required.first))
 			{
 				in_cache = true;
 				upload_info.persistent_mapping_offset = cached->offset_in_heap;
+				m_attrib_ring_buffer->notify_reuse();
+				m_frame_stats.vertex_cache_hits++;
 			}
 			else
 			{
 				to_store = true;
+				m_frame_stats.vertex_cache_misses++;
 			}
 		}
 
@@ -267,7 +269,7 @@ gl::vertex_upload_info GLGSRender::set_vertex_buffer()
 	write_vertex_data_to_memory(m_vertex_layout, vertex_base, vertex_count, persistent_mapping.first, volatile_mapping.first);
 
 	std::chrono::time_point<steady_clock> now = steady_clock::now();
-	m_vertex_upload_time += std::chrono::duration_cast<std::chrono::microseconds>(now - then).count();
+	m_frame_stats.vertex_upload_time += std::chrono::duration_cast<std::chrono::microseconds>(now - then).count();
 	return upload_info;
 }
 
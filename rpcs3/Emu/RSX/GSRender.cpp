@@ -56,4 +56,6 @@ void GSRender::flip(int buffer)
 	{
 		m_frame->flip(m_context);
 	}
+
+	rsx::thread::flip(buffer);
 }
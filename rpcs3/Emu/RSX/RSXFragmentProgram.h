@@ -236,6 +236,9 @@ struct RSXFragmentProgram
 
 	bool valid;
 
+	// Cached result of get_fragment_program_ucode_hash for addr, 0 if not computed
+	size_t ucode_hash;
+
 	rsx::texture_dimension_extended get_texture_dimension(u8 id) const
 	{
 		return (rsx::texture_dimension_extended)((texture_dimensions >> (id * 2)) & 0x3);
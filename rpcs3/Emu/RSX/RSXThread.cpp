@@ -15,6 +15,8 @@
 #include "Utilities/GSL.h"
 #include "Utilities/StrUtil.h"
 
+#include "xxhash.h"
+
 #include <thread>
 #include <unordered_set>
 #include <fenv.h>
@@ -409,6 +411,32 @@ namespace rsx
 		std::vector<u32> deferred_stack;
 		bool has_deferred_call = false;
 
+		// Upper bound of constant snapshots kept by one batch (8KB each)
+		const u32 max_transform_constant_segments = 64;
+
+		// Segments of the pending batch relevant to its draws [begin, end), renumbered from begin
+		const auto select_transform_constant_segments = [](std::vector<draw_clause::transform_constant_segment>& dst,
+			const std::vector<draw_clause::transform_constant_segment>& src, u32 begin, u32 end)
+		{
+			dst.clear();
+
+			for (const auto& segment : src)
+			{
+				if (segment.draw_end <= begin)
+				{
+					continue;
+				}
+
+				dst.push_back(segment);
+				dst.back().draw_end = std::min(segment.draw_end, end) - begin;
+
+				if (segment.draw_end >= end)
+				{
+					break;
+				}
+			}
+		};
+
 		// Track register address faults
 		u32 mem_faults_count = 0;
 
@@ -443,6 +471,7 @@ namespace rsx
 
 					deferred_stack.push_back(num_draws); //Append last pair
 					std::vector<std::pair<u32, u32>> temp_range = first_counts;
+					auto temp_segments = std::move(rsx::method_registers.current_draw_clause.transform_constant_segments);
 					auto current_command = rsx::method_registers.current_draw_clause.command;
 
 					u32 last_index = 0;
@@ -457,6 +486,7 @@ namespace rsx
 						//NOTE: These values are reset if begin command is emitted
 						first_counts.resize(draw - last_index);
 						std::copy(temp_range.begin() + last_index, temp_range.begin() + draw, first_counts.begin());
+						select_transform_constant_segments(rsx::method_registers.current_draw_clause.transform_constant_segments, temp_segments, last_index, draw);
 						rsx::method_registers.current_draw_clause.command = current_command;
 
 						methods[NV4097_SET_BEGIN_END](this, NV4097_SET_BEGIN_END, 0);
@@ -470,6 +500,8 @@ namespace rsx
 			if (emit_end)
 				methods[NV4097_SET_BEGIN_END](this, NV4097_SET_BEGIN_END, 0);
 
+			rsx::method_registers.current_draw_clause.transform_constant_segments.clear();
+
 			if (deferred_begin_end > 0) //Hanging draw call (useful for immediate rendering where the begin call needs to be noted)
 				methods[NV4097_SET_BEGIN_END](this, NV4097_SET_BEGIN_END, deferred_primitive_type);
 
@@ -479,6 +511,15 @@ namespace rsx
 			has_deferred_call = false;
 		};
 
+		const bool collect_statistics = !!frame_statistics_callback;
+		std::chrono::time_point<steady_clock> fifo_start;
+
+		const auto end_fifo_timing = [&](u32 method_count)
+		{
+			m_frame_stats.method_count += method_count;
+			m_fifo_time_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(steady_clock::now() - fifo_start).count();
+		};
+
 		// TODO: exit condition
 		while (!Emu.IsStopped())
 		{
@@ -700,9 +741,60 @@ namespace rsx
 				performance_counters.state = FIFO_state::running;
 			}
 
+			if (collect_statistics)
+			{
+				fifo_start = steady_clock::now();
+			}
+
+			const bool non_increment = (cmd & RSX_METHOD_NON_INCREMENT_CMD_MASK) == RSX_METHOD_NON_INCREMENT_CMD;
+
+			// Runs of registers which are only stored are written in bulk
+			if (count > 1 && !capture_current_frame && is_plain_method_run(first_cmd, non_increment ? 1 : count))
+			{
+				if (supports_multidraw && has_deferred_call)
+				{
+					//Pending draws survive runs which only rewrite the current values
+					bool redundant = true;
+
+					if (non_increment)
+					{
+						redundant = is_redundant_method(first_cmd, args[count - 1]);
+					}
+					else
+					{
+						for (u32 i = 0; i < count && redundant; i++)
+						{
+							redundant = is_redundant_method(first_cmd + i, args[i]);
+						}
+					}
+
+					if (!redundant)
+					{
+						flush_command_queue();
+					}
+				}
+
+				if (non_increment)
+				{
+					method_registers.decode(first_cmd, args[count - 1]);
+				}
+				else
+				{
+					method_registers.decode(first_cmd, args.get_ptr(), count);
+				}
+
+				if (collect_statistics)
+				{
+					end_fifo_timing(count);
+				}
+
+				internal_get += (count + 1) * 4;
+				continue;
+			}
+
 			for (u32 i = 0; i < count; i++)
 			{
-				u32 reg = ((cmd & RSX_METHOD_NON_INCREMENT_CMD_MASK) == RSX_METHOD_NON_INCREMENT_CMD) ? first_cmd : first_cmd + i;
+				u32 reg = non_increment ? first_cmd : first_cmd + i;
 				u32 value = args[i];
 
 				bool execute_method_call = true;
@@ -712,141 +804,116 @@ namespace rsx
 				{
 					//TODO: Make this cleaner
 					bool flush_commands_flag = has_deferred_call;
+					const u8 attributes = method_attributes[reg];
 
-					switch (reg)
+					if (attributes & method_draw_control)
 					{
-					case NV4097_SET_BEGIN_END:
-					{
-						// Hook; Allows begin to go through, but ignores end
-						if (value)
-							deferred_begin_end++;
-						else
-							deferred_begin_end--;
-
-						if (value && value != deferred_primitive_type)
-							deferred_primitive_type = value;
-						else
+						switch (reg)
 						{
-							has_deferred_call = true;
-							flush_commands_flag = false;
-							execute_method_call = false;
-
-							deferred_call_size++;
+						case NV4097_SET_BEGIN_END:
+						{
+							// Hook; Allows begin to go through, but ignores end
+							if (value)
+								deferred_begin_end++;
+							else
+								deferred_begin_end--;
 
-							if (!method_registers.current_draw_clause.is_disjoint_primitive)
+							if (value && value != deferred_primitive_type)
+								deferred_primitive_type = value;
+							else
 							{
-								// Combine all calls since the last one
-								auto &first_count = method_registers.current_draw_clause.first_count_commands;
-								if (first_count.size() > deferred_call_size)
-								{
-									const auto &batch_first_count = first_count[deferred_call_size - 1];
-									u32 count = batch_first_count.second;
-									u32 next = batch_first_count.first + count;
+								has_deferred_call = true;
+								flush_commands_flag = false;
+								execute_method_call = false;
 
-									for (int n = deferred_call_size; n < first_count.size(); n++)
+								deferred_call_size++;
+
+								if (!method_registers.current_draw_clause.is_disjoint_primitive)
+								{
+									// Combine all calls since the last one
+									auto &first_count = method_registers.current_draw_clause.first_count_commands;
+									if (first_count.size() > deferred_call_size)
 									{
-										if (first_count[n].first != next)
+										const auto &batch_first_count = first_count[deferred_call_size - 1];
+										u32 count = batch_first_count.second;
+										u32 next = batch_first_count.first + count;
+
+										for (int n = deferred_call_size; n < first_count.size(); n++)
 										{
-											LOG_ERROR(RSX, "Non-continuous first-count range passed as one draw; will be split.");
+											if (first_count[n].first != next)
+											{
+												LOG_ERROR(RSX, "Non-continuous first-count range passed as one draw; will be split.");
+
+												first_count[deferred_call_size - 1].second = count;
+												deferred_call_size++;
 
-											first_count[deferred_call_size - 1].second = count;
-											deferred_call_size++;
+												count = first_count[deferred_call_size - 1].second;
+												next = first_count[deferred_call_size - 1].first + count;
+												continue;
+											}
 
-											count = first_count[deferred_call_size - 1].second;
-											next = first_count[deferred_call_size - 1].first + count;
-											continue;
+											count += first_count[n].second;
+											next += first_count[n].second;
 										}
 
-										count += first_count[n].second;
-										next += first_count[n].second;
+										first_count[deferred_call_size - 1].second = count;
+										first_count.resize(deferred_call_size);
 									}
-
-									first_count[deferred_call_size - 1].second = count;
-									first_count.resize(deferred_call_size);
 								}
 							}
-						}
 
-						break;
-					}
-					// These commands do not alter the pipeline state and deferred calls can still be active
-					// TODO: Add more commands here
-					case NV4097_INVALIDATE_VERTEX_FILE:
-						flush_commands_flag = false;
-						break;
-					case NV4097_DRAW_ARRAYS:
-					{
-						const auto cmd = method_registers.current_draw_clause.command;
-						if (cmd != rsx::draw_command::array && cmd != rsx::draw_command::none)
 							break;
+						}
+						// These commands do not alter the pipeline state and deferred calls can still be active
+						// TODO: Add more commands here
+						case NV4097_INVALIDATE_VERTEX_FILE:
+							flush_commands_flag = false;
+							break;
+						case NV4097_DRAW_ARRAYS:
+						{
+							const auto cmd = method_registers.current_draw_clause.command;
+							if (cmd != rsx::draw_command::array && cmd != rsx::draw_command::none)
+								break;
 
-						flush_commands_flag = false;
-						break;
-					}
-					case NV4097_DRAW_INDEX_ARRAY:
-					{
-						const auto cmd = method_registers.current_draw_clause.command;
-						if (cmd != rsx::draw_command::indexed && cmd != rsx::draw_command::none)
+							flush_commands_flag = false;
 							break;
+						}
+						case NV4097_DRAW_INDEX_ARRAY:
+						{
+							const auto cmd = method_registers.current_draw_clause.command;
+							if (cmd != rsx::draw_command::indexed && cmd != rsx::draw_command::none)
+								break;
 
-						flush_commands_flag = false;
-						break;
+							flush_commands_flag = false;
+							break;
+						}
+						}
 					}
-					default:
+					else if (has_deferred_call)
 					{
-						//TODO: Reorder draw commands between synchronization events to maximize batched sizes
-						static const std::pair<u32, u32> skippable_ranges[] =
+						//Writes which do not change any state can be dropped so the batch can keep growing
+						if (is_redundant_method(reg, value))
 						{
-							//Texture configuration
-							{ NV4097_SET_TEXTURE_OFFSET, 8 * 16 },
-							{ NV4097_SET_TEXTURE_CONTROL2, 16 },
-							{ NV4097_SET_TEXTURE_CONTROL3, 16 },
-							{ NV4097_SET_VERTEX_TEXTURE_OFFSET, 8 * 4 },
-							//Surface configuration
-							{ NV4097_SET_SURFACE_CLIP_HORIZONTAL, 1 },
-							{ NV4097_SET_SURFACE_CLIP_VERTICAL, 1 },
-							{ NV4097_SET_SURFACE_COLOR_AOFFSET, 1 },
-							{ NV4097_SET_SURFACE_COLOR_BOFFSET, 1 },
-							{ NV4097_SET_SURFACE_COLOR_COFFSET, 1 },
-							{ NV4097_SET_SURFACE_COLOR_DOFFSET, 1 },
-							{ NV4097_SET_SURFACE_ZETA_OFFSET, 1 },
-							{ NV4097_SET_CONTEXT_DMA_COLOR_A, 1 },
-							{ NV4097_SET_CONTEXT_DMA_COLOR_B, 1 },
-							{ NV4097_SET_CONTEXT_DMA_COLOR_C, 1 },
-							{ NV4097_SET_CONTEXT_DMA_COLOR_D, 1 },
-							{ NV4097_SET_CONTEXT_DMA_ZETA, 1 },
-							{ NV4097_SET_SURFACE_FORMAT, 1 },
-							{ NV4097_SET_SURFACE_PITCH_A, 1 },
-							{ NV4097_SET_SURFACE_PITCH_B, 1 },
-							{ NV4097_SET_SURFACE_PITCH_C, 1 },
-							{ NV4097_SET_SURFACE_PITCH_D, 1 },
-							{ NV4097_SET_SURFACE_PITCH_Z, 1 }
-						};
-
-						if (has_deferred_call)
+							execute_method_call = false;
+							flush_commands_flag = false;
+						}
+						else if ((reg == NV4097_SET_TRANSFORM_CONSTANT_LOAD || (attributes & method_transform_constant)) &&
+							!deferred_begin_end && !capture_current_frame && can_batch_transform_constant_changes())
 						{
-							//Hopefully this is skippable so the batch can keep growing
-							for (const auto &method : skippable_ranges)
-							{
-								if (reg < method.first)
-									continue;
-
-								if (reg - method.first < method.second)
-								{
-									//Safe to ignore if value has not changed
-									if (method_registers.test(reg, value))
-									{
-										execute_method_call = false;
-										flush_commands_flag = false;
-									}
+							//Constant uploads between draws keep the batch open; the draws so far keep a copy of the constants they use
+							auto& clause = method_registers.current_draw_clause;
+							const u32 draws = ::size32(clause.first_count_commands);
 
-									break;
-								}
+							if (reg == NV4097_SET_TRANSFORM_CONSTANT_LOAD || (!clause.transform_constant_segments.empty() && clause.transform_constant_segments.back().draw_end == draws))
+							{
+								flush_commands_flag = false;
+							}
+							else if (clause.transform_constant_segments.size() < max_transform_constant_segments)
+							{
+								clause.transform_constant_segments.push_back({ draws, method_registers.transform_constants });
+								flush_commands_flag = false;
 							}
 						}
-
-						break;
-					}
 					}
 
 					if (flush_commands_flag)
@@ -909,6 +976,11 @@ namespace rsx
 				}
 			}
 
+			if (collect_statistics)
+			{
+				end_fifo_timing(count);
+			}
+
 			if (unaligned_command && invalid_command_interrupt_raised)
 			{
 				//This is almost guaranteed to be heap corruption at this point
@@ -1345,21 +1417,27 @@ namespace rsx
 		if (!(m_graphics_state & rsx::pipeline_state::vertex_program_dirty))
 			return;
 
-		m_graphics_state &= ~(rsx::pipeline_state::vertex_program_dirty);
-		const u32 transform_program_start = rsx::method_registers.transform_program_start();
 		current_vertex_program.output_mask = rsx::method_registers.vertex_attrib_output_mask();
 		current_vertex_program.skip_vertex_input_check = false;
 
 		current_vertex_program.rsx_vertex_inputs.resize(0);
-		current_vertex_program.data.resize((512 - transform_program_start) * 4);
 
-		u32* ucode_src = rsx::method_registers.transform_program.data() + (transform_program_start * 4);
-		u32* ucode_dst = current_vertex_program.data.data();
+		if (m_graphics_state & rsx::pipeline_state::vertex_ucode_dirty)
+		{
+			const u32 transform_program_start = rsx::method_registers.transform_program_start();
+			current_vertex_program.data.resize((512 - transform_program_start) * 4);
+
+			u32* ucode_src = rsx::method_registers.transform_program.data() + (transform_program_start * 4);
+			u32* ucode_dst = current_vertex_program.data.data();
+
+			memcpy(ucode_dst, ucode_src, current_vertex_program.data.size() * sizeof(u32));
 
-		memcpy(ucode_dst, ucode_src, current_vertex_program.data.size() * sizeof(u32));
+			current_vp_metadata = program_hash_util::vertex_program_utils::analyse_vertex_program(current_vertex_program.data);
+			current_vertex_program.data.resize(current_vp_metadata.ucode_size);
+			current_vertex_program.ucode_hash = program_hash_util::vertex_program_utils::get_vertex_program_ucode_hash(current_vertex_program);
+		}
 
-		current_vp_metadata = program_hash_util::vertex_program_utils::analyse_vertex_program(current_vertex_program.data);
-		current_vertex_program.data.resize(current_vp_metadata.ucode_size);
+		m_graphics_state &= ~(rsx::pipeline_state::vertex_program_dirty | rsx::pipeline_state::vertex_ucode_dirty);
 
 		const u32 input_mask = rsx::method_registers.vertex_attrib_input_mask();
 		const u32 modulo_mask = rsx::method_registers.frequency_divider_operation_mask();
@@ -1572,13 +1650,32 @@ namespace rsx
 
 		const u32 program_location = (shader_program & 0x3) - 1;
 		const u32 program_offset = (shader_program & ~0x3);
+		const u32 program_address = rsx::get_address(program_offset, program_location);
 
-		result.addr = vm::base(rsx::get_address(program_offset, program_location));
-		current_fp_metadata = program_hash_util::fragment_program_utils::analyse_fragment_program(result.addr);
+		result.addr = vm::base(program_address);
+
+		//Most invalidations come from texture state; only re-analyse the ucode if its bytes changed
+		auto &fingerprint = m_fragment_ucode_fingerprint;
+		if (fingerprint.address != program_address || !fingerprint.size || XXH64(result.addr, fingerprint.size, 0) != fingerprint.hash)
+		{
+			current_fp_metadata = program_hash_util::fragment_program_utils::analyse_fragment_program(result.addr);
+
+			fingerprint.address = program_address;
+			fingerprint.size = current_fp_metadata.program_start_offset + current_fp_metadata.program_ucode_length;
+			fingerprint.hash = XXH64(result.addr, fingerprint.size, 0);
+			fingerprint.ucode_hash = 0;
+		}
 
 		result.addr = ((u8*)result.addr + current_fp_metadata.program_start_offset);
 		result.offset = program_offset + current_fp_metadata.program_start_offset;
 		result.valid = true;
+
+		if (!fingerprint.ucode_hash)
+		{
+			fingerprint.ucode_hash = program_hash_util::fragment_program_utils::get_fragment_program_ucode_hash(result);
+		}
+
+		result.ucode_hash = fingerprint.ucode_hash;
 		result.ctrl = rsx::method_registers.shader_control() & (CELL_GCM_SHADER_CONTROL_32_BITS_EXPORTS | CELL_GCM_SHADER_CONTROL_DEPTH_EXPORT);
 		result.unnormalized_coords = 0;
 		result.front_back_color_enabled = !rsx::method_registers.two_side_light_en();
@@ -2160,7 +2257,6 @@ namespace rsx
 			for (const auto &block : layout.interleaved_blocks)
 			{
 				u32 unique_verts;
-				u32 vertex_base = 0;
 
 				if (block.single_vertex)
 				{
@@ -2179,16 +2275,24 @@ namespace rsx
 				else
 				{
 					unique_verts = vertex_count;
-					vertex_base = first_vertex * block.attribute_stride;
 				}
 
 				const u32 data_size = block.attribute_stride * unique_verts;
-				memcpy(persistent, (char*)vm::base(block.real_offset_address) + vertex_base, data_size);
+				memcpy(persistent, vm::base(get_persistent_block_address(block, first_vertex)), data_size);
 				persistent += data_size;
 			}
 		}
 	}
 
+	u32 thread::get_persistent_block_address(const interleaved_range_info& block, u32 first_vertex) const
+	{
+		//Blocks using frequency dividers always start from the first element
+		if (block.single_vertex || block.min_divisor > 1)
+			return block.real_offset_address;
+
+		return block.real_offset_address + first_vertex * block.attribute_stride;
+	}
+
 	void thread::flip(int buffer)
 	{
 		if (g_cfg.video.frame_skip_enabled)
@@ -2212,6 +2316,19 @@ namespace rsx
 		}
 
 		performance_counters.sampled_frames++;
+
+		//Counters keep accumulating while frames are being skipped
+		if (skip_frame)
+			return;
+
+		if (frame_statistics_callback)
+		{
+			m_frame_stats.fifo_time = m_fifo_time_ns / 1000;
+			frame_statistics_callback(m_frame_stats);
+		}
+
+		m_frame_stats = {};
+		m_fifo_time_ns = 0;
 	}
 
 	void thread::check_zcull_status(bool framebuffer_swap)
@@ -76,6 +76,7 @@ namespace rsx
 		fragment_state_dirty = 4,
 		vertex_state_dirty = 8,
 		transform_constants_dirty = 16,
+		vertex_ucode_dirty = 32, // Transform program contents or start slot changed; vertex_program_dirty alone only refreshes IO state
 
 		invalidate_pipeline_bits = fragment_program_dirty | vertex_program_dirty,
 		all_dirty = 255
@@ -269,6 +270,23 @@ namespace rsx
 
 	struct sampled_image_descriptor_base;
 
+	// CPU time spent per frame, in microseconds
+	struct frame_statistics_t
+	{
+		u32 draw_calls = 0;
+		u32 method_count = 0;
+
+		s64 fifo_time = 0;            // Method decode and dispatch, includes the backend times below
+		s64 setup_time = 0;           // Draw state, surface and program setup
+		s64 vertex_upload_time = 0;   // Vertex/index streaming including vertex cache lookups
+		s64 textures_upload_time = 0; // Texture cache lookups and uploads
+		s64 draw_exec_time = 0;
+		s64 flip_time = 0;
+
+		u32 vertex_cache_hits = 0;
+		u32 vertex_cache_misses = 0;
+	};
+
 	class thread : public named_thread
 	{
 		std::shared_ptr<thread_ctrl> m_vblank_thread;
@@ -294,6 +312,9 @@ namespace rsx
 		rsx::gcm_framebuffer_info m_depth_surface_info;
 		bool framebuffer_status_valid = false;
 
+		frame_statistics_t m_frame_stats;
+		s64 m_fifo_time_ns = 0;
+
 		std::unique_ptr<rsx::overlays::user_interface> m_custom_ui;
 		std::unique_ptr<rsx::overlays::user_interface> m_invalidated_ui;
 
@@ -323,8 +344,12 @@ namespace rsx
 		GcmZcullInfo zculls[limits::zculls_count];
 
 		bool capture_current_frame = false;
+		u32 capture_frames_left = 0;
 		void capture_frame(const std::string &name);
 
+		//Receives the statistics of every presented frame, must be set before the thread starts
+		std::function<void(const frame_statistics_t&)> frame_statistics_callback;
+
 	public:
 		std::shared_ptr<class ppu_thread> intr_thread;
 
@@ -367,6 +392,16 @@ namespace rsx
 		program_hash_util::fragment_program_utils::fragment_program_metadata current_fp_metadata = {};
 		program_hash_util::vertex_program_utils::vertex_program_metadata current_vp_metadata = {};
 
+		// Fingerprint of the fragment ucode range covered by current_fp_metadata, used to skip re-analysis of unchanged programs
+		struct
+		{
+			u32 address;
+			u32 size;
+			u64 hash;
+			size_t ucode_hash;
+		}
+		m_fragment_ucode_fingerprint = {};
+
 		void get_current_vertex_program();
 
 		/**
@@ -424,6 +459,10 @@ namespace rsx
 		virtual void begin();
 		virtual void end();
 
+		// Whether the pending draw clause can be submitted in one end() call with transform constants changing between its draws
+		// (see draw_clause::transform_constant_segments). Backends returning false get the batch flushed before the upload.
+		virtual bool can_batch_transform_constant_changes() const { return false; }
+
 		virtual void on_init_rsx() = 0;
 		virtual void on_init_thread() = 0;
 		virtual bool do_method(u32 /*cmd*/, u32 /*value*/) { return false; }
@@ -482,6 +521,11 @@ namespace rsx
 		 */
 		void write_vertex_data_to_memory(const vertex_input_layout& layout, u32 first_vertex, u32 vertex_count, void *persistent_data, void *volatile_data);
 
+		/**
+		 * Returns the local memory address the persistent data of an interleaved block is copied from
+		 */
+		u32 get_persistent_block_address(const interleaved_range_info& block, u32 first_vertex) const;
+
 	private:
 		shared_mutex m_mtx_task;
 
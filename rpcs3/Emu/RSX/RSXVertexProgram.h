@@ -229,4 +229,7 @@ struct RSXVertexProgram
 	std::vector<rsx_vertex_input> rsx_vertex_inputs;
 	u32 output_mask;
 	bool skip_vertex_input_check;
+
+	// Cached result of get_vertex_program_ucode_hash for data, 0 if not computed
+	size_t ucode_hash;
 };
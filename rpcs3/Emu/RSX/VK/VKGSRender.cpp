@@ -631,6 +631,9 @@ VKGSRender::VKGSRender() : GSRender()
 
 	if (g_cfg.video.disable_vertex_cache)
 		m_vertex_cache.reset(new vk::null_vertex_cache());
+	else if (g_cfg.video.persistent_vertex_cache)
+		m_vertex_cache.reset(new vk::persistent_vertex_cache([this]() { return m_attrib_ring_info.get_total_allocated(); },
+			[this]() { return m_attrib_ring_info.get_sync_position(); }, m_attrib_ring_info.size()));
 	else
 		m_vertex_cache.reset(new vk::weak_vertex_cache());
 
@@ -940,7 +943,7 @@ void VKGSRender::check_heap_status()
 		}
 
 		std::chrono::time_point<steady_clock> submit_end = steady_clock::now();
-		m_flip_time += std::chrono::duration_cast<std::chrono::microseconds>(submit_end - submit_start).count();
+		m_frame_stats.flip_time += std::chrono::duration_cast<std::chrono::microseconds>(submit_end - submit_start).count();
 	}
 }
 
@@ -1041,7 +1044,7 @@ void VKGSRender::update_draw_state()
 	//TODO: Set up other render-state parameters into the program pipeline
 
 	std::chrono::time_point<steady_clock> stop = steady_clock::now();
-	m_setup_time += std::chrono::duration_cast<std::chrono::microseconds>(stop - start).count();
+	m_frame_stats.setup_time += std::chrono::duration_cast<std::chrono::microseconds>(stop - start).count();
 }
 
 void VKGSRender::begin_render_pass()
@@ -1085,7 +1088,7 @@ void VKGSRender::end()
 	std::chrono::time_point<steady_clock> vertex_start = steady_clock::now();
 	auto upload_info = upload_vertex_data();
 	std::chrono::time_point<steady_clock> vertex_end = steady_clock::now();
-	m_vertex_upload_time += std::chrono::duration_cast<std::chrono::microseconds>(vertex_end - vertex_start).count();
+	m_frame_stats.vertex_upload_time += std::chrono::duration_cast<std::chrono::microseconds>(vertex_end - vertex_start).count();
 
 	std::chrono::time_point<steady_clock> textures_start = vertex_end;
 
@@ -1333,7 +1336,7 @@ void VKGSRender::end()
 	}
 
 	std::chrono::time_point<steady_clock> textures_end = steady_clock::now();
-	m_textures_upload_time += (u32)std::chrono::duration_cast<std::chrono::microseconds>(textures_end - textures_start).count();
+	m_frame_stats.textures_upload_time += (u32)std::chrono::duration_cast<std::chrono::microseconds>(textures_end - textures_start).count();
 
 	//Load program
 	std::chrono::time_point<steady_clock> program_start = textures_end;
@@ -1345,7 +1348,7 @@ void VKGSRender::end()
 	m_program->bind_uniform(volatile_buffer, "volatile_input_stream", m_current_frame->descriptor_set);
 
 	std::chrono::time_point<steady_clock> program_stop = steady_clock::now();
-	m_setup_time += std::chrono::duration_cast<std::chrono::microseconds>(program_stop - program_start).count();
+	m_frame_stats.setup_time += std::chrono::duration_cast<std::chrono::microseconds>(program_stop - program_start).count();
 
 	textures_start = program_stop;
 
@@ -1410,7 +1413,7 @@ void VKGSRender::end()
 	}
 
 	textures_end = steady_clock::now();
-	m_textures_upload_time += std::chrono::duration_cast<std::chrono::microseconds>(textures_end - textures_start).count();
+	m_frame_stats.textures_upload_time += std::chrono::duration_cast<std::chrono::microseconds>(textures_end - textures_start).count();
 
 	//While vertex upload is an interruptible process, if we made it this far, there's no need to sync anything that occurs past this point
 	//Only textures are synchronized tightly with the GPU and they have been read back above
@@ -1506,10 +1509,10 @@ void VKGSRender::end()
 	vk::leave_uninterruptible();
 
 	std::chrono::time_point<steady_clock> draw_end = steady_clock::now();
-	m_draw_time += std::chrono::duration_cast<std::chrono::microseconds>(draw_end - textures_end).count();
+	m_frame_stats.draw_exec_time += std::chrono::duration_cast<std::chrono::microseconds>(draw_end - textures_end).count();
 
 	copy_render_targets_to_dma_location();
-	m_draw_calls++;
+	m_frame_stats.draw_calls++;
 
 	rsx::thread::end();
 }
@@ -1930,12 +1933,13 @@ void VKGSRender::advance_queued_frames()
 		return false;
 	});
 
-	m_vertex_cache->purge();
+	m_vertex_cache->on_frame_end();
 	m_current_frame->tag_frame_end(m_attrib_ring_info.get_current_put_pos_minus_one(),
 		m_uniform_buffer_ring_info.get_current_put_pos_minus_one(),
 		m_transform_constants_ring_info.get_current_put_pos_minus_one(),
 		m_index_buffer_ring_info.get_current_put_pos_minus_one(),
 		m_texture_upload_buffer_ring_info.get_current_put_pos_minus_one());
+	m_current_frame->attrib_heap_sync_position = m_attrib_ring_info.get_total_allocated();
 
 	m_current_queue_index = (m_current_queue_index + 1) % VK_MAX_ASYNC_FRAMES;
 	m_current_frame = &frame_context_storage[m_current_queue_index];
@@ -2039,7 +2043,21 @@ void VKGSRender::process_swap_request(frame_context_t *ctx, bool free_resources)
 			m_last_heap_sync_time = ctx->last_frame_sync_time;
 
 			//Heap cleanup; deallocates memory consumed by the frame if it is still held
-			m_attrib_ring_info.m_get_pos = ctx->attrib_heap_ptr;
+			//Cached vertex data referenced by later frames stays allocated until those complete
+			s64 attrib_get_pos = ctx->attrib_heap_ptr;
+			u64 attrib_sync_position = ctx->attrib_heap_sync_position;
+			u64 pinned_position;
+			u32 pinned_offset;
+
+			if (m_vertex_cache->get_oldest_referenced_range(attrib_sync_position, pinned_position, pinned_offset) &&
+				pinned_position < attrib_sync_position)
+			{
+				attrib_get_pos = pinned_offset ? (s64)pinned_offset - 1 : (s64)m_attrib_ring_info.size() - 1;
+				attrib_sync_position = pinned_position;
+			}
+
+			m_attrib_ring_info.m_get_pos = attrib_get_pos;
+			m_attrib_ring_info.m_sync_position = attrib_sync_position;
 			m_uniform_buffer_ring_info.m_get_pos = ctx->ubo_heap_ptr;
 			m_transform_constants_ring_info.m_get_pos = ctx->vtxconst_heap_ptr;
 			m_index_buffer_ring_info.m_get_pos = ctx->index_heap_ptr;
@@ -2986,15 +3004,6 @@ void VKGSRender::flip(int buffer)
 		m_frame->flip(m_context);
 		rsx::thread::flip(buffer);
 
-		if (!skip_frame)
-		{
-			m_draw_calls = 0;
-			m_draw_time = 0;
-			m_setup_time = 0;
-			m_vertex_upload_time = 0;
-			m_textures_upload_time = 0;
-		}
-
 		return;
 	}
 
@@ -3016,7 +3025,7 @@ void VKGSRender::flip(int buffer)
 	}
 	else if (m_current_frame->swap_command_buffer)
 	{
-		if (m_draw_calls > 0)
+		if (m_frame_stats.draw_calls > 0)
 		{
 			//Unreachable
 			fmt::throw_exception("Possible data corruption on frame context storage detected");
@@ -3220,12 +3229,13 @@ void VKGSRender::flip(int buffer)
 		if (g_cfg.video.overlay)
 		{
 			m_text_writer->print_text(*m_current_command_buffer, *direct_fbo, 0, 0, direct_fbo->width(), direct_fbo->height(), "RSX Load: " + std::to_string(get_load()) + "%");
-			m_text_writer->print_text(*m_current_command_buffer, *direct_fbo, 0, 18, direct_fbo->width(), direct_fbo->height(), "draw calls: " + std::to_string(m_draw_calls));
-			m_text_writer->print_text(*m_current_command_buffer, *direct_fbo, 0, 36, direct_fbo->width(), direct_fbo->height(), "draw call setup: " + std::to_string(m_setup_time) + "us");
-			m_text_writer->print_text(*m_current_command_buffer, *direct_fbo, 0, 54, direct_fbo->width(), direct_fbo->height(), "vertex upload time: " + std::to_string(m_vertex_upload_time) + "us");
-			m_text_writer->print_text(*m_current_command_buffer, *direct_fbo, 0, 72, direct_fbo->width(), direct_fbo->height(), "texture upload time: " + std::to_string(m_textures_upload_time) + "us");
-			m_text_writer->print_text(*m_current_command_buffer, *direct_fbo, 0, 90, direct_fbo->width(), direct_fbo->height(), "draw call execution: " + std::to_string(m_draw_time) + "us");
-			m_text_writer->print_text(*m_current_command_buffer, *direct_fbo, 0, 108, direct_fbo->width(), direct_fbo->height(), "submit and flip: " + std::to_string(m_flip_time) + "us");
+			m_text_writer->print_text(*m_current_command_buffer, *direct_fbo, 0, 18, direct_fbo->width(), direct_fbo->height(), "draw calls: " + std::to_string(m_frame_stats.draw_calls));
+			m_text_writer->print_text(*m_current_command_buffer, *direct_fbo, 0, 36, direct_fbo->width(), direct_fbo->height(), "draw call setup: " + std::to_string(m_frame_stats.setup_time) + "us");
+			m_text_writer->print_text(*m_current_command_buffer, *direct_fbo, 0, 54, direct_fbo->width(), direct_fbo->height(), "vertex upload time: " + std::to_string(m_frame_stats.vertex_upload_time) + "us");
+			m_text_writer->print_text(*m_current_command_buffer, *direct_fbo, 0, 72, direct_fbo->width(), direct_fbo->height(), "texture upload time: " + std::to_string(m_frame_stats.textures_upload_time) + "us");
+			m_text_writer->print_text(*m_current_command_buffer, *direct_fbo, 0, 90, direct_fbo->width(), direct_fbo->height(), "draw call execution: " + std::to_string(m_frame_stats.draw_exec_time) + "us");
+			m_text_writer->print_text(*m_current_command_buffer, *direct_fbo, 0, 108, direct_fbo->width(), direct_fbo->height(), "submit and flip: " + std::to_string(m_frame_stats.flip_time) + "us");
+			m_text_writer->print_text(*m_current_command_buffer, *direct_fbo, 0, 126, direct_fbo->width(), direct_fbo->height(), fmt::format("vertex cache: %u hits, %u misses", m_frame_stats.vertex_cache_hits, m_frame_stats.vertex_cache_misses));
 
 			const  auto num_dirty_textures = m_texture_cache.get_unreleased_textures_count();
 			const auto texture_memory_size = m_texture_cache.get_texture_memory_in_use() / (1024 * 1024);
@@ -3246,21 +3256,12 @@ void VKGSRender::flip(int buffer)
 	queue_swap_request();
 
 	std::chrono::time_point<steady_clock> flip_end = steady_clock::now();
-	m_flip_time = std::chrono::duration_cast<std::chrono::microseconds>(flip_end - flip_start).count();
+	m_frame_stats.flip_time += std::chrono::duration_cast<std::chrono::microseconds>(flip_end - flip_start).count();
 
 	//NOTE:Resource destruction is handled within the real swap handler
 
 	m_frame->flip(m_context);
 	rsx::thread::flip(buffer);
-
-	//Do not reset perf counters if we are skipping the next frame
-	if (skip_frame) return;
-
-	m_draw_calls = 0;
-	m_draw_time = 0;
-	m_setup_time = 0;
-	m_vertex_upload_time = 0;
-	m_textures_upload_time = 0;
 }
 
 bool VKGSRender::scaled_image_from_memory(rsx::blit_src_info& src, rsx::blit_dst_info& dst, bool interpolate)
@@ -20,6 +20,7 @@ namespace vk
 {
 	using vertex_cache = rsx::vertex_cache::default_vertex_cache<rsx::vertex_cache::uploaded_range<VkFormat>, VkFormat>;
 	using weak_vertex_cache = rsx::vertex_cache::weak_vertex_cache<VkFormat>;
+	using persistent_vertex_cache = rsx::vertex_cache::persistent_vertex_cache<VkFormat>;
 	using null_vertex_cache = vertex_cache;
 
 	using shader_cache = rsx::shaders_cache<vk::pipeline_props, VKProgramBuffer>;
@@ -157,6 +158,9 @@ struct frame_context_t
 	s64 index_heap_ptr = 0;
 	s64 texture_upload_heap_ptr = 0;
 
+	//Allocation counter of the attribute heap at attrib_heap_ptr
+	u64 attrib_heap_sync_position = 0;
+
 	u64 last_frame_sync_time = 0;
 
 	//Copy shareable information
@@ -168,6 +172,7 @@ struct frame_context_t
 		used_descriptors = other.used_descriptors;
 
 		attrib_heap_ptr = other.attrib_heap_ptr;
+		attrib_heap_sync_position = other.attrib_heap_sync_position;
 		ubo_heap_ptr = other.attrib_heap_ptr;
 		vtxconst_heap_ptr = other.vtxconst_heap_ptr;
 		index_heap_ptr = other.attrib_heap_ptr;
@@ -339,16 +344,6 @@ private:
 	u32 m_client_width = 0;
 	u32 m_client_height = 0;
 
-	// Draw call stats
-	u32 m_draw_calls = 0;
-
-	// Timers
-	s64 m_setup_time = 0;
-	s64 m_vertex_upload_time = 0;
-	s64 m_textures_upload_time = 0;
-	s64 m_draw_time = 0;
-	s64 m_flip_time = 0;
-
 	u8 m_draw_buffers_count = 0;
 	bool m_flush_draw_buffers = false;
 	std::atomic<int> m_last_flushable_cb = {-1 };
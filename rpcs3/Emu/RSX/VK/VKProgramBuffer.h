@@ -76,18 +76,28 @@ struct VKTraits
 	using pipeline_properties = vk::pipeline_props;
 
 	static
-	void recompile_fragment_program(const RSXFragmentProgram &RSXFP, fragment_program_type& fragmentProgramData, size_t ID)
+	void decompile_fragment_program(const RSXFragmentProgram &RSXFP, fragment_program_type& fragmentProgramData, size_t ID)
 	{
 		fragmentProgramData.Decompile(RSXFP);
 		fragmentProgramData.id = static_cast<u32>(ID);
+	}
+
+	static
+	void compile_fragment_program(fragment_program_type& fragmentProgramData)
+	{
 		fragmentProgramData.Compile();
 	}
 
 	static
-	void recompile_vertex_program(const RSXVertexProgram &RSXVP, vertex_program_type& vertexProgramData, size_t ID)
+	void decompile_vertex_program(const RSXVertexProgram &RSXVP, vertex_program_type& vertexProgramData, size_t ID)
 	{
 		vertexProgramData.Decompile(RSXVP);
 		vertexProgramData.id = static_cast<u32>(ID);
+	}
+
+	static
+	void compile_vertex_program(vertex_program_type& vertexProgramData)
+	{
 		vertexProgramData.Compile();
 	}
 
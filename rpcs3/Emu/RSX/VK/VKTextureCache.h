@@ -464,6 +464,7 @@ namespace vk
 				range_data.data.resize(0);
 			}
 
+			m_cache_index.clear();
 			m_discardable_storage.clear();
 			m_unreleased_texture_objects = 0;
 			m_texture_memory_in_use = 0;
@@ -250,7 +250,6 @@ vk::vertex_upload_info VKGSRender::upload_vertex_data()
 	{
 		//Check if cacheable
 		//Only data in the 'persistent' block may be cached
-		//TODO: make vertex cache keep local data beyond frame boundaries and hook notify command
 		bool in_cache = false;
 		bool to_store = false;
 		u32  storage_address = UINT32_MAX;
@@ -258,15 +257,17 @@ vk::vertex_upload_info VKGSRender::upload_vertex_data()
 		if (m_vertex_layout.interleaved_blocks.size() == 1 &&
 			rsx::method_registers.current_draw_clause.command != rsx::draw_command::inlined_array)
 		{
-			storage_address = m_vertex_layout.interleaved_blocks[0].real_offset_address + vertex_base;
+			storage_address = get_persistent_block_address(m_vertex_layout.interleaved_blocks[0], vertex_base);
 			if (auto cached = m_vertex_cache->find_vertex_range(storage_address, VK_FORMAT_R8_UINT, required.first))
 			{
 				in_cache = true;
 				persistent_range_base = cached->offset_in_heap;
+				m_frame_stats.vertex_cache_hits++;
 			}
 			else
 			{
 				to_store = true;
+				m_frame_stats.vertex_cache_misses++;
 			}
 		}
 
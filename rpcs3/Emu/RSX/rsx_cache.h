@@ -7,6 +7,8 @@
 #include "Emu/Cell/Modules/cellMsgDialog.h"
 #include "Emu/System.h"
 
+#include "xxhash.h"
+
 namespace rsx
 {
 	enum protection_policy
@@ -528,6 +530,13 @@ namespace rsx
 			virtual storage_type* find_vertex_range(uintptr_t /*local_addr*/, upload_format, u32 /*data_length*/) { return nullptr; }
 			virtual void store_range(uintptr_t /*local_addr*/, upload_format, u32 /*data_length*/, u32 /*offset_in_heap*/) {}
 			virtual void purge() {}
+
+			// Called once per frame after presentation
+			virtual void on_frame_end() { purge(); }
+
+			// Oldest stored range referenced by draws recorded at or after the given heap position (see persistent_vertex_cache)
+			// The heap must not release its space before those draws have completed
+			virtual bool get_oldest_referenced_range(u64 /*heap_position*/, u64& /*range_position*/, u32& /*offset_in_heap*/) const { return false; }
 		};
 
 		// A weak vertex cache with no data checks or memory range locks
@@ -579,5 +588,146 @@ namespace rsx
 				vertex_ranges.clear();
 			}
 		};
+
+		template <typename upload_format>
+		struct persistent_range : public uploaded_range<upload_format>
+		{
+			u64 heap_position;     // Heap allocation counter before the range was allocated
+			u64 last_use_position; // Heap allocation counter when the range was last referenced by a draw
+			u64 data_hash;         // Hash of the guest memory the range was copied from
+			u32 validated_frame;
+		};
+
+		// A vertex cache which keeps uploaded ranges resident across frames
+		// Guest memory is checked against the stored hash the first time a range is used in a frame; within a frame ranges are trusted like the weak cache does
+		// Residency follows the sync point of the ring heap: data allocated before it may be overwritten at any time, data after it is kept until the GPU is done with it.
+		// Heap positions are monotonic allocation counters. The backend keeps the sync point behind ranges referenced by draws in flight (get_oldest_referenced_range)
+		template <typename upload_format>
+		class persistent_vertex_cache : public default_vertex_cache<uploaded_range<upload_format>, upload_format>
+		{
+			using storage_type = persistent_range<upload_format>;
+
+		private:
+			std::unordered_map<uintptr_t, std::vector<storage_type>> vertex_ranges;
+			std::function<u64()> m_get_heap_position;
+			std::function<u64()> m_get_sync_position;
+			u64 m_heap_size;
+			u64 m_lookup_position = 0;
+			u32 m_frame = 0;
+
+			bool is_resident(const storage_type& v, u64 heap_position, u64 sync_position) const
+			{
+				// Ranges are uploaded again once the heap has moved half its size past them, otherwise draws keep them pinned forever and the heap runs full
+				return v.heap_position >= sync_position && (heap_position - v.heap_position) <= (m_heap_size / 2);
+			}
+
+		public:
+			persistent_vertex_cache(std::function<u64()> get_heap_position, std::function<u64()> get_sync_position, u64 heap_size)
+				: m_get_heap_position(std::move(get_heap_position))
+				, m_get_sync_position(std::move(get_sync_position))
+				, m_heap_size(heap_size)
+			{
+			}
+
+			uploaded_range<upload_format>* find_vertex_range(uintptr_t local_addr, upload_format fmt, u32 data_length) override
+			{
+				// A miss is followed by the allocation of the range, remember where it can start at the earliest
+				m_lookup_position = m_get_heap_position();
+
+				const auto found = vertex_ranges.find(local_addr);
+				if (found == vertex_ranges.end())
+					return nullptr;
+
+				auto &ranges = found->second;
+				for (auto It = ranges.begin(); It != ranges.end(); ++It)
+				{
+					if (It->buffer_format != fmt || It->data_length != data_length)
+						continue;
+
+					if (!is_resident(*It, m_lookup_position, m_get_sync_position()))
+					{
+						ranges.erase(It);
+						return nullptr;
+					}
+
+					if (It->validated_frame != m_frame)
+					{
+						if (XXH64(vm::base((u32)local_addr), data_length, 0) != It->data_hash)
+						{
+							ranges.erase(It);
+							return nullptr;
+						}
+
+						It->validated_frame = m_frame;
+					}
+
+					It->last_use_position = m_lookup_position;
+					return &*It;
+				}
+
+				return nullptr;
+			}
+
+			void store_range(uintptr_t local_addr, upload_format fmt, u32 data_length, u32 offset_in_heap) override
+			{
+				storage_type v = {};
+				v.buffer_format = fmt;
+				v.data_length = data_length;
+				v.local_address = local_addr;
+				v.offset_in_heap = offset_in_heap;
+				v.heap_position = m_lookup_position;
+				v.last_use_position = m_lookup_position;
+				v.data_hash = XXH64(vm::base((u32)local_addr), data_length, 0);
+				v.validated_frame = m_frame;
+
+				vertex_ranges[local_addr].push_back(v);
+			}
+
+			bool get_oldest_referenced_range(u64 heap_position, u64& range_position, u32& offset_in_heap) const override
+			{
+				bool found = false;
+
+				for (const auto &It : vertex_ranges)
+				{
+					for (const auto &v : It.second)
+					{
+						if (v.last_use_position < heap_position)
+							continue;
+
+						if (!found || v.heap_position < range_position)
+						{
+							range_position = v.heap_position;
+							offset_in_heap = v.offset_in_heap;
+							found = true;
+						}
+					}
+				}
+
+				return found;
+			}
+
+			void purge() override
+			{
+				vertex_ranges.clear();
+			}
+
+			void on_frame_end() override
+			{
+				m_frame++;
+
+				const u64 heap_position = m_get_heap_position();
+				const u64 sync_position = m_get_sync_position();
+				for (auto It = vertex_ranges.begin(); It != vertex_ranges.end();)
+				{
+					auto &ranges = It->second;
+					ranges.erase(std::remove_if(ranges.begin(), ranges.end(), [&](const storage_type& v) { return !is_resident(v, heap_position, sync_position); }), ranges.end());
+
+					if (ranges.empty())
+						It = vertex_ranges.erase(It);
+					else
+						++It;
+				}
+			}
+		};
 	}
 }
@@ -9,9 +9,6 @@
 #include "Emu/Cell/lv2/sys_rsx.h"
 #include "Capture/rsx_capture.h"
 
-#include <sstream>
-#include <cereal/archives/binary.hpp>
-
 #include <thread>
 
 template <>
@@ -38,6 +35,7 @@ namespace rsx
 	rsx_state method_registers;
 
 	std::array<rsx_method_t, 0x10000 / 4> methods{};
+	std::array<u8, 0x10000 / 4> method_attributes{};
 
 	void invalid_method(thread* rsx, u32 _reg, u32 arg)
 	{
@@ -365,14 +363,15 @@ namespace rsx
 		{
 			static void impl(thread* rsx, u32 _reg, u32 arg)
 			{
-				method_registers.commit_4_transform_program_instructions(index);
-				rsx->m_graphics_state |= rsx::pipeline_state::vertex_program_dirty;
+				//Games tend to upload the same program before every draw
+				if (method_registers.commit_4_transform_program_instructions(index))
+					rsx->m_graphics_state |= rsx::pipeline_state::vertex_program_dirty | rsx::pipeline_state::vertex_ucode_dirty;
 			}
 		};
 
 		void set_transform_program_start(thread* rsx, u32, u32)
 		{
-			rsx->m_graphics_state |= rsx::pipeline_state::vertex_program_dirty;
+			rsx->m_graphics_state |= rsx::pipeline_state::vertex_program_dirty | rsx::pipeline_state::vertex_ucode_dirty;
 		}
 
 		void set_vertex_attribute_output_mask(thread* rsx, u32, u32)
@@ -385,6 +384,7 @@ namespace rsx
 			if (arg)
 			{
 				rsx::method_registers.current_draw_clause.first_count_commands.resize(0);
+				rsx::method_registers.current_draw_clause.transform_constant_segments.clear();
 				rsx::method_registers.current_draw_clause.command = draw_command::none;
 				rsx::method_registers.current_draw_clause.primitive = to_primitive_type(arg);
 				rsxthr->begin();
@@ -1027,34 +1027,44 @@ namespace rsx
 		}
 		else if (user_asked_for_frame_capture && !rsx->capture_current_frame)
 		{
-			rsx->capture_current_frame = true;
 			user_asked_for_frame_capture = false;
-			frame_debug.reset();
-			frame_capture.reset();
-
-			// random number just to jumpstart the size
-			frame_capture.replay_commands.reserve(8000);
 
-			// capture first tile state with nop cmd
-			rsx::frame_capture_data::replay_command replay_cmd;
-			replay_cmd.rsx_command = std::make_pair(NV4097_NO_OPERATION, 0);
-			frame_capture.replay_commands.push_back(replay_cmd);
-			capture::capture_display_tile_state(rsx, frame_capture.replay_commands.back());
+			const std::string file_path = fs::get_config_dir() + "capture.rrc";
+			if (!capture::file_writer.open(file_path))
+			{
+				LOG_ERROR(RSX, "RSX Capture: failed to create %s", file_path);
+			}
+			else
+			{
+				rsx->capture_current_frame = true;
+				rsx->capture_frames_left = g_cfg.video.frames_to_capture;
+				frame_debug.reset();
+				frame_capture.reset();
+
+				// random number just to jumpstart the size
+				frame_capture.replay_commands.reserve(8000);
+
+				// capture first tile state with nop cmd
+				rsx::frame_capture_data::replay_command replay_cmd;
+				replay_cmd.rsx_command = std::make_pair(NV4097_NO_OPERATION, 0);
+				frame_capture.replay_commands.push_back(replay_cmd);
+				capture::capture_display_tile_state(rsx, frame_capture.replay_commands.back());
+			}
 		}
-		else if (rsx->capture_current_frame)
+		else if (rsx->capture_current_frame && --rsx->capture_frames_left == 0)
 		{
 			rsx->capture_current_frame = false;
-			std::stringstream os;
-			cereal::BinaryOutputArchive archive(os);
-			const std::string& filePath = fs::get_config_dir() + "capture.rrc";
-			archive(frame_capture);
+
+			// memory data has been streamed to the file already, only the command stream is left
+			// todo: 'dynamicly' create capture filename
+			if (capture::file_writer.finish(frame_capture))
 			{
-				// todo: 'dynamicly' create capture filename, also may want to compress this data?
-				fs::file f(filePath, fs::rewrite);
-				f.write(os.str());
+				LOG_SUCCESS(RSX, "capture successful: %s", fs::get_config_dir() + "capture.rrc");
+			}
+			else
+			{
+				LOG_ERROR(RSX, "RSX Capture: failed to write capture metadata");
 			}
-
-			LOG_SUCCESS(RSX, "capture successful: %s", filePath.c_str());
 
 			frame_capture.reset();
 			Emu.Pause();
@@ -1259,6 +1269,12 @@ namespace rsx
 		registers[reg] = value;
 	}
 
+	void rsx_state::decode(u32 reg, const be_t<u32>* values, u32 count)
+	{
+		verify(HERE), reg + count <= registers.size();
+		std::copy(values, values + count, registers.begin() + reg);
+	}
+
 	bool rsx_state::test(u32 reg, u32 value) const
 	{
 		return registers[reg] == value;
@@ -1761,6 +1777,60 @@ namespace rsx
 		// custom methods
 		bind<GCM_FLIP_COMMAND, flip_command>();
 
+		// FIFO attributes
+		for (u32 i = 0; i < methods.size(); i++)
+		{
+			method_attributes[i] = methods[i] ? method_has_handler : 0;
+		}
+
+		for (u32 reg : { NV4097_SET_BEGIN_END, NV4097_INVALIDATE_VERTEX_FILE, NV4097_DRAW_ARRAYS, NV4097_DRAW_INDEX_ARRAY })
+		{
+			method_attributes[reg] |= method_draw_control;
+		}
+
+		//TODO: Reorder draw commands between synchronization events to maximize batched sizes
+		static const std::pair<u32, u32> skippable_ranges[] =
+		{
+			//Texture configuration
+			{ NV4097_SET_TEXTURE_OFFSET, 8 * 16 },
+			{ NV4097_SET_TEXTURE_CONTROL2, 16 },
+			{ NV4097_SET_TEXTURE_CONTROL3, 16 },
+			{ NV4097_SET_VERTEX_TEXTURE_OFFSET, 8 * 4 },
+			//Surface configuration
+			{ NV4097_SET_SURFACE_CLIP_HORIZONTAL, 1 },
+			{ NV4097_SET_SURFACE_CLIP_VERTICAL, 1 },
+			{ NV4097_SET_SURFACE_COLOR_AOFFSET, 1 },
+			{ NV4097_SET_SURFACE_COLOR_BOFFSET, 1 },
+			{ NV4097_SET_SURFACE_COLOR_COFFSET, 1 },
+			{ NV4097_SET_SURFACE_COLOR_DOFFSET, 1 },
+			{ NV4097_SET_SURFACE_ZETA_OFFSET, 1 },
+			{ NV4097_SET_CONTEXT_DMA_COLOR_A, 1 },
+			{ NV4097_SET_CONTEXT_DMA_COLOR_B, 1 },
+			{ NV4097_SET_CONTEXT_DMA_COLOR_C, 1 },
+			{ NV4097_SET_CONTEXT_DMA_COLOR_D, 1 },
+			{ NV4097_SET_CONTEXT_DMA_ZETA, 1 },
+			{ NV4097_SET_SURFACE_FORMAT, 1 },
+			{ NV4097_SET_SURFACE_PITCH_A, 1 },
+			{ NV4097_SET_SURFACE_PITCH_B, 1 },
+			{ NV4097_SET_SURFACE_PITCH_C, 1 },
+			{ NV4097_SET_SURFACE_PITCH_D, 1 },
+			{ NV4097_SET_SURFACE_PITCH_Z, 1 }
+		};
+
+		for (const auto& range : skippable_ranges)
+		{
+			for (u32 i = 0; i < range.second; i++)
+			{
+				method_attributes[range.first + i] |= method_skippable;
+			}
+		}
+
+		//Constant uploads often rewrite the values already in place between draws
+		for (u32 i = 0; i < 32; i++)
+		{
+			method_attributes[NV4097_SET_TRANSFORM_CONSTANT + i] |= method_transform_constant;
+		}
+
 
 		return true;
 	}();
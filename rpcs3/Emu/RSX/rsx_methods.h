@@ -43,6 +43,18 @@ namespace rsx
 		 */
 		std::vector<std::pair<u32, u32> > alternate_first_count_commands;
 
+		/**
+		 * Transform constants of batched draws which were followed by constant uploads.
+		 * Draws [previous draw_end, draw_end) of first_count_commands use the stored constants, draws after the last segment use the current registers.
+		 */
+		struct transform_constant_segment
+		{
+			u32 draw_end;
+			std::array<u32[4], 512> constants;
+		};
+
+		std::vector<transform_constant_segment> transform_constant_segments;
+
 		/**
 		 * Returns how many vertex or index will be consumed by the draw clause.
 		 */
@@ -55,6 +67,15 @@ namespace rsx
 
 	using rsx_method_t = void(*)(class thread*, u32 reg, u32 arg);
 
+	// Register attributes used by the FIFO loop, generated together with the method table
+	enum method_attribute : u8
+	{
+		method_has_handler = 1 << 0, // methods[reg] must be called
+		method_draw_control = 1 << 1, // Handled by the draw batching logic (begin/end, draw arrays...)
+		method_skippable = 1 << 2, // Doesn't break draw batching if the value doesn't change
+		method_transform_constant = 1 << 3, // Writes the transform constant selected by the current load slot
+	};
+
 	//TODO
 	union alignas(4) method_registers_t
 	{
@@ -192,6 +213,9 @@ namespace rsx
 
 		void decode(u32 reg, u32 value);
 
+		// Store a run of values to consecutive registers
+		void decode(u32 reg, const be_t<u32>* values, u32 count);
+
 		bool test(u32 reg, u32 value) const;
 
 		void reset();
@@ -1169,15 +1193,25 @@ namespace rsx
 			return decode<NV308A_POINT>().y();
 		}
 
-		void commit_4_transform_program_instructions(u32 index)
+		/**
+		 * Returns false if the slot already held the same instruction
+		 */
+		bool commit_4_transform_program_instructions(u32 index)
 		{
 			u32& load = registers[NV4097_SET_TRANSFORM_PROGRAM_LOAD];
 
-			transform_program[load * 4] = registers[NV4097_SET_TRANSFORM_PROGRAM + index * 4];
-			transform_program[load * 4 + 1] = registers[NV4097_SET_TRANSFORM_PROGRAM + index * 4 + 1];
-			transform_program[load * 4 + 2] = registers[NV4097_SET_TRANSFORM_PROGRAM + index * 4 + 2];
-			transform_program[load * 4 + 3] = registers[NV4097_SET_TRANSFORM_PROGRAM + index * 4 + 3];
+			u32* dst = &transform_program[load * 4];
+			const u32* src = &registers[NV4097_SET_TRANSFORM_PROGRAM + index * 4];
 			load++;
+
+			if (dst[0] == src[0] && dst[1] == src[1] && dst[2] == src[2] && dst[3] == src[3])
+				return false;
+
+			dst[0] = src[0];
+			dst[1] = src[1];
+			dst[2] = src[2];
+			dst[3] = src[3];
+			return true;
 		}
 
 		u32 transform_constant_load()
@@ -1233,4 +1267,50 @@ namespace rsx
 
 	extern rsx_state method_registers;
 	extern std::array<rsx_method_t, 0x10000 / 4> methods;
+	extern std::array<u8, 0x10000 / 4> method_attributes;
+
+	// Check if writing the registers of a FIFO command only stores their values (no handler or batching logic)
+	inline bool is_plain_method_run(u32 first_reg, u32 count)
+	{
+		if (first_reg + count > method_attributes.size())
+		{
+			return false;
+		}
+
+		u8 attributes = 0;
+
+		for (u32 i = 0; i < count; i++)
+		{
+			attributes |= method_attributes[first_reg + i];
+		}
+
+		return attributes == 0;
+	}
+
+	// Check if a register write would leave the pipeline state untouched, in which case pending draws can keep batching across it
+	inline bool is_redundant_method(u32 reg, u32 value)
+	{
+		const u8 attributes = method_attributes[reg];
+
+		if (attributes & method_transform_constant)
+		{
+			const u32 index = reg - NV4097_SET_TRANSFORM_CONSTANT;
+			const u32 load = method_registers.transform_constant_load();
+
+			if ((load + index / 4) >= 512)
+			{
+				return false;
+			}
+
+			return method_registers.transform_constants[load + index / 4][index % 4] == value;
+		}
+
+		// Plain registers only store their value
+		if (attributes == 0 || (attributes & method_skippable))
+		{
+			return method_registers.test(reg, value);
+		}
+
+		return false;
+	}
 }
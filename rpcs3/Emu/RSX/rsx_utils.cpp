@@ -1,10 +1,12 @@
 #include "stdafx.h"
 #include "rsx_utils.h"
 #include "rsx_methods.h"
+#include "Emu/System.h"
 #include "Emu/RSX/GCM.h"
 #include "Common/BufferUtils.h"
 #include "overlays.h"
 #include "Utilities/sysinfo.h"
+#include "Utilities/color_convert.h"
 
 extern "C"
 {
@@ -16,6 +18,41 @@ namespace rsx
 	void convert_scale_image(u8 *dst, AVPixelFormat dst_format, int dst_width, int dst_height, int dst_pitch,
 		const u8 *src, AVPixelFormat src_format, int src_width, int src_height, int src_pitch, int src_slice_h, bool bilinear)
 	{
+		// The SIMD kernels do not sample like swscale (see Utilities/tools/color_convert_check.cpp), so they are opt-in
+		const bool use_simd = g_cfg.video.simd_cpu_blit_conversion && src_slice_h == src_height;
+
+		if (use_simd && src_format == dst_format && (src_format == AV_PIX_FMT_ARGB || src_format == AV_PIX_FMT_RGB565BE))
+		{
+			const u32 bpp = src_format == AV_PIX_FMT_ARGB ? 4 : 2;
+
+			if (!bilinear)
+			{
+				color_convert::scale_nearest(src, src_width, src_height, src_pitch, dst, dst_width, dst_height, dst_pitch, bpp);
+				return;
+			}
+
+			if (bpp == 4 && color_convert::scale_rgb32_bilinear(src, src_width, src_height, src_pitch, dst, dst_width, dst_height, dst_pitch))
+			{
+				return;
+			}
+		}
+
+		if (use_simd && src_width == dst_width && src_height == dst_height)
+		{
+			if (src_format == AV_PIX_FMT_RGB565BE && dst_format == AV_PIX_FMT_ARGB)
+			{
+				color_convert::rgb565be_to_argb(src, src_pitch, dst, dst_pitch, src_width, src_height);
+				return;
+			}
+
+			if (src_format == AV_PIX_FMT_ARGB && dst_format == AV_PIX_FMT_RGB565BE)
+			{
+				color_convert::argb_to_rgb565be(src, src_pitch, dst, dst_pitch, src_width, src_height);
+				return;
+			}
+		}
+
+		// Format changes combined with scaling, bilinear scaling by other ratios, or the SIMD kernels are disabled
 		std::unique_ptr<SwsContext, void(*)(SwsContext*)> sws(sws_getContext(src_width, src_height, src_format,
 			dst_width, dst_height, dst_format, bilinear ? SWS_FAST_BILINEAR : SWS_POINT, NULL, NULL, NULL), sws_freeContext);
 
@@ -293,6 +330,147 @@ namespace rsx
 		}
 	}
 
+	swizzle_offset_table get_swizzle_offset_table(u16 width, u16 height)
+	{
+		const u32 log2width = ceil_log2(width);
+		const u32 log2height = ceil_log2(height);
+
+		// Interleaving is limited to the lower of the two dimensions to allow for non-square textures
+		const u32 limit = std::min(log2width, log2height);
+		const u32 limit_mask = 1 << (limit << 1);
+
+		// x_mask: bits above limit are 1's for x-carry, y_mask: bits above limit are 0'd (y-carry is added separately)
+		const u32 x_mask = 0x55555555 | ~(limit_mask - 1);
+		const u32 y_mask = 0xAAAAAAAA & (limit_mask - 1);
+
+		swizzle_offset_table result;
+		result.x_offsets.resize(width);
+		result.y_offsets.resize(height);
+		result.tiled_4x4 = limit >= 2 && (width & 3) == 0 && (height & 3) == 0;
+
+		u32 offs_x = 0;
+		for (u32 x = 0; x < width; ++x)
+		{
+			result.x_offsets[x] = offs_x;
+			offs_x = (offs_x - x_mask) & x_mask;
+		}
+
+		u32 offs_y = 0;
+		u32 offs_x0 = 0; // Total y-carry offset, only non-zero for textures taller than wide
+		for (u32 y = 0; y < height; ++y)
+		{
+			result.y_offsets[y] = offs_y + offs_x0;
+			offs_y = (offs_y - y_mask) & y_mask;
+
+			if (offs_y == 0)
+			{
+				offs_x0 += limit_mask;
+			}
+		}
+
+		return result;
+	}
+
+	// A swizzled 4x4 tile of 32-bit texels is four 2x2 blocks: (0,0) (2,0) (0,2) (2,2), each holding 2 texels of 2 rows
+	static void convert_linear_swizzle_tiled_32(const swizzle_offset_table& table, u8* linear, u8* swizzled, u16 width, u16 y_begin, u16 y_end, bool to_linear)
+	{
+		const u32 row_pitch = width * 4;
+
+		for (u32 y = y_begin; y < y_end; y += 4)
+		{
+			const u32 row_offset = table.y_offsets[y];
+			u8* rows = linear + y * row_pitch;
+
+			for (u32 x = 0; x < width; x += 4)
+			{
+				const auto tile = reinterpret_cast<__m128i*>(swizzled + (row_offset + table.x_offsets[x]) * 4);
+				const auto r0 = reinterpret_cast<__m128i*>(rows + x * 4);
+				const auto r1 = reinterpret_cast<__m128i*>(rows + x * 4 + row_pitch);
+				const auto r2 = reinterpret_cast<__m128i*>(rows + x * 4 + row_pitch * 2);
+				const auto r3 = reinterpret_cast<__m128i*>(rows + x * 4 + row_pitch * 3);
+
+				if (to_linear)
+				{
+					const __m128i b0 = _mm_loadu_si128(tile);
+					const __m128i b1 = _mm_loadu_si128(tile + 1);
+					const __m128i b2 = _mm_loadu_si128(tile + 2);
+					const __m128i b3 = _mm_loadu_si128(tile + 3);
+					_mm_storeu_si128(r0, _mm_unpacklo_epi64(b0, b1));
+					_mm_storeu_si128(r1, _mm_unpackhi_epi64(b0, b1));
+					_mm_storeu_si128(r2, _mm_unpacklo_epi64(b2, b3));
+					_mm_storeu_si128(r3, _mm_unpackhi_epi64(b2, b3));
+				}
+				else
+				{
+					const __m128i v0 = _mm_loadu_si128(r0);
+					const __m128i v1 = _mm_loadu_si128(r1);
+					const __m128i v2 = _mm_loadu_si128(r2);
+					const __m128i v3 = _mm_loadu_si128(r3);
+					_mm_storeu_si128(tile, _mm_unpacklo_epi64(v0, v1));
+					_mm_storeu_si128(tile + 1, _mm_unpackhi_epi64(v0, v1));
+					_mm_storeu_si128(tile + 2, _mm_unpacklo_epi64(v2, v3));
+					_mm_storeu_si128(tile + 3, _mm_unpackhi_epi64(v2, v3));
+				}
+			}
+		}
+	}
+
+	// Same as above with 16-bit texels; each 128-bit half of a tile covers 2 rows, dword lanes alternate between them
+	static void convert_linear_swizzle_tiled_16(const swizzle_offset_table& table, u8* linear, u8* swizzled, u16 width, u16 y_begin, u16 y_end, bool to_linear)
+	{
+		const u32 row_pitch = width * 2;
+
+		for (u32 y = y_begin; y < y_end; y += 4)
+		{
+			const u32 row_offset = table.y_offsets[y];
+			u8* rows = linear + y * row_pitch;
+
+			for (u32 x = 0; x < width; x += 4)
+			{
+				const auto tile = reinterpret_cast<__m128i*>(swizzled + (row_offset + table.x_offsets[x]) * 2);
+				const auto r0 = reinterpret_cast<__m128i*>(rows + x * 2);
+				const auto r1 = reinterpret_cast<__m128i*>(rows + x * 2 + row_pitch);
+				const auto r2 = reinterpret_cast<__m128i*>(rows + x * 2 + row_pitch * 2);
+				const auto r3 = reinterpret_cast<__m128i*>(rows + x * 2 + row_pitch * 3);
+
+				if (to_linear)
+				{
+					const __m128i top = _mm_shuffle_epi32(_mm_loadu_si128(tile), _MM_SHUFFLE(3, 1, 2, 0));
+					const __m128i bottom = _mm_shuffle_epi32(_mm_loadu_si128(tile + 1), _MM_SHUFFLE(3, 1, 2, 0));
+					_mm_storel_epi64(r0, top);
+					_mm_storel_epi64(r1, _mm_unpackhi_epi64(top, top));
+					_mm_storel_epi64(r2, bottom);
+					_mm_storel_epi64(r3, _mm_unpackhi_epi64(bottom, bottom));
+				}
+				else
+				{
+					const __m128i top = _mm_unpacklo_epi64(_mm_loadl_epi64(r0), _mm_loadl_epi64(r1));
+					const __m128i bottom = _mm_unpacklo_epi64(_mm_loadl_epi64(r2), _mm_loadl_epi64(r3));
+					_mm_storeu_si128(tile, _mm_shuffle_epi32(top, _MM_SHUFFLE(3, 1, 2, 0)));
+					_mm_storeu_si128(tile + 1, _mm_shuffle_epi32(bottom, _MM_SHUFFLE(3, 1, 2, 0)));
+				}
+			}
+		}
+	}
+
+	void convert_linear_swizzle_tiled(const swizzle_offset_table& table, void* input_pixels, void* output_pixels, u8 texel_size, u16 width, u16 y_begin, u16 y_end, bool input_is_swizzled)
+	{
+		verify(HERE), table.tiled_4x4, (y_begin & 3) == 0, (y_end & 3) == 0;
+
+		u8* linear = static_cast<u8*>(input_is_swizzled ? output_pixels : input_pixels);
+		u8* swizzled = static_cast<u8*>(input_is_swizzled ? input_pixels : output_pixels);
+
+		switch (texel_size)
+		{
+		case 2:
+			return convert_linear_swizzle_tiled_16(table, linear, swizzled, width, y_begin, y_end, input_is_swizzled);
+		case 4:
+			return convert_linear_swizzle_tiled_32(table, linear, swizzled, width, y_begin, y_end, input_is_swizzled);
+		default:
+			fmt::throw_exception("Unsupported texel size %d" HERE, texel_size);
+		}
+	}
+
 	void convert_le_f32_to_be_d24(void *dst, void *src, u32 row_length_in_texels, u32 num_rows)
 	{
 		const u32 num_pixels = row_length_in_texels * num_rows;
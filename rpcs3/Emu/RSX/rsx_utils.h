@@ -159,83 +159,78 @@ namespace rsx
 		return result;
 	}
 
-	/*   Note: What the ps3 calls swizzling in this case is actually z-ordering / morton ordering of pixels
-	*       - Input can be swizzled or linear, bool flag handles conversion to and from
-	*       - It will handle any width and height that are a power of 2, square or non square
-	*    Restriction: It has mixed results if the height or width is not a power of 2
-	*    Restriction: Only works with 2D surfaces
-	*/
-	template<typename T>
-	void convert_linear_swizzle(void* input_pixels, void* output_pixels, u16 width, u16 height, bool input_is_swizzled)
+	/**
+	 * Per-axis address tables for Z-ordered (swizzled) surfaces.
+	 * X and Y bits of a swizzled address never overlap, so the offset of texel (x, y) is x_offsets[x] + y_offsets[y].
+	 * Bits of the larger dimension that exceed the smaller one are placed linearly above the interleaved bits.
+	 */
+	struct swizzle_offset_table
 	{
-		u32 log2width = ceil_log2(width);
-		u32 log2height = ceil_log2(height);
-
-		// Max mask possible for square texture
-		u32 x_mask = 0x55555555;
-		u32 y_mask = 0xAAAAAAAA;
+		std::vector<u32> x_offsets;
+		std::vector<u32> y_offsets;
 
-		// We have to limit the masks to the lower of the two dimensions to allow for non-square textures
-		u32 limit_mask = (log2width < log2height) ? log2width : log2height;
-		// double the limit mask to account for bits in both x and y
-		limit_mask = 1 << (limit_mask << 1);
+		// Every aligned 4x4 block of texels occupies 16 consecutive elements
+		bool tiled_4x4;
+	};
 
-		//x_mask, bits above limit are 1's for x-carry
-		x_mask = (x_mask | ~(limit_mask - 1));
-		//y_mask. bits above limit are 0'd, as we use a different method for y-carry over
-		y_mask = (y_mask & (limit_mask - 1));
+	swizzle_offset_table get_swizzle_offset_table(u16 width, u16 height);
 
-		u32 offs_y = 0;
-		u32 offs_x = 0;
-		u32 offs_x0 = 0; //total y-carry offset for x
-		u32 y_incr = limit_mask;
+	// SIMD conversion of whole 4x4 tiles, texel_size must be 2 or 4 and [y_begin, y_end) must be 4-aligned
+	void convert_linear_swizzle_tiled(const swizzle_offset_table& table, void* input_pixels, void* output_pixels, u8 texel_size, u16 width, u16 y_begin, u16 y_end, bool input_is_swizzled);
 
-		if (!input_is_swizzled)
+	/**
+	 * Converts rows [y_begin, y_end) between linear and swizzled layouts.
+	 * Disjoint row ranges touch disjoint memory, so ranges can be processed concurrently.
+	 */
+	template<typename T>
+	void convert_linear_swizzle_rows(const swizzle_offset_table& table, void* input_pixels, void* output_pixels, u16 width, u16 y_begin, u16 y_end, bool input_is_swizzled)
+	{
+		if ((sizeof(T) == 4 || sizeof(T) == 2) && table.tiled_4x4 && (y_begin & 3) == 0 && (y_end & 3) == 0)
 		{
-			for (int y = 0; y < height; ++y)
-			{
-				T *src = static_cast<T*>(input_pixels) + y * width;
-				T *dst = static_cast<T*>(output_pixels) + offs_y;
-				offs_x = offs_x0;
-
-				for (int x = 0; x < width; ++x)
-				{
-					dst[offs_x] = src[x];
-					offs_x = (offs_x - x_mask) & x_mask;
-				}
+			convert_linear_swizzle_tiled(table, input_pixels, output_pixels, sizeof(T), width, y_begin, y_end, input_is_swizzled);
+			return;
+		}
 
-				offs_y = (offs_y - y_mask) & y_mask;
+		const u32* x_offsets = table.x_offsets.data();
 
-				if (offs_y == 0)
-				{
-					offs_x0 += y_incr;
-				}
-			}
-		}
-		else
+		for (u32 y = y_begin; y < y_end; ++y)
 		{
-			for (int y = 0; y < height; ++y)
+			if (input_is_swizzled)
 			{
-				T *src = static_cast<T*>(input_pixels) + offs_y;
+				const T *src = static_cast<T*>(input_pixels) + table.y_offsets[y];
 				T *dst = static_cast<T*>(output_pixels) + y * width;
-				offs_x = offs_x0;
 
-				for (int x = 0; x < width; ++x)
+				for (u32 x = 0; x < width; ++x)
 				{
-					dst[x] = src[offs_x];
-					offs_x = (offs_x - x_mask) & x_mask;
+					dst[x] = src[x_offsets[x]];
 				}
+			}
+			else
+			{
+				const T *src = static_cast<T*>(input_pixels) + y * width;
+				T *dst = static_cast<T*>(output_pixels) + table.y_offsets[y];
 
-				offs_y = (offs_y - y_mask) & y_mask;
-
-				if (offs_y == 0)
+				for (u32 x = 0; x < width; ++x)
 				{
-					offs_x0 += y_incr;
+					dst[x_offsets[x]] = src[x];
 				}
 			}
 		}
 	}
 
+	/*   Note: What the ps3 calls swizzling in this case is actually z-ordering / morton ordering of pixels
+	*       - Input can be swizzled or linear, bool flag handles conversion to and from
+	*       - It will handle any width and height that are a power of 2, square or non square
+	*    Restriction: It has mixed results if the height or width is not a power of 2
+	*    Restriction: Only works with 2D surfaces
+	*/
+	template<typename T>
+	void convert_linear_swizzle(void* input_pixels, void* output_pixels, u16 width, u16 height, bool input_is_swizzled)
+	{
+		const auto table = get_swizzle_offset_table(width, height);
+		convert_linear_swizzle_rows<T>(table, input_pixels, output_pixels, width, 0, height, input_is_swizzled);
+	}
+
 	/**
 	 * Write swizzled data to linear memory with support for 3 dimensions
 	 * Z ordering is done in all 3 planes independently with a unit being a 2x2 block per-plane
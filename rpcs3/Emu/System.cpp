@@ -28,12 +28,9 @@
 #include "../Crypto/unpkg.h"
 #include "yaml-cpp/yaml.h"
 
-#include "cereal/archives/binary.hpp"
-
 #include <thread>
 #include <typeinfo>
 #include <queue>
-#include <fstream>
 #include <memory>
 
 #include "Utilities/GDBDebugServer.h"
@@ -245,31 +242,28 @@ void Emulator::Init()
 	fxm::make_always<patch_engine>()->append(fs::get_config_dir() + "/patch.yml");
 }
 
-bool Emulator::BootRsxCapture(const std::string& path)
+bool Emulator::BootRsxCapture(const std::string& path, u32 replay_count, const std::string& report_path)
 {
 	if (!fs::is_file(path))
 		return false;
 
-	std::fstream f(path, std::ios::in | std::ios::binary);
-
-	cereal::BinaryInputArchive archive(f);
 	std::unique_ptr<rsx::frame_capture_data> frame = std::make_unique<rsx::frame_capture_data>();
-	archive(*frame);
+	std::unique_ptr<rsx::frame_capture_reader> reader = std::make_unique<rsx::frame_capture_reader>();
 
-	if (frame->magic != rsx::FRAME_CAPTURE_MAGIC)
+	if (!reader->open(path, *frame))
 	{
-		LOG_ERROR(LOADER, "Invalid rsx capture file!");
 		return false;
 	}
 
-	if (frame->version != rsx::FRAME_CAPTURE_VERSION)
+	Init();
+
+	if (replay_count)
 	{
-		LOG_ERROR(LOADER, "Rsx capture file version not supported! Expected %d, found %d", rsx::FRAME_CAPTURE_VERSION, frame->version);
-		return false;
+		// Benchmark runs should not be throttled
+		g_cfg.video.frame_limit.from_default();
+		g_cfg.video.frame_skip_enabled.from_default();
 	}
 
-	Init();
-
 	vm::init();
 
 	// PS3 'executable'
@@ -283,7 +277,7 @@ bool Emulator::BootRsxCapture(const std::string& path)
 	GetCallbacks().on_run();
 	m_state = system_state::running;
 
-	auto&& rsxcapture = idm::make_ptr<ppu_thread, rsx::rsx_replay_thread>(std::move(frame));
+	auto&& rsxcapture = idm::make_ptr<ppu_thread, rsx::rsx_replay_thread>(std::move(frame), std::move(reader), replay_count, report_path);
 	rsxcapture->run();
 
 	return true;
@@ -2,17 +2,37 @@
 #include "IdManager.h"
 #include "VFS.h"
 
-#include <regex>
+#include <list>
+#include <mutex>
+
+struct vfs_directory
+{
+	// Real path (empty path is valid for /host_root)
+	std::string path;
+
+	// Whether this directory is a mount point
+	bool is_mounted = false;
+
+	// Nested mount points (dev_bdvd -> PS3_GAME)
+	std::unordered_map<std::string, vfs_directory> dirs;
+};
 
 struct vfs_manager
 {
 	shared_mutex mutex;
 
-	// Device name -> Real path
-	std::unordered_map<std::string, std::string> mounted;
-};
+	// Mount point tree, the root holds the default directory
+	vfs_directory root;
+
+	// Recently resolved paths (vpath -> real path), cleared on every mount
+	static constexpr std::size_t cache_size = 4096;
 
-const std::regex s_regex_ps3("^/+(.*?)(?:$|/)(.*)", std::regex::optimize);
+	shared_mutex cache_mutex;
+
+	std::list<std::pair<std::string, std::string>> cache_lru;
+
+	std::unordered_map<std::string, decltype(cache_lru)::iterator> cache;
+};
 
 bool vfs::mount(const std::string& dev_name, const std::string& path)
 {
@@ -20,69 +40,145 @@ bool vfs::mount(const std::string& dev_name, const std::string& path)
 
 	safe_writer_lock lock(table->mutex);
 
-	return table->mounted.emplace(dev_name, path).second;
-}
+	vfs_directory* dir = &table->root;
 
-std::string vfs::get(const std::string& vpath, const std::string* prev, std::size_t pos)
-{
-	const auto table = fxm::get_always<vfs_manager>();
+	// Walk or create the nodes for every component of the device name
+	for (std::size_t pos = 0; pos < dev_name.size();)
+	{
+		const std::size_t end = std::min(dev_name.find_first_of('/', pos), dev_name.size());
 
-	safe_reader_lock lock(table->mutex);
+		if (end > pos)
+		{
+			dir = &dir->dirs[dev_name.substr(pos, end - pos)];
+		}
 
-	std::smatch match;
+		pos = end + 1;
+	}
 
-	if (!std::regex_match(vpath.begin() + pos, vpath.end(), match, s_regex_ps3))
+	if (dir->is_mounted)
 	{
-		const auto found = table->mounted.find("");
+		return false;
+	}
+
+	dir->path = path;
+	dir->is_mounted = true;
+
+	std::lock_guard<shared_mutex> cache_lock(table->cache_mutex);
+	table->cache.clear();
+	table->cache_lru.clear();
+	return true;
+}
 
-		if (found == table->mounted.end())
+static std::string vfs_resolve(const vfs_directory& root, const std::string& vpath)
+{
+	if (vpath.empty() || vpath[0] != '/')
+	{
+		// Relative paths go to the default directory
+		if (!root.is_mounted)
 		{
 			LOG_WARNING(GENERAL, "vfs::get(): no default directory: %s", vpath);
 			return {};
 		}
 
-		return found->second + vfs::escape(vpath);
+		return root.path + vfs::escape(vpath);
 	}
 
-	if (match.length(1) + pos == 0)
+	const vfs_directory* dir = &root;
+
+	for (std::size_t pos = 0;;)
 	{
-		return "/";
-	}
+		// Skip separators, repeated slashes are equivalent to a single one
+		while (pos < vpath.size() && vpath[pos] == '/')
+		{
+			pos++;
+		}
 
-	std::string dev;
+		if (pos == vpath.size())
+		{
+			if (dir == &root)
+			{
+				return "/";
+			}
 
-	if (prev)
-	{
-		dev += *prev;
-		dev += '/';
+			break;
+		}
+
+		const std::size_t end = vpath.find_first_of('/', pos);
+		const auto found = dir->dirs.find(vpath.substr(pos, end - pos));
+
+		if (found == dir->dirs.end())
+		{
+			break;
+		}
+
+		if (found->second.is_mounted)
+		{
+			// Path remaining after the mount point (only the first separator is consumed)
+			const std::string rest = end == std::string::npos ? std::string{} : vpath.substr(end + 1);
+
+			if (found->second.path.empty())
+			{
+				// Don't escape /host_root (TODO)
+				return rest;
+			}
+
+			// Escape and concatenate
+			return found->second.path + vfs::escape(rest);
+		}
+
+		if (end == std::string::npos)
+		{
+			break;
+		}
+
+		dir = &found->second;
+		pos = end;
 	}
 
-	dev += match.str(1);
+	LOG_WARNING(GENERAL, "vfs::get(): device not found: %s", vpath);
+	return {};
+}
 
-	const auto found = table->mounted.find(dev);
+std::string vfs::get(const std::string& vpath)
+{
+	const auto table = fxm::get_always<vfs_manager>();
 
-	if (found == table->mounted.end())
 	{
-		if (match.length(2))
+		std::lock_guard<shared_mutex> lock(table->cache_mutex);
+
+		const auto found = table->cache.find(vpath);
+
+		if (found != table->cache.end())
 		{
-			return vfs::get(vpath, &dev, pos + match.position(1) + match.length(1));
+			table->cache_lru.splice(table->cache_lru.begin(), table->cache_lru, found->second);
+			return found->second->second;
 		}
-
-		LOG_WARNING(GENERAL, "vfs::get(): device not found: %s", vpath);
-		return {};
 	}
 
-	if (found->second.empty())
+	safe_reader_lock lock(table->mutex);
+
+	std::string result = vfs_resolve(table->root, vpath);
+
+	if (!result.empty())
 	{
-		// Don't escape /host_root (TODO)
-		return match.str(2);
+		std::lock_guard<shared_mutex> cache_lock(table->cache_mutex);
+
+		if (table->cache.find(vpath) == table->cache.end())
+		{
+			table->cache_lru.emplace_front(vpath, result);
+			table->cache.emplace(vpath, table->cache_lru.begin());
+
+			if (table->cache_lru.size() > vfs_manager::cache_size)
+			{
+				table->cache.erase(table->cache_lru.back().first);
+				table->cache_lru.pop_back();
+			}
+		}
 	}
 
-	// Escape and concatenate
-	return found->second + vfs::escape(match.str(2));
+	return result;
 }
 
-
 std::string vfs::escape(const std::string& path)
 {
 	std::string result;
@@ -7,8 +7,8 @@ namespace vfs
 	// Mount VFS device
 	bool mount(const std::string& dev_name, const std::string& path);
 
-	// Convert VFS path to fs path
-	std::string get(const std::string& vpath, const std::string* = nullptr, std::size_t = 0);
+	// Convert VFS path to fs path (results are cached until the next mount)
+	std::string get(const std::string& vpath);
 
 	// Escape VFS path by replacing non-portable characters with surrogates
 	std::string escape(const std::string& path);
@@ -1,6 +1,11 @@
 #include "stdafx.h"
 
 #include "PUP.h"
+#include "TAR.h"
+#include "Crypto/unself.h"
+#include "Utilities/worker_pool.h"
+
+#include <mutex>
 
 pup_object::pup_object(const fs::file& file): m_file(file)
 {
@@ -18,19 +23,123 @@ pup_object::pup_object(const fs::file& file): m_file(file)
 	m_file.read(m_hash_tbl);
 }
 
-fs::file pup_object::get_file(u64 entry_id)
+fs::file pup_object::get_file(u64 entry_id) const
 {
 	if (!isValid) return fs::file();
 
-	for (PUPFileEntry file_entry : m_file_tbl)
+	for (const PUPFileEntry& file_entry : m_file_tbl)
 	{
 		if (file_entry.entry_id == entry_id)
 		{
-			std::vector<u8> file_buf(file_entry.data_length);
-			m_file.seek(file_entry.data_offset);
-			m_file.read(file_buf, file_entry.data_length);
-			return fs::make_stream(std::move(file_buf));
+			return fs::make_view(m_file, file_entry.data_offset, file_entry.data_length);
 		}
 	}
 	return fs::file();
-};
+}
+
+std::string pup_get_firmware_version(const std::string& path)
+{
+	fs::file pup_f(path);
+
+	if (!pup_f)
+	{
+		return {};
+	}
+
+	pup_object pup(pup_f);
+
+	if (!pup)
+	{
+		return {};
+	}
+
+	std::string version_string = pup.get_file(0x100).to_string();
+	version_string.erase(std::min(version_string.find('\n'), version_string.size()));
+	return version_string;
+}
+
+firmware_install_result pup_install_firmware(const std::string& path, const std::string& dest_dir, const std::function<bool(u32, u32)>& progress)
+{
+	fs::file pup_f(path);
+
+	if (!pup_f)
+	{
+		LOG_ERROR(LOADER, "Firmware: failed to open %s", path);
+		return firmware_install_result::invalid_pup;
+	}
+
+	pup_object pup(pup_f);
+
+	if (!pup)
+	{
+		LOG_ERROR(LOADER, "Firmware: PUP file is invalid: %s", path);
+		return firmware_install_result::invalid_pup;
+	}
+
+	fs::file update_files_f = pup.get_file(0x300);
+	tar_object update_files(update_files_f);
+	auto updatefilenames = update_files.get_filenames();
+
+	updatefilenames.erase(std::remove_if(
+		updatefilenames.begin(), updatefilenames.end(), [](const std::string& s) { return s.find("dev_flash_") == std::string::npos; }),
+		updatefilenames.end());
+
+	const u32 total = ::size32(updatefilenames);
+
+	// Only a few packages are held decrypted in memory at the same time
+	const u32 max_packages_in_flight = 4;
+
+	std::mutex mutex;
+	atomic_t<u32> next{0};
+	u32 done = 0;
+	atomic_t<firmware_install_result> result{firmware_install_result::success};
+
+	auto install_packages = [&](u32)
+	{
+		for (u32 index = next++; index < total && result == firmware_install_result::success; index = next++)
+		{
+			// Views into the PUP file, read concurrently without copying the update package
+			const fs::file updatefile = update_files.get_file(updatefilenames[index]);
+
+			SCEDecrypter self_dec(updatefile);
+			self_dec.LoadHeaders();
+			self_dec.LoadMetadata(SCEPKG_ERK, SCEPKG_RIV);
+			self_dec.DecryptData();
+
+			auto dev_flash_tar_f = self_dec.MakeFile();
+
+			if (dev_flash_tar_f.size() < 3)
+			{
+				LOG_ERROR(LOADER, "Firmware: update package is invalid: %s", updatefilenames[index]);
+				result.compare_and_swap(firmware_install_result::success, firmware_install_result::invalid_contents);
+				return;
+			}
+
+			tar_object dev_flash_tar(dev_flash_tar_f[2]);
+
+			if (!dev_flash_tar.extract(dest_dir))
+			{
+				LOG_ERROR(LOADER, "Firmware: TAR contents are invalid: %s", updatefilenames[index]);
+				result.compare_and_swap(firmware_install_result::success, firmware_install_result::invalid_contents);
+				return;
+			}
+
+			std::lock_guard<std::mutex> lock(mutex);
+			done++;
+
+			if (progress && !progress(done, total))
+			{
+				result.compare_and_swap(firmware_install_result::success, firmware_install_result::cancelled);
+			}
+		}
+	};
+
+	worker_pool::get().parallel_for(std::min(total, max_packages_in_flight), install_packages);
+
+	if (result == firmware_install_result::success)
+	{
+		LOG_SUCCESS(LOADER, "Firmware: installed %u update packages from %s", total, path);
+	}
+
+	return result;
+}
@@ -3,6 +3,7 @@
 #include "../../Utilities/types.h"
 #include "../../Utilities/File.h"
 
+#include <functional>
 #include <vector>
 
 struct PUPHeader
@@ -43,5 +44,22 @@ public:
 
 	explicit operator bool() const { return isValid; };
 
-	fs::file get_file(u64 entry_id);
+	// Get read-only view of the entry data (no copy), the PUP file must outlive it
+	fs::file get_file(u64 entry_id) const;
 };
+
+enum class firmware_install_result : u32
+{
+	success,
+	invalid_pup,      // Not a PUP file
+	invalid_contents, // Update package or TAR contents are invalid
+	cancelled,
+};
+
+// Get firmware version string of a PUP file (empty on failure)
+std::string pup_get_firmware_version(const std::string& path);
+
+// Install dev_flash contents of a PUP file into dest_dir, doesn't depend on the GUI.
+// Update packages are decrypted in parallel and their TAR entries are streamed to disk.
+// progress(done, total) is called after each package (serialized); returning false cancels the installation.
+firmware_install_result pup_install_firmware(const std::string& path, const std::string& dest_dir, const std::function<bool(u32, u32)>& progress = {});
@@ -2,124 +2,168 @@
 
 #include "TAR.h"
 
-#include <cmath>
-#include <cstdlib>
-
-tar_object::tar_object(const fs::file& file, size_t offset)
-	: m_file(file)
-	, initial_offset(offset)
+// Parse numeric header field (octal string, or base-256 if the high bit of the first byte is set)
+template <std::size_t N>
+static u64 tar_parse_number(const char(&field)[N])
 {
-	m_file.seek(initial_offset);
-	largest_offset = initial_offset;
+	if (field[0] & 0x80)
+	{
+		u64 result = field[0] & 0x7f;
+
+		for (std::size_t i = 1; i < N; i++)
+		{
+			result = (result << 8) | static_cast<u8>(field[i]);
+		}
+
+		return result;
+	}
+
+	u64 result = 0;
+
+	for (std::size_t i = 0; i < N; i++)
+	{
+		if (field[i] == ' ' && result == 0)
+		{
+			// Skip leading spaces
+			continue;
+		}
+
+		if (field[i] < '0' || field[i] > '7')
+		{
+			break;
+		}
+
+		result = (result << 3) | (field[i] - '0');
+	}
+
+	return result;
 }
 
-TARHeader tar_object::read_header(u64 offset)
+template <std::size_t N>
+static std::string tar_parse_string(const char(&field)[N])
 {
-	m_file.seek(offset);
-	TARHeader header;
-	m_file.read(header);
-	return header;
+	return std::string(field, std::find(field, field + N, '\0'));
 }
 
-int octalToDecimal(int octalNumber)
+tar_object::tar_object(const fs::file& file, u64 offset)
+	: m_file(file)
 {
-	int decimalNumber = 0, i = 0, rem;
-	while (octalNumber != 0)
+	if (!m_file)
 	{
-		rem = octalNumber % 10;
-		octalNumber /= 10;
-		decimalNumber += rem * pow(8, i);
-		++i;
+		return;
 	}
-	return decimalNumber;
-}
 
-std::vector<std::string> tar_object::get_filenames()
-{
-	std::vector<std::string> vec;
-	get_file("");
-	for (auto it = m_map.cbegin(); it != m_map.cend(); ++it)
+	const u64 file_size = m_file.size();
+
+	// Headers are read at explicit offsets, the position of the file is not used
+	for (u64 pos = offset; pos + sizeof(TARHeader) <= file_size;)
 	{
-		vec.push_back(it->first);
+		TARHeader header;
+
+		if (m_file.read_at(pos, &header, sizeof(header)) != sizeof(header) || header.name[0] == '\0')
+		{
+			// End of archive
+			break;
+		}
+
+		const u64 size = tar_parse_number(header.size);
+		const u64 data = pos + sizeof(TARHeader);
+
+		if (std::string(header.magic, sizeof(header.magic)).find("ustar") != std::string::npos)
+		{
+			std::string name = tar_parse_string(header.name);
+
+			if (header.prefix[0])
+			{
+				name = tar_parse_string(header.prefix) + '/' + name;
+			}
+
+			m_map[std::move(name)] = {data, size, header.filetype};
+		}
+
+		// Entry data is padded to 512 bytes
+		pos = data + ::align(size, 512);
 	}
-	return vec;
 }
 
-fs::file tar_object::get_file(std::string path)
+std::vector<std::string> tar_object::get_filenames() const
 {
-	if (!m_file) return fs::file();
+	std::vector<std::string> vec;
+	vec.reserve(m_map.size());
 
-	auto it = m_map.find(path);
-	if (it != m_map.end())
+	for (const auto& entry : m_map)
 	{
-		TARHeader header = read_header(it->second);
-		int size = octalToDecimal(atoi(header.size));
-		std::vector<u8> buf(size);
-		m_file.read(buf, size);
-		int offset = ((m_file.pos() - initial_offset + 512 - 1) & ~(512 - 1)) + initial_offset; // Always keep the offset aligned to 512 bytes + the initial offset.
-		m_file.seek(offset);
-		return fs::make_stream(std::move(buf));
+		vec.push_back(entry.first);
 	}
-	else //continue scanning from last file entered
-	{
-		while (m_file.pos() < m_file.size())
-		{
-			TARHeader header = read_header(largest_offset);
 
-			if (std::string(header.magic).find("ustar") != std::string::npos)
-				m_map[header.name] = largest_offset;
+	return vec;
+}
 
-			int size = octalToDecimal(atoi(header.size));
-			if (path.compare(header.name) == 0) { //path is equal, read file and advance offset to start of next block
-				std::vector<u8> buf(size);
-				m_file.read(buf, size);
-				int offset = ((m_file.pos() - initial_offset + 512 - 1) & ~(512 - 1)) + initial_offset;
-				m_file.seek(offset);
-				largest_offset = offset;
+fs::file tar_object::get_file(const std::string& path) const
+{
+	const auto found = m_map.find(path);
 
-				return fs::make_stream(std::move(buf));
-			}
-			else { // just advance offset to next block
-				m_file.seek(size, fs::seek_mode::seek_cur);
-				int offset = ((m_file.pos() - initial_offset + 512 - 1) & ~(512 - 1)) + initial_offset;
-				m_file.seek(offset);
-				largest_offset = offset;
-			}
-		}
-		
+	if (found == m_map.end())
+	{
 		return fs::file();
 	}
+
+	return fs::make_view(m_file, found->second.offset, found->second.size);
 }
 
-bool tar_object::extract(std::string path)
+bool tar_object::extract(const std::string& path) const
 {
 	if (!m_file) return false;
 
-	get_file(""); //Make sure we have scanned all files
-	for (auto iter : m_map)
+	// Entries are streamed to disk through a bounded buffer instead of being read whole
+	std::vector<u8> buffer(0x10000);
+
+	for (const auto& entry : m_map)
 	{
-		TARHeader header = read_header(iter.second);
-		if (std::string(header.name).empty()) continue;
+		const std::string& name = entry.first;
+		const auto& info = entry.second;
 
-		switch (header.filetype)
+		switch (info.filetype)
 		{
+		case '\0':
 		case '0':
 		{
-			fs::file file(path + header.name, fs::rewrite);
-			file.write(get_file(header.name).to_vector<u8>());
+			fs::file file(path + name, fs::rewrite);
+
+			if (!file)
+			{
+				LOG_ERROR(GENERAL, "Tar loader: failed to create %s%s", path, name);
+				return false;
+			}
+
+			for (u64 pos = 0; pos < info.size;)
+			{
+				const u64 chunk = std::min<u64>(info.size - pos, buffer.size());
+
+				if (m_file.read_at(info.offset + pos, buffer.data(), chunk) != chunk)
+				{
+					LOG_ERROR(GENERAL, "Tar loader: unexpected end of archive: %s", name);
+					return false;
+				}
+
+				file.write(buffer.data(), chunk);
+				pos += chunk;
+			}
+
 			break;
 		}
-			
+
 		case '5':
 		{
-			fs::create_dir(path + header.name);
+			fs::create_path(path + name);
 			break;
 		}
 
 		default:
-			LOG_ERROR(GENERAL,"Tar loader: unknown file type: %c", header.filetype);
+			LOG_ERROR(GENERAL, "Tar loader: unknown file type: %c", info.filetype);
 			return false;
 		}
 	}
+
 	return true;
 }
@@ -17,22 +17,30 @@ struct TARHeader
 	char padding[12];
 };
 
+CHECK_SIZE(TARHeader, 512);
+
 class tar_object
 {
-	const fs::file& m_file;
+	struct entry
+	{
+		u64 offset; // Offset of the entry data in the base file
+		u64 size;
+		char filetype;
+	};
 
-	int initial_offset;
-	int largest_offset; //we store the largest offset so we can continue to scan from there.
-	std::map<std::string, u64> m_map; //maps path to offset of header of that file, so we only need to scan the entire file once.
+	const fs::file& m_file;
 
-	TARHeader read_header(u64 offset);
+	// Maps path to its entry, built by a single scan of the headers on construction
+	std::map<std::string, entry> m_map;
 
 public:
-	tar_object(const fs::file& file, size_t offset = 0);
+	tar_object(const fs::file& file, u64 offset = 0);
 
-	std::vector<std::string> get_filenames();
+	std::vector<std::string> get_filenames() const;
 
-	fs::file get_file(std::string path);
+	// Get read-only view of the file data (no copy), views only use positional reads on the archive
+	// and can be used concurrently by several threads
+	fs::file get_file(const std::string& path) const;
 
-	bool extract(std::string path); // extract all files in archive to path
+	bool extract(const std::string& path) const; // extract all files in archive to path
 };
@@ -9,6 +9,9 @@
 
 #include "rpcs3_app.h"
 #include "Utilities/sema.h"
+#include "Emu/System.h"
+#include "Loader/PUP.h"
+#include "Emu/RSX/Null/NullGSRender.h"
 #ifdef _WIN32
 #include <windows.h>
 #endif
@@ -69,10 +72,136 @@ static semaphore<> s_qt_mutex{};
 	std::abort();
 }
 
+// Install firmware without creating the GUI, returns process exit code
+static int install_firmware_headless(const std::string& path)
+{
+	Emu.Init();
+
+	const std::string version = pup_get_firmware_version(path);
+
+	if (version.empty())
+	{
+		std::fprintf(stderr, "Invalid firmware file: %s\n", path.c_str());
+		return 1;
+	}
+
+	std::printf("Installing firmware version %s to %s\n", version.c_str(), Emu.GetEmuDir().c_str());
+
+	const auto result = pup_install_firmware(path, Emu.GetEmuDir(), [](u32 done, u32 total)
+	{
+		std::printf("\rInstalled %u/%u update packages", done, total);
+		std::fflush(stdout);
+		return true;
+	});
+
+	std::printf("\n");
+
+	if (result != firmware_install_result::success)
+	{
+		std::fprintf(stderr, "Firmware installation failed: PUP contents are invalid.\n");
+		return 1;
+	}
+
+	std::printf("Firmware installed successfully.\n");
+	return 0;
+}
+
+// Replay an RSX capture on the null renderer without creating the GUI, returns process exit code
+static int replay_rsx_capture_headless(const std::string& path, u32 replay_count, const std::string& report_path)
+{
+	std::mutex queue_mutex;
+	std::deque<std::function<void()>> queue;
+
+	EmuCallbacks callbacks;
+	callbacks.call_after = [&](std::function<void()> func)
+	{
+		std::lock_guard<std::mutex> lock(queue_mutex);
+		queue.emplace_back(std::move(func));
+	};
+	callbacks.process_events = []() {};
+	callbacks.on_run = []() {};
+	callbacks.on_pause = []() {};
+	callbacks.on_resume = []() {};
+	callbacks.on_stop = []() {};
+	callbacks.on_ready = []() {};
+	callbacks.exit = []() {};
+	callbacks.get_gs_frame = []() -> std::unique_ptr<GSFrameBase> { return nullptr; };
+	callbacks.get_gs_render = []() -> std::shared_ptr<GSRender> { return std::make_shared<NullGSRender>(); };
+	Emu.SetCallbacks(std::move(callbacks));
+
+	fs::remove_file(report_path);
+
+	std::printf("Replaying %s %u times\n", path.c_str(), replay_count);
+
+	if (!Emu.BootRsxCapture(path, replay_count, report_path))
+	{
+		std::fprintf(stderr, "Failed to load RSX capture: %s\n", path.c_str());
+		return 1;
+	}
+
+	// The replay thread requests a stop once all passes are done
+	while (!Emu.IsStopped())
+	{
+		std::function<void()> func;
+		{
+			std::lock_guard<std::mutex> lock(queue_mutex);
+
+			if (!queue.empty())
+			{
+				func = std::move(queue.front());
+				queue.pop_front();
+			}
+		}
+
+		if (func)
+			func();
+		else
+			std::this_thread::sleep_for(10ms);
+	}
+
+	if (!fs::is_file(report_path))
+	{
+		std::fprintf(stderr, "Replay failed, no results were written.\n");
+		return 1;
+	}
+
+	std::printf("Results written to %s\n", report_path.c_str());
+	return 0;
+}
+
 int main(int argc, char** argv)
 {
 	logs::set_init();
 
+	// Firmware installation doesn't need the GUI (e.g. for automated setups)
+	for (int i = 1; i + 1 < argc; i++)
+	{
+		if (std::strcmp(argv[i], "--installfw") == 0)
+		{
+			return install_firmware_headless(argv[i + 1]);
+		}
+	}
+
+	// Neither does benchmarking the RSX frontend with a capture
+	std::string replay_path;
+	std::string replay_report;
+	u32 replay_count = 10;
+
+	for (int i = 1; i + 1 < argc; i++)
+	{
+		if (std::strcmp(argv[i], "--rsx-replay") == 0)
+			replay_path = argv[++i];
+		else if (std::strcmp(argv[i], "--replay-count") == 0)
+			replay_count = std::max<u32>(std::strtoul(argv[++i], nullptr, 10), 1);
+		else if (std::strcmp(argv[i], "--replay-report") == 0)
+			replay_report = argv[++i];
+	}
+
+	if (!replay_path.empty())
+	{
+		return replay_rsx_capture_headless(replay_path, replay_count, replay_report.empty() ? replay_path + ".json" : replay_report);
+	}
+
 #ifdef _WIN32
 	// use this instead of SetProcessDPIAware if Qt ever fully supports this on windows
 	// at the moment it can't display QCombobox frames for example
@@ -104,6 +233,10 @@ int main(int argc, char** argv)
 	parser.addPositionalArgument("(S)ELF", "Path for directly executing a (S)ELF");
 	parser.addPositionalArgument("[Args...]", "Optional args for the executable");
 	parser.addHelpOption();
+	parser.addOption(QCommandLineOption("installfw", "Install firmware from a PUP file and exit without starting the GUI.", "path"));
+	parser.addOption(QCommandLineOption("rsx-replay", "Replay an RSX capture on the null renderer and write timings as JSON, without starting the GUI.", "path"));
+	parser.addOption(QCommandLineOption("replay-count", "Number of times --rsx-replay runs the capture (default 10).", "count"));
+	parser.addOption(QCommandLineOption("replay-report", "Output file for --rsx-replay results (default <capture>.json).", "path"));
 	parser.parse(QCoreApplication::arguments());
 
 	app.Init();
@@ -43,7 +43,6 @@
 #include "Crypto/unself.h"
 
 #include "Loader/PUP.h"
-#include "Loader/TAR.h"
 #include "Loader/PSF.h"
 
 #include "Utilities/Thread.h"
@@ -498,26 +497,15 @@ void main_window::InstallPup(const QString& dropPath)
 	guiSettings->SetValue(gui::fd_install_pup, QFileInfo(filePath).path());
 	const std::string path = sstr(filePath);
 
-	fs::file pup_f(path);
-	pup_object pup(pup_f);
-	if (!pup)
+	const std::string version_string = pup_get_firmware_version(path);
+
+	if (version_string.empty())
 	{
 		LOG_ERROR(GENERAL, "Error while installing firmware: PUP file is invalid.");
 		QMessageBox::critical(this, tr("Failure!"), tr("Error while installing firmware: PUP file is invalid."));
 		return;
 	}
 
-	fs::file update_files_f = pup.get_file(0x300);
-	tar_object update_files(update_files_f);
-	auto updatefilenames = update_files.get_filenames();
-
-	updatefilenames.erase(std::remove_if(
-		updatefilenames.begin(), updatefilenames.end(), [](std::string s) { return s.find("dev_flash_") == std::string::npos; }),
-		updatefilenames.end());
-
-	std::string version_string = pup.get_file(0x100).to_string();
-	version_string.erase(version_string.find('\n'));
-
 	const std::string cur_version = "4.82";
 
 	if (version_string < cur_version &&
@@ -527,7 +515,7 @@ void main_window::InstallPup(const QString& dropPath)
 		return;
 	}
 
-	progress_dialog pdlg(0, static_cast<int>(updatefilenames.size()), this);
+	progress_dialog pdlg(0, 1000, this);
 	pdlg.setWindowTitle(tr("RPCS3 Firmware Installer"));
 	pdlg.setLabelText(tr("Installing firmware version %1\nPlease wait...").arg(qstr(version_string)));
 	pdlg.setCancelButtonText(tr("Cancel"));
@@ -535,68 +523,51 @@ void main_window::InstallPup(const QString& dropPath)
 	pdlg.setFixedWidth(QLabel("This is the very length of the progressdialog due to hidpi reasons.").sizeHint().width());
 	pdlg.show();
 
-	// Synchronization variable
-	atomic_t<int> progress(0);
+	// Synchronization variables
+	atomic_t<double> progress(0.);
+	atomic_t<bool> cancelled(false);
+	atomic_t<bool> finished(false);
+	firmware_install_result result = firmware_install_result::success;
 	{
 		// Run asynchronously
 		scope_thread worker("Firmware Installer", [&]
 		{
-			for (const auto& updatefilename : updatefilenames)
+			result = pup_install_firmware(path, Emu.GetEmuDir(), [&](u32 done, u32 total)
 			{
-				if (progress == -1) break;
-
-				fs::file updatefile = update_files.get_file(updatefilename);
-
-				SCEDecrypter self_dec(updatefile);
-				self_dec.LoadHeaders();
-				self_dec.LoadMetadata(SCEPKG_ERK, SCEPKG_RIV);
-				self_dec.DecryptData();
+				progress = static_cast<double>(done) / total;
+				return !cancelled;
+			});
 
-				auto dev_flash_tar_f = self_dec.MakeFile();
-				if (dev_flash_tar_f.size() < 3)
-				{
-					LOG_ERROR(GENERAL, "Error while installing firmware: PUP contents are invalid.");
-					QMessageBox::critical(this, tr("Failure!"), tr("Error while installing firmware: PUP contents are invalid."));
-					progress = -1;
-				}
-
-				tar_object dev_flash_tar(dev_flash_tar_f[2]);
-				if (!dev_flash_tar.extract(Emu.GetEmuDir()))
-				{
-					LOG_ERROR(GENERAL, "Error while installing firmware: TAR contents are invalid.");
-					QMessageBox::critical(this, tr("Failure!"), tr("Error while installing firmware: TAR contents are invalid."));
-					progress = -1;
-				}
-
-				if (progress >= 0)
-					progress += 1;
-			}
+			finished = true;
 		});
 
 		// Wait for the completion
-		while (std::this_thread::sleep_for(5ms), std::abs(progress) < pdlg.maximum())
+		while (std::this_thread::sleep_for(5ms), !finished)
 		{
 			if (pdlg.wasCanceled())
 			{
-				progress = -1;
-				break;
+				cancelled = true;
 			}
+
 			// Update progress window
-			pdlg.SetValue(static_cast<int>(progress));
+			pdlg.SetValue(static_cast<int>(progress * pdlg.maximum()));
 			QCoreApplication::processEvents();
 		}
 
-		update_files_f.close();
-		pup_f.close();
-
-		if (progress > 0)
+		if (result == firmware_install_result::success)
 		{
 			pdlg.SetValue(pdlg.maximum());
 			std::this_thread::sleep_for(100ms);
 		}
 	}
 
-	if (progress > 0)
+	if (result == firmware_install_result::invalid_pup || result == firmware_install_result::invalid_contents)
+	{
+		LOG_ERROR(GENERAL, "Error while installing firmware: PUP contents are invalid.");
+		QMessageBox::critical(this, tr("Failure!"), tr("Error while installing firmware: PUP contents are invalid."));
+	}
+
+	if (result == firmware_install_result::success)
 	{
 		LOG_SUCCESS(GENERAL, "Successfully installed PS3 firmware version %s.", version_string);
 		guiSettings->ShowInfoBox(gui::ib_pup_success, tr("Success!"), tr("Successfully installed PS3 firmware and LLE Modules!"), this);
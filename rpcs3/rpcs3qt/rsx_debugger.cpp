@@ -2,6 +2,10 @@
 #include "rsx_debugger.h"
 #include "qt_utils.h"
 
+#include "Emu/RSX/rsx_utils.h"
+#include "Emu/RSX/Common/TextureDecode.h"
+#include "Emu/RSX/Common/TextureUtils.h"
+
 enum GCMEnumTypes
 {
 	CELL_GCM_ENUM,
@@ -714,32 +718,49 @@ void rsx_debugger::GetBuffers()
 	}
 
 	// Draw Texture
-/*	if(!render->textures[m_cur_texture].enabled())
+	const auto& tex = rsx::method_registers.fragment_textures[m_cur_texture];
+	if (!tex.enabled() || tex.location() > 1)
 		return;
 
-	u32 offset = render->textures[m_cur_texture].offset();
+	const u32 format = tex.format();
+	if (!rsx::is_cpu_decodable_format(format))
+		return;
 
-	if(!offset)
+	const u32 tex_addr = rsx::get_address(tex.offset(), tex.location());
+	const u16 width = tex.width();
+	const u16 height = tex.height();
+	if (!width || !height)
 		return;
 
-	u8 location = render->textures[m_cur_texture].location();
+	const bool is_compressed = tex.is_compressed_format();
+	const u32 block_size = get_format_block_size_in_bytes(format & ~(CELL_GCM_TEXTURE_LN | CELL_GCM_TEXTURE_UN));
+	const u32 pitch = is_compressed ? ((width + 3) / 4) * block_size : (tex.pitch() ? tex.pitch() : width * block_size);
 
-	if(location > 1)
+	if (!vm::check_addr(tex_addr, pitch * (is_compressed ? (height + 3) / 4 : height)))
 		return;
 
-	u32 TexBuffer_addr = rsx::get_address(offset, location);
+	const u8* src = vm::_ptr<const u8>(tex_addr);
 
-	if(!vm::check_addr(TexBuffer_addr))
-		return;
+	// Compressed formats are never swizzled, everything else is linearized before decoding
+	std::vector<u8> linear;
+	if (!is_compressed && !(format & CELL_GCM_TEXTURE_LN))
+	{
+		linear.resize(width * height * block_size);
+		void* swizzled = const_cast<u8*>(src);
 
-	unsigned char* TexBuffer = vm::_ptr<u8>(TexBuffer_addr);
+		switch (block_size)
+		{
+		case 1: rsx::convert_linear_swizzle<u8>(swizzled, linear.data(), width, height, true); break;
+		case 2: rsx::convert_linear_swizzle<u16>(swizzled, linear.data(), width, height, true); break;
+		case 4: rsx::convert_linear_swizzle<u32>(swizzled, linear.data(), width, height, true); break;
+		}
 
-	u32 width  = render->textures[m_cur_texture].width();
-	u32 height = render->textures[m_cur_texture].height();
-	unsigned char* buffer = (unsigned char*)malloc(width * height * 3);
-	std::memcpy(buffer, vm::base(TexBuffer_addr), width * height * 3);
+		src = linear.data();
+	}
 
-	m_buffer_tex->showImage(QImage(buffer, m_text_width, m_text_height, QImage::Format_RGB32));*/
+	QImage image(width, height, QImage::Format_RGBA8888);
+	rsx::decode_texture_to_rgba8(format, src, linear.empty() ? pitch : width * block_size, image.bits(), image.bytesPerLine(), width, height);
+	m_buffer_tex->showImage(image);
 }
 
 void rsx_debugger::GetFlags()